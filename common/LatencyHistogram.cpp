@@ -0,0 +1,82 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+int LatencyHistogram::getBucket(double milliseconds) noexcept
+{
+    const auto microseconds = (uint32_t) std::min(std::max(milliseconds * 1000.0, 0.0), 4294967295.0);
+
+    if (microseconds < 16)
+        return (int) microseconds;
+
+    int exponent = 31;
+
+    while ((microseconds >> exponent) == 0)
+        --exponent;
+
+    const int step = (int) ((microseconds >> (exponent - 3)) & 7);
+    return 16 + (exponent - 4) * 8 + step;
+}
+
+double LatencyHistogram::getBucketMidpointMs(int bucket) noexcept
+{
+    if (bucket < 16)
+        return bucket / 1000.0;
+
+    const int exponent = 4 + (bucket - 16) / 8;
+    const int step = (bucket - 16) % 8;
+    const double lower = (double) ((uint64_t) (8 + step) << (exponent - 3));
+    const double width = (double) ((uint64_t) 1 << (exponent - 3));
+    return (lower + width / 2.0) / 1000.0;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+        snapshot.counts[i] = counts[i].load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+uint64_t LatencyHistogram::Snapshot::getTotal() const noexcept
+{
+    uint64_t total = 0;
+
+    for (auto count : counts)
+        total += count;
+
+    return total;
+}
+
+double LatencyHistogram::Snapshot::getPercentileMs(double fraction) const noexcept
+{
+    const auto total = getTotal();
+
+    if (total == 0)
+        return 0.0;
+
+    const auto rank = (uint64_t) std::ceil(std::min(std::max(fraction, 0.0), 1.0) * (double) total);
+    uint64_t seen = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        seen += counts[(size_t) i];
+
+        if (seen >= std::max((uint64_t) 1, rank))
+            return getBucketMidpointMs(i);
+    }
+
+    return getBucketMidpointMs(numBuckets - 1);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Snapshot::operator-(const Snapshot& earlier) const noexcept
+{
+    Snapshot difference;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+        difference.counts[i] = counts[i] - earlier.counts[i];
+
+    return difference;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free latency histogram. Any thread can record with one relaxed increment; readers
+// take snapshots and subtract an earlier one to get the distribution over a time window.
+// Buckets are exact below 16 µs and split every power of two into 8 steps above, so
+// percentiles are accurate to within 12.5%.
+class LatencyHistogram
+{
+public:
+    static constexpr int numBuckets = 16 + 28 * 8; // up to 2^32 µs
+
+    struct Snapshot
+    {
+        std::array<uint64_t, numBuckets> counts{};
+
+        uint64_t getTotal() const noexcept;
+
+        // Value in milliseconds below which the given fraction (0-1) of samples fall; 0 if empty
+        double getPercentileMs(double fraction) const noexcept;
+
+        Snapshot operator-(const Snapshot& earlier) const noexcept;
+    };
+
+    void record(double milliseconds) noexcept
+    {
+        counts[(size_t) getBucket(milliseconds)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Snapshot getSnapshot() const noexcept;
+
+private:
+    static int getBucket(double milliseconds) noexcept;
+    static double getBucketMidpointMs(int bucket) noexcept;
+
+    std::array<std::atomic<uint64_t>, numBuckets> counts{};
+};
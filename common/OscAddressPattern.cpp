@@ -0,0 +1,232 @@
+#include "OscAddressPattern.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr const char* wildcards = "?*[]{}";
+
+    bool startsWith(std::string_view address, size_t position, const char* prefix, size_t length) noexcept
+    {
+        return address.size() - position >= length && std::memcmp(address.data() + position, prefix, length) == 0;
+    }
+}
+
+bool OscAddressPattern::compile(std::string_view pattern)
+{
+    using Kind = Token::Kind;
+
+    tokens.clear();
+    text.clear();
+    sets.clear();
+    choices.clear();
+
+    const auto fail = [this] {
+        tokens.clear();
+        return false;
+    };
+
+    if (pattern.empty() || pattern[0] != '/')
+        return false;
+
+    for (size_t i = 0; i < pattern.size();)
+    {
+        switch (pattern[i])
+        {
+            case '?':
+                tokens.push_back({ Kind::anyCharacter });
+                ++i;
+                break;
+
+            case '*':
+                // Consecutive stars match the same as one
+                if (tokens.empty() || tokens.back().kind != Kind::anyRun)
+                    tokens.push_back({ Kind::anyRun });
+
+                ++i;
+                break;
+
+            case '[':
+            {
+                const size_t close = pattern.find(']', i + 1);
+
+                if (close == std::string_view::npos)
+                    return fail();
+
+                auto body = pattern.substr(i + 1, close - i - 1);
+                const bool negated = !body.empty() && body[0] == '!';
+
+                if (negated)
+                    body.remove_prefix(1);
+
+                if (body.empty() || body.find_first_of("/[{}") != std::string_view::npos)
+                    return fail();
+
+                CharacterSet set {};
+                const auto add = [&set](unsigned c) { set[c >> 6] |= 1ull << (c & 63); };
+
+                for (size_t j = 0; j < body.size(); ++j)
+                {
+                    // a-z is a range; a '-' at either end stands for itself
+                    if (j + 2 < body.size() && body[j + 1] == '-')
+                    {
+                        for (unsigned c = (uint8_t) body[j]; c <= (uint8_t) body[j + 2]; ++c)
+                            add(c);
+
+                        j += 2;
+                    }
+                    else
+                    {
+                        add((uint8_t) body[j]);
+                    }
+                }
+
+                if (negated)
+                    for (auto& word : set)
+                        word = ~word;
+
+                set['/' >> 6] &= ~(1ull << ('/' & 63));
+
+                tokens.push_back({ Kind::characterSet, (uint32_t) sets.size() });
+                sets.push_back(set);
+                i = close + 1;
+                break;
+            }
+
+            case '{':
+            {
+                const size_t close = pattern.find('}', i + 1);
+
+                if (close == std::string_view::npos)
+                    return fail();
+
+                const auto body = pattern.substr(i + 1, close - i - 1);
+
+                if (body.find_first_of("/[]{") != std::string_view::npos)
+                    return fail();
+
+                const auto first = (uint32_t) choices.size();
+
+                for (size_t start = 0;;)
+                {
+                    const size_t comma = body.find(',', start);
+                    const auto choice = body.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start);
+
+                    choices.push_back({ (uint32_t) text.size(), (uint32_t) (text.size() + choice.size()) });
+                    text.append(choice);
+
+                    if (comma == std::string_view::npos)
+                        break;
+
+                    start = comma + 1;
+                }
+
+                tokens.push_back({ Kind::alternatives, first, (uint32_t) choices.size() });
+                i = close + 1;
+                break;
+            }
+
+            case ']':
+            case '}':
+                return fail();
+
+            default:
+            {
+                // A run of ordinary characters, slashes included, is one literal
+                const auto literal = pattern.substr(i, pattern.find_first_of(wildcards, i) - i);
+
+                tokens.push_back({ Kind::literal, (uint32_t) text.size(), (uint32_t) (text.size() + literal.size()) });
+                text.append(literal);
+                i += literal.size();
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool OscAddressPattern::matches(std::string_view address) const noexcept
+{
+    return !tokens.empty() && matchFrom(0, address, 0);
+}
+
+bool OscAddressPattern::containsWildcards(std::string_view address) noexcept
+{
+    return address.find_first_of(wildcards) != std::string_view::npos;
+}
+
+bool OscAddressPattern::matchFrom(size_t tokenIndex, std::string_view address, size_t position) const noexcept
+{
+    using Kind = Token::Kind;
+
+    for (; tokenIndex < tokens.size(); ++tokenIndex)
+    {
+        const auto& token = tokens[tokenIndex];
+
+        switch (token.kind)
+        {
+            case Kind::literal:
+            {
+                const size_t length = token.end - token.begin;
+
+                if (!startsWith(address, position, text.data() + token.begin, length))
+                    return false;
+
+                position += length;
+                break;
+            }
+
+            case Kind::anyCharacter:
+                if (position == address.size() || address[position] == '/')
+                    return false;
+
+                ++position;
+                break;
+
+            case Kind::characterSet:
+            {
+                if (position == address.size())
+                    return false;
+
+                const auto c = (uint8_t) address[position];
+
+                if (((sets[token.begin][c >> 6] >> (c & 63)) & 1) == 0)
+                    return false;
+
+                ++position;
+                break;
+            }
+
+            case Kind::alternatives:
+                for (uint32_t i = token.begin; i < token.end; ++i)
+                {
+                    const auto& choice = choices[i];
+                    const size_t length = choice.second - choice.first;
+
+                    if (startsWith(address, position, text.data() + choice.first, length)
+                        && matchFrom(tokenIndex + 1, address, position + length))
+                        return true;
+                }
+
+                return false;
+
+            case Kind::anyRun:
+            {
+                // Any length up to the end of this address part, shortest first
+                const size_t partEnd = std::min(address.find('/', position), address.size());
+
+                if (tokenIndex + 1 == tokens.size())
+                    return partEnd == address.size();
+
+                for (size_t end = position; end <= partEnd; ++end)
+                    if (matchFrom(tokenIndex + 1, address, end))
+                        return true;
+
+                return false;
+            }
+        }
+    }
+
+    return position == address.size();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// An OSC address pattern compiled once into a list of tokens, so matching an incoming
+// address works on the raw bytes of the packet without building strings or throwing.
+// Supports the OSC 1.0 wildcards: ? (one character), * (any run of characters), [abc],
+// [a-z] and [!abc] (one character from a set, or not from it) and {foo,bar} (one of several
+// strings). None of them ever match the '/' between address parts.
+//
+//     OscAddressPattern pattern;
+//     pattern.compile("/mixer/channel/*/fader");
+//     pattern.matches(message.getAddress()); // true for "/mixer/channel/12/fader"
+class OscAddressPattern
+{
+public:
+    OscAddressPattern() = default;
+
+    // Returns false, leaving a pattern that matches nothing, if pattern is not a valid OSC
+    // address pattern: it must start with '/' and brackets and braces must be closed and
+    // not nested or contain '/'
+    bool compile(std::string_view pattern);
+    bool isValid() const noexcept { return !tokens.empty(); }
+
+    bool matches(std::string_view address) const noexcept;
+
+    // True if address contains any wildcard character, i.e. needs matching as a pattern
+    static bool containsWildcards(std::string_view address) noexcept;
+
+private:
+    struct Token
+    {
+        enum class Kind : uint8_t { literal, anyCharacter, anyRun, characterSet, alternatives };
+
+        Kind kind;
+        uint32_t begin = 0, end = 0; // literal: range in text; characterSet: index in sets;
+                                     // alternatives: range in choices
+    };
+
+    using CharacterSet = std::array<uint64_t, 4>; // bit c set if character c is in the set
+
+    bool matchFrom(size_t tokenIndex, std::string_view address, size_t position) const noexcept;
+
+    std::vector<Token> tokens;
+    std::string text;
+    std::vector<CharacterSet> sets;
+    std::vector<std::pair<uint32_t, uint32_t>> choices; // ranges in text
+};
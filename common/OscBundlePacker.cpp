@@ -0,0 +1,63 @@
+#include "OscBundlePacker.h"
+
+OscBundlePacker::OscBundlePacker(size_t maxPacketSizeToUse, Sink sinkToUse)
+    : maxPacketSize(maxPacketSizeToUse),
+      sink(std::move(sinkToUse))
+{
+    writer.reserve(maxPacketSize);
+}
+
+OscPacketWriter& OscBundlePacker::beginMessage(std::string_view address, std::string_view typeTags,
+                                               size_t argumentBytes, uint64_t timeTag)
+{
+    const bool nested = timeTag != OscPacketWriter::immediately;
+
+    // Size prefix plus message, plus "#bundle", time tag and inner size prefix when nested
+    const size_t elementSize = 4 + OscPacketWriter::getMessageSize(address, typeTags, argumentBytes) + (nested ? 20 : 0);
+
+    if (bundleOpen && writer.size() + elementSize > maxPacketSize)
+        flush();
+
+    if (!bundleOpen)
+    {
+        writer.clear();
+        writer.beginBundle(timeTag);
+        commonPrefix.assign(address.data(), address.size());
+        bundleOpen = true;
+    }
+    else
+    {
+        size_t length = 0;
+
+        while (length < commonPrefix.size() && length < address.size() && commonPrefix[length] == address[length])
+            ++length;
+
+        commonPrefix.resize(length);
+    }
+
+    if (nested)
+        writer.beginBundle(timeTag);
+
+    messageInNestedBundle = nested;
+    writer.beginMessage(address, typeTags);
+    return writer;
+}
+
+void OscBundlePacker::endMessage()
+{
+    writer.endMessage();
+
+    if (messageInNestedBundle)
+        writer.endBundle();
+}
+
+void OscBundlePacker::flush()
+{
+    if (!bundleOpen)
+        return;
+
+    writer.endBundle();
+    bundleOpen = false;
+    ++numPacketsSent;
+    sink(commonPrefix, writer.data(), writer.size());
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "OscPacketWriter.h"
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Packs a stream of messages into as few bundles as possible, none larger than
+// maxPacketSize (unless a single message is). Each finished bundle is handed to the sink
+// together with the longest address prefix shared by all of its messages, which callers
+// can use to route it:
+//
+//     OscBundlePacker packer(1472, [&](std::string_view prefix, const char* data, size_t size) { ... });
+//     packer.beginMessage("/mixer/1/gain", "f", 4).addFloat32(0.8f);
+//     packer.endMessage();
+//     packer.flush();
+//
+// A message given a time tag other than "immediately" is wrapped in its own nested bundle
+// carrying that tag. Time tags must not decrease within a stream, since an enclosing
+// bundle's tag has to be no later than those of its elements.
+class OscBundlePacker
+{
+public:
+    using Sink = std::function<void(std::string_view commonAddressPrefix, const char* data, size_t size)>;
+
+    OscBundlePacker(size_t maxPacketSizeToUse, Sink sinkToUse);
+
+    // argumentBytes is the encoded size of the arguments that will be added to the writer
+    OscPacketWriter& beginMessage(std::string_view address, std::string_view typeTags, size_t argumentBytes,
+                                  uint64_t timeTag = OscPacketWriter::immediately);
+    void endMessage();
+
+    // Sends the bundle being filled, if any
+    void flush();
+
+    size_t getNumPacketsSent() const noexcept { return numPacketsSent; }
+
+private:
+    const size_t maxPacketSize;
+    Sink sink;
+    OscPacketWriter writer;
+    std::string commonPrefix;
+    bool bundleOpen = false;
+    bool messageInNestedBundle = false;
+    size_t numPacketsSent = 0;
+};
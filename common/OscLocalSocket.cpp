@@ -0,0 +1,249 @@
+#include "OscLocalSocket.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+ #include <cerrno>
+ #include <cstring>
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <sys/socket.h>
+ #include <sys/stat.h>
+ #include <sys/time.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+ #define OSC_LOCAL_SOCKETS 1
+#endif
+
+OscLocalSocket::~OscLocalSocket()
+{
+    close();
+}
+
+OscLocalSocket::OscLocalSocket(OscLocalSocket&& other) noexcept
+    : handle(other.handle), type(other.type), boundPath(std::move(other.boundPath))
+{
+    other.handle = -1;
+    other.boundPath.clear();
+}
+
+OscLocalSocket& OscLocalSocket::operator=(OscLocalSocket&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        handle = other.handle;
+        type = other.type;
+        boundPath = std::move(other.boundPath);
+        other.handle = -1;
+        other.boundPath.clear();
+    }
+
+    return *this;
+}
+
+#if OSC_LOCAL_SOCKETS
+
+static bool makeAddress(const std::string& path, sockaddr_un& address) noexcept
+{
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+        return false;
+
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+bool OscLocalSocket::isSupported() noexcept
+{
+    return true;
+}
+
+size_t OscLocalSocket::getMaxPathLength() noexcept
+{
+    return sizeof(sockaddr_un::sun_path) - 1;
+}
+
+bool OscLocalSocket::open(Type typeToUse)
+{
+    close();
+    type = typeToUse;
+    handle = ::socket(AF_UNIX, type == Type::stream ? SOCK_STREAM : SOCK_DGRAM, 0);
+
+    if (handle < 0)
+        return false;
+
+    ::fcntl(handle, F_SETFD, FD_CLOEXEC);
+
+   #ifdef SO_NOSIGPIPE
+    const int one = 1;
+    ::setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+   #endif
+
+    return true;
+}
+
+bool OscLocalSocket::bind(const std::string& path, Type typeToUse)
+{
+    sockaddr_un address;
+
+    if (!makeAddress(path, address) || !open(typeToUse))
+        return false;
+
+    // A socket file outlives the process that bound it; only remove sockets, never other files
+    struct stat info;
+
+    if (::lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+        ::unlink(path.c_str());
+
+    if (::bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || (type == Type::stream && ::listen(handle, SOMAXCONN) != 0))
+    {
+        close();
+        return false;
+    }
+
+    boundPath = path;
+    return true;
+}
+
+OscLocalSocket OscLocalSocket::accept(int timeoutMs)
+{
+    OscLocalSocket connection;
+
+    if (handle < 0 || type != Type::stream)
+        return connection;
+
+    pollfd request { handle, POLLIN, 0 };
+
+    if (::poll(&request, 1, timeoutMs) <= 0)
+        return connection;
+
+    connection.handle = ::accept(handle, nullptr, nullptr);
+    connection.type = Type::stream;
+
+    if (connection.handle >= 0)
+        ::fcntl(connection.handle, F_SETFD, FD_CLOEXEC);
+
+    return connection;
+}
+
+bool OscLocalSocket::connect(const std::string& path, Type typeToUse)
+{
+    sockaddr_un address;
+
+    if (!makeAddress(path, address) || !open(typeToUse))
+        return false;
+
+    if (::connect(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close();
+        return false;
+    }
+
+    if (type == Type::stream)
+    {
+        const timeval timeout { 0, sendTimeoutMs * 1000 };
+        ::setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+
+    return true;
+}
+
+bool OscLocalSocket::send(const char* data, size_t size)
+{
+    if (handle < 0)
+        return false;
+
+    // Datagrams never wait for a full receive queue; like UDP they are dropped instead
+    int flags = type == Type::datagram ? MSG_DONTWAIT : 0;
+
+   #ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+   #endif
+
+    size_t offset = 0;
+
+    while (offset < size)
+    {
+        const ssize_t sent = ::send(handle, data + offset, size - offset, flags);
+
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if (type == Type::stream || errno == ECONNREFUSED || errno == ENOTCONN)
+                close();
+
+            return false;
+        }
+
+        // A datagram is sent whole or not at all
+        if (type == Type::datagram)
+            return (size_t) sent == size;
+
+        offset += (size_t) sent;
+    }
+
+    return true;
+}
+
+int OscLocalSocket::read(char* buffer, size_t size, int timeoutMs)
+{
+    if (handle < 0)
+        return -1;
+
+    pollfd request { handle, POLLIN, 0 };
+    const int ready = ::poll(&request, 1, timeoutMs);
+
+    if (ready == 0 || (ready < 0 && errno == EINTR))
+        return 0;
+
+    if (ready < 0)
+        return -1;
+
+    const ssize_t bytesRead = ::recv(handle, buffer, size, 0);
+
+    if (bytesRead < 0)
+        return errno == EINTR || errno == EAGAIN ? 0 : -1;
+
+    // 0 is a closed stream, or a datagram socket that was shut down
+    if (bytesRead == 0)
+        return type == Type::datagram && (request.revents & POLLHUP) == 0 ? 0 : -1;
+
+    return (int) bytesRead;
+}
+
+void OscLocalSocket::shutdown() noexcept
+{
+    if (handle >= 0)
+        ::shutdown(handle, SHUT_RDWR);
+}
+
+void OscLocalSocket::close() noexcept
+{
+    if (handle >= 0)
+        ::close(handle);
+
+    handle = -1;
+
+    if (!boundPath.empty())
+        ::unlink(boundPath.c_str());
+
+    boundPath.clear();
+}
+
+#else
+
+bool OscLocalSocket::isSupported() noexcept { return false; }
+size_t OscLocalSocket::getMaxPathLength() noexcept { return 0; }
+bool OscLocalSocket::open(Type) { return false; }
+bool OscLocalSocket::bind(const std::string&, Type) { return false; }
+OscLocalSocket OscLocalSocket::accept(int) { return {}; }
+bool OscLocalSocket::connect(const std::string&, Type) { return false; }
+bool OscLocalSocket::send(const char*, size_t) { return false; }
+int OscLocalSocket::read(char*, size_t, int) { return -1; }
+void OscLocalSocket::shutdown() noexcept {}
+void OscLocalSocket::close() noexcept {}
+
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// An AF_UNIX socket for OSC between processes on the same machine. Packets skip the UDP/IP
+// stack entirely: no checksums, no routing, no loopback device. Datagram sockets carry one
+// OSC packet per datagram, exactly like UDP; stream sockets carry packets framed with
+// OscStreamFraming.
+//
+// Available on Linux and macOS; on other platforms every call fails.
+class OscLocalSocket
+{
+public:
+    enum class Type
+    {
+        datagram,
+        stream
+    };
+
+    OscLocalSocket() = default;
+    ~OscLocalSocket();
+
+    OscLocalSocket(OscLocalSocket&& other) noexcept;
+    OscLocalSocket& operator=(OscLocalSocket&& other) noexcept;
+    OscLocalSocket(const OscLocalSocket&) = delete;
+    OscLocalSocket& operator=(const OscLocalSocket&) = delete;
+
+    static bool isSupported() noexcept;
+
+    // Binds to path, replacing a stale socket file left by a previous run. Stream sockets
+    // also start listening. The file is removed again by close().
+    bool bind(const std::string& path, Type type);
+
+    // Stream sockets bound with bind(): waits up to timeoutMs for a client and returns its
+    // connection, or a closed socket on timeout or error
+    OscLocalSocket accept(int timeoutMs);
+
+    // Connects to a socket bound at path
+    bool connect(const std::string& path, Type type);
+
+    // Connected sockets: sends one datagram, or writes all of data to a stream. Datagrams are
+    // dropped when the receiver's queue is full; stream writes wait up to sendTimeoutMs.
+    // The socket is closed if the receiver has gone, or if a stream write fails (after a
+    // partial write the peer could no longer find the packet boundaries); connect() again
+    // to carry on.
+    bool send(const char* data, size_t size);
+
+    // Waits up to timeoutMs for data. Returns the number of bytes read, 0 on timeout and -1
+    // if the socket was shut down, closed by the peer or failed.
+    int read(char* buffer, size_t size, int timeoutMs);
+
+    // Wakes a thread blocked in read()
+    void shutdown() noexcept;
+    void close() noexcept;
+
+    bool isOpen() const noexcept { return handle >= 0; }
+    int getHandle() const noexcept { return handle; }
+    Type getType() const noexcept { return type; }
+
+    // Longest path that fits in sockaddr_un, excluding the terminator
+    static size_t getMaxPathLength() noexcept;
+
+    static constexpr int sendTimeoutMs = 200;
+
+private:
+    bool open(Type typeToUse);
+
+    int handle = -1;
+    Type type = Type::datagram;
+    std::string boundPath;
+};
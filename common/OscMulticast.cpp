@@ -0,0 +1,92 @@
+#include "OscMulticast.h"
+
+#include <cstdio>
+
+#if defined(__linux__) || defined(__APPLE__)
+ #include <arpa/inet.h>
+ #include <ifaddrs.h>
+ #include <netinet/in.h>
+ #include <sys/socket.h>
+ #define OSC_MULTICAST 1
+#endif
+
+bool OscMulticast::isGroupAddress(const std::string& address) noexcept
+{
+    unsigned int octets[4];
+    char trailing;
+
+    if (std::sscanf(address.c_str(), "%u.%u.%u.%u%c", &octets[0], &octets[1], &octets[2], &octets[3], &trailing) != 4)
+        return false;
+
+    return octets[0] >= 224 && octets[0] <= 239 && octets[1] <= 255 && octets[2] <= 255 && octets[3] <= 255;
+}
+
+#if OSC_MULTICAST
+
+// An address is used as is; a name is looked up among the interfaces' IPv4 addresses
+static bool resolveInterface(const std::string& interfaceName, in_addr& result)
+{
+    if (interfaceName.empty())
+    {
+        result.s_addr = htonl(INADDR_ANY);
+        return true;
+    }
+
+    if (inet_pton(AF_INET, interfaceName.c_str(), &result) == 1)
+        return true;
+
+    ifaddrs* interfaces = nullptr;
+
+    if (getifaddrs(&interfaces) != 0)
+        return false;
+
+    bool found = false;
+
+    for (auto* entry = interfaces; entry != nullptr && !found; entry = entry->ifa_next)
+    {
+        if (entry->ifa_addr != nullptr && entry->ifa_addr->sa_family == AF_INET && interfaceName == entry->ifa_name)
+        {
+            result = reinterpret_cast<const sockaddr_in*>(entry->ifa_addr)->sin_addr;
+            found = true;
+        }
+    }
+
+    freeifaddrs(interfaces);
+    return found;
+}
+
+bool OscMulticast::joinGroup(int socket, const std::string& group, const std::string& interfaceName)
+{
+    ip_mreq request{};
+
+    if (!isGroupAddress(group)
+        || inet_pton(AF_INET, group.c_str(), &request.imr_multiaddr) != 1
+        || !resolveInterface(interfaceName, request.imr_interface))
+        return false;
+
+    return setsockopt(socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, sizeof(request)) == 0;
+}
+
+bool OscMulticast::setSendOptions(int socket, int timeToLive, const std::string& interfaceName, bool loopback)
+{
+    in_addr interfaceAddress{};
+
+    if (timeToLive < 0 || timeToLive > 255 || !resolveInterface(interfaceName, interfaceAddress))
+        return false;
+
+    // IP_MULTICAST_TTL and IP_MULTICAST_LOOP take an unsigned char on macOS; Linux accepts both
+    const unsigned char ttl = (unsigned char) timeToLive;
+    const unsigned char loop = loopback ? 1 : 0;
+
+    return setsockopt(socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) == 0
+        && setsockopt(socket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0
+        && (interfaceName.empty()
+            || setsockopt(socket, IPPROTO_IP, IP_MULTICAST_IF, &interfaceAddress, sizeof(interfaceAddress)) == 0);
+}
+
+#else
+
+bool OscMulticast::joinGroup(int, const std::string&, const std::string&) { return false; }
+bool OscMulticast::setSendOptions(int, int, const std::string&, bool) { return false; }
+
+#endif
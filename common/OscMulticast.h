@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+// IPv4 multicast options for UDP sockets created elsewhere, e.g. a juce::DatagramSocket's
+// raw handle. One datagram sent to a group reaches every socket that joined it, so a cue
+// for many receivers costs a single send instead of one per receiver.
+//
+// Interfaces are given as an IPv4 address ("192.168.1.10") or an interface name ("eth0");
+// an empty string leaves the choice to the routing table. Use "127.0.0.1" or "lo" to keep
+// traffic on this machine.
+//
+// Available on Linux and macOS; on other platforms the socket functions fail.
+namespace OscMulticast
+{
+    // True for addresses in 224.0.0.0/4
+    bool isGroupAddress(const std::string& address) noexcept;
+
+    // Subscribes socket to group on the given interface. Several sockets on one machine can
+    // only bind the same port if each enables address reuse before binding.
+    bool joinGroup(int socket, const std::string& group, const std::string& interfaceName = {});
+
+    // Sets how many router hops multicast datagrams sent from socket may cross (1 keeps
+    // them on the local network), which interface they leave through, and whether
+    // subscribers on this machine receive them too
+    bool setSendOptions(int socket, int timeToLive, const std::string& interfaceName = {}, bool loopback = true);
+}
@@ -0,0 +1,269 @@
+#include "OscPacketReader.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+uint32_t OscArgument::readBigEndian32(const char* bytes) noexcept
+{
+    const auto* b = reinterpret_cast<const uint8_t*>(bytes);
+    return ((uint32_t) b[0] << 24) | ((uint32_t) b[1] << 16) | ((uint32_t) b[2] << 8) | (uint32_t) b[3];
+}
+
+uint64_t OscArgument::readBigEndian64(const char* bytes) noexcept
+{
+    return ((uint64_t) readBigEndian32(bytes) << 32) | readBigEndian32(bytes + 4);
+}
+
+float OscArgument::getFloat32() const noexcept
+{
+    const uint32_t bits = readBigEndian32(data);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double OscArgument::getFloat64() const noexcept
+{
+    const uint64_t bits = readBigEndian64(data);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+OscMidiMessage OscArgument::getMidi() const noexcept
+{
+    const auto* b = reinterpret_cast<const uint8_t*>(data);
+    return { b[0], b[1], b[2], b[3] };
+}
+
+bool OscArgument::isNumeric() const noexcept
+{
+    switch (type)
+    {
+        case 'i': case 'h': case 'f': case 'd': case 'T': case 'F': case 'I':
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool OscArgument::toFloat64(double& value) const noexcept
+{
+    switch (type)
+    {
+        case 'i': value = (double) getInt32(); return true;
+        case 'h': value = (double) getInt64(); return true;
+        case 'f': value = (double) getFloat32(); return true;
+        case 'd': value = getFloat64(); return true;
+        case 'T': value = 1.0; return true;
+        case 'F': value = 0.0; return true;
+        case 'I': value = std::numeric_limits<double>::infinity(); return true;
+        default:  return false;
+    }
+}
+
+bool OscArgument::toFloat32(float& value) const noexcept
+{
+    // Single precision directly where possible, so a float32 argument is never widened and
+    // narrowed again
+    if (type == 'f')
+    {
+        value = getFloat32();
+        return true;
+    }
+
+    double wide;
+
+    if (!toFloat64(wide))
+        return false;
+
+    value = (float) wide;
+    return true;
+}
+
+bool OscArgument::toInt64(int64_t& value) const noexcept
+{
+    switch (type)
+    {
+        case 'i': value = getInt32(); return true;
+        case 'h': value = getInt64(); return true;
+        case 'T': value = 1; return true;
+        case 'F': value = 0; return true;
+        case 'I': value = std::numeric_limits<int64_t>::max(); return true;
+        default:  break;
+    }
+
+    double wide;
+
+    if (!toFloat64(wide) || std::isnan(wide))
+        return false;
+
+    // 2^63 is exactly representable; anything at or beyond it saturates
+    constexpr double limit = 9223372036854775808.0;
+    value = wide >= limit ? std::numeric_limits<int64_t>::max()
+          : wide < -limit ? std::numeric_limits<int64_t>::min()
+          : (int64_t) std::llround(wide);
+    return true;
+}
+
+bool OscArgument::toInt32(int32_t& value) const noexcept
+{
+    int64_t wide;
+
+    if (!toInt64(wide))
+        return false;
+
+    value = wide > std::numeric_limits<int32_t>::max() ? std::numeric_limits<int32_t>::max()
+          : wide < std::numeric_limits<int32_t>::min() ? std::numeric_limits<int32_t>::min()
+          : (int32_t) wide;
+    return true;
+}
+
+bool OscArgument::toBool(bool& value) const noexcept
+{
+    double wide;
+
+    if (!toFloat64(wide))
+        return false;
+
+    value = wide != 0.0;
+    return true;
+}
+
+//==============================================================================
+bool OscMessageView::isKnownType(char type) noexcept
+{
+    switch (type)
+    {
+        case 'i': case 'f': case 'c': case 'r': case 'm':
+        case 'h': case 'd': case 't':
+        case 's': case 'S': case 'b':
+        case 'T': case 'F': case 'N': case 'I': case '[': case ']':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Length of the padded, null-terminated string at data, or 0 if it is not terminated in time
+static size_t getPaddedStringSize(const char* data, size_t available) noexcept
+{
+    const void* terminator = std::memchr(data, 0, available);
+
+    if (terminator == nullptr)
+        return 0;
+
+    const size_t padded = ((size_t) (static_cast<const char*>(terminator) - data) + 4) & ~(size_t) 3;
+    return padded <= available ? padded : 0;
+}
+
+size_t OscMessageView::getArgumentSize(char type, const char* data, size_t available) noexcept
+{
+    size_t size = 0;
+
+    switch (type)
+    {
+        case 'i': case 'f': case 'c': case 'r': case 'm':
+            size = 4;
+            break;
+
+        case 'h': case 'd': case 't':
+            size = 8;
+            break;
+
+        case 's': case 'S':
+            return getPaddedStringSize(data, available);
+
+        case 'b':
+            if (available < 4)
+                return 0;
+
+            size = 4 + (((size_t) OscArgument::readBigEndian32(data) + 3) & ~(size_t) 3);
+            break;
+
+        default:
+            return 0;
+    }
+
+    return size <= available ? size : 0;
+}
+
+bool OscMessageView::parse(const char* data, size_t size, OscMessageView& result) noexcept
+{
+    if (size < 4 || (size & 3) != 0 || data[0] != '/')
+        return false;
+
+    const size_t addressSize = getPaddedStringSize(data, size);
+
+    if (addressSize == 0)
+        return false;
+
+    OscMessageView message;
+    message.address = std::string_view(data);
+
+    // OSC 1.0 allows a message without a type tag string; treat it as having no arguments
+    const char* position = data + addressSize;
+    const char* const end = data + size;
+
+    if (position < end)
+    {
+        if (*position != ',')
+            return false;
+
+        const size_t tagsSize = getPaddedStringSize(position, (size_t) (end - position));
+
+        if (tagsSize == 0)
+            return false;
+
+        message.typeTags = std::string_view(position + 1);
+        position += tagsSize;
+    }
+
+    message.arguments = position;
+    message.packetEnd = end;
+
+    for (const char type : message.typeTags)
+    {
+        if (!isKnownType(type))
+            return false;
+
+        const size_t argumentSize = getArgumentSize(type, position, (size_t) (end - position));
+
+        if (argumentSize == 0 && !(type == 'T' || type == 'F' || type == 'N' || type == 'I' || type == '[' || type == ']'))
+            return false;
+
+        position += argumentSize;
+    }
+
+    result = message;
+    return true;
+}
+
+OscArgument OscMessageView::operator[](int index) const noexcept
+{
+    auto it = begin();
+
+    for (int i = 0; i < index && it != end(); ++i)
+        ++it;
+
+    return it != end() ? *it : OscArgument();
+}
+
+OscArgument OscMessageView::Iterator::operator*() const noexcept
+{
+    // parse() has already checked that every argument fits; types without data have size 0
+    return { *typeTag, data, getArgumentSize(*typeTag, data, (size_t) (end - data)) };
+}
+
+OscMessageView::Iterator& OscMessageView::Iterator::operator++() noexcept
+{
+    data += getArgumentSize(*typeTag, data, (size_t) (end - data));
+    ++typeTag;
+    return *this;
+}
+
+//==============================================================================
+bool OscPacketReader::isBundle(const char* data, size_t size) noexcept
+{
+    return size >= 16 && std::memcmp(data, "#bundle", 8) == 0;
+}
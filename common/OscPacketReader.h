@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Read-only bytes inside a packet; what std::span<const uint8_t> would be in C++20
+struct OscByteSpan
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    const uint8_t* begin() const noexcept { return data; }
+    const uint8_t* end() const noexcept { return data + size; }
+    bool empty() const noexcept { return size == 0; }
+};
+
+// 'm' argument: MIDI port id, status byte and two data bytes
+struct OscMidiMessage
+{
+    uint8_t port = 0, status = 0, data1 = 0, data2 = 0;
+};
+
+// One argument of a received message, pointing into the packet it came from. Covers every
+// OSC 1.0 and 1.1 type plus the common extensions:
+//
+//   i int32   h int64   f float32   d float64   t time tag   s string   S symbol   b blob
+//   c char    r RGBA    m MIDI      T true      F false      N nil      I infinitum
+//
+// Values are read byte by byte from big-endian packet memory, so arguments need no
+// particular alignment. The get*() accessors expect the matching type; the to*() ones
+// convert from any numeric type (int32, int64, float32, float64, true/false, infinitum)
+// and return false for everything else.
+class OscArgument
+{
+public:
+    OscArgument() = default;
+    OscArgument(char typeToUse, const char* dataToUse, size_t sizeToUse) noexcept
+        : type(typeToUse), data(dataToUse), size(sizeToUse) {}
+
+    char getType() const noexcept { return type; }
+    size_t getSize() const noexcept { return size; } // encoded bytes, including blob size and padding
+
+    bool isNumeric() const noexcept;
+    bool isString() const noexcept { return type == 's' || type == 'S'; }
+    bool isBlob() const noexcept { return type == 'b'; }
+
+    int32_t getInt32() const noexcept { return (int32_t) readBigEndian32(data); }
+    int64_t getInt64() const noexcept { return (int64_t) readBigEndian64(data); }
+    float getFloat32() const noexcept;
+    double getFloat64() const noexcept;
+    uint64_t getTimeTag() const noexcept { return readBigEndian64(data); }
+    uint32_t getCharacter() const noexcept { return readBigEndian32(data); }
+    uint32_t getColour() const noexcept { return readBigEndian32(data); } // 0xRRGGBBAA
+    OscMidiMessage getMidi() const noexcept;
+    std::string_view getString() const noexcept { return std::string_view(data); }
+    OscByteSpan getBlob() const noexcept { return { reinterpret_cast<const uint8_t*>(data) + 4, readBigEndian32(data) }; }
+
+    bool toInt32(int32_t& value) const noexcept;   // saturates; floats are rounded to nearest
+    bool toInt64(int64_t& value) const noexcept;
+    bool toFloat32(float& value) const noexcept;
+    bool toFloat64(double& value) const noexcept;
+    bool toBool(bool& value) const noexcept;        // non-zero is true
+
+    static uint32_t readBigEndian32(const char* bytes) noexcept;
+    static uint64_t readBigEndian64(const char* bytes) noexcept;
+
+private:
+    char type = 0;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+// A received OSC message, decoded in place: nothing is copied out of the packet, which must
+// stay alive as long as the view and any arguments taken from it. parse() checks every
+// argument up front, so the accessors never read outside the packet.
+class OscMessageView
+{
+public:
+    static bool parse(const char* data, size_t size, OscMessageView& result) noexcept;
+
+    std::string_view getAddress() const noexcept { return address; }
+    std::string_view getTypeTags() const noexcept { return typeTags; } // without the leading ','
+
+    // Number of type tags, including any '[' and ']' array markers
+    int size() const noexcept { return (int) typeTags.size(); }
+    bool isEmpty() const noexcept { return typeTags.empty(); }
+
+    // Walks the arguments before index, so prefer iterating when reading several
+    OscArgument operator[](int index) const noexcept;
+
+    class Iterator
+    {
+    public:
+        Iterator(std::string_view::const_iterator typeToUse, const char* dataToUse, const char* endToUse) noexcept
+            : typeTag(typeToUse), data(dataToUse), end(endToUse) {}
+
+        OscArgument operator*() const noexcept;
+        Iterator& operator++() noexcept;
+        bool operator!=(const Iterator& other) const noexcept { return typeTag != other.typeTag; }
+
+    private:
+        std::string_view::const_iterator typeTag;
+        const char* data;
+        const char* end;
+    };
+
+    Iterator begin() const noexcept { return { typeTags.begin(), arguments, packetEnd }; }
+    Iterator end() const noexcept { return { typeTags.end(), packetEnd, packetEnd }; }
+
+    // Encoded size of an argument of this type starting at data, or 0 if it does not fit in
+    // the available bytes or the type is unknown. Types without data have size 0 and are
+    // reported through isKnownType().
+    static size_t getArgumentSize(char type, const char* data, size_t available) noexcept;
+    static bool isKnownType(char type) noexcept;
+
+private:
+    std::string_view address, typeTags;
+    const char* arguments = nullptr;
+    const char* packetEnd = nullptr;
+};
+
+// Walks a packet - a message or a bundle, with bundles nested to any reasonable depth - and
+// calls callback(const OscMessageView&, uint64_t timeTag) for each message in order. Messages
+// outside any bundle get OscPacketWriter::immediately (1) as their time tag. Returns false if
+// the packet is malformed; messages before the malformed part have already been delivered.
+class OscPacketReader
+{
+public:
+    template <typename Callback>
+    static bool forEachMessage(const char* data, size_t size, Callback&& callback)
+    {
+        return forEachMessage(data, size, callback, 1, 0);
+    }
+
+    static bool isBundle(const char* data, size_t size) noexcept;
+
+    static constexpr int maxBundleDepth = 8;
+
+private:
+    template <typename Callback>
+    static bool forEachMessage(const char* data, size_t size, Callback& callback, uint64_t timeTag, int depth)
+    {
+        if (!isBundle(data, size))
+        {
+            OscMessageView message;
+
+            if (!OscMessageView::parse(data, size, message))
+                return false;
+
+            callback(static_cast<const OscMessageView&>(message), timeTag);
+            return true;
+        }
+
+        if (depth >= maxBundleDepth)
+            return false;
+
+        // "#bundle\0", then the 64-bit time tag, then size-prefixed elements
+        const uint64_t bundleTimeTag = OscArgument::readBigEndian64(data + 8);
+        size_t position = 16;
+
+        while (position < size)
+        {
+            if (size - position < 4)
+                return false;
+
+            const uint32_t elementSize = OscArgument::readBigEndian32(data + position);
+            position += 4;
+
+            if (elementSize > size - position || (elementSize & 3) != 0)
+                return false;
+
+            if (!forEachMessage(data + position, elementSize, callback, bundleTimeTag, depth + 1))
+                return false;
+
+            position += elementSize;
+        }
+
+        return true;
+    }
+};
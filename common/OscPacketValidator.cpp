@@ -0,0 +1,308 @@
+#include "OscPacketValidator.h"
+#include "OscPacketReader.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+ #include <emmintrin.h>
+ #define OSC_VALIDATOR_SSE2 1
+#else
+ #define OSC_VALIDATOR_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+ #include <intrin.h>
+#endif
+
+namespace
+{
+    using Result = OscPacketValidator::Result;
+
+    // What each type tag stands for, so checking a tag is one load instead of a switch
+    enum TagKind : uint8_t
+    {
+        unknown,
+        noData,   // T F N I
+        fixed4,   // i f c r m
+        fixed8,   // h d t
+        string,   // s S
+        blob,     // b
+        arrayOpen,
+        arrayClose
+    };
+
+    struct TagTable
+    {
+        TagTable() noexcept
+        {
+            for (const char c : { 'T', 'F', 'N', 'I' })  kinds[(uint8_t) c] = noData;
+            for (const char c : { 'i', 'f', 'c', 'r', 'm' }) kinds[(uint8_t) c] = fixed4;
+            for (const char c : { 'h', 'd', 't' })       kinds[(uint8_t) c] = fixed8;
+            kinds[(uint8_t) 's'] = kinds[(uint8_t) 'S'] = string;
+            kinds[(uint8_t) 'b'] = blob;
+            kinds[(uint8_t) '['] = arrayOpen;
+            kinds[(uint8_t) ']'] = arrayClose;
+        }
+
+        uint8_t kinds[256] {};
+    };
+
+    const TagTable tagTable;
+
+    uint32_t load32(const char* bytes) noexcept
+    {
+        uint32_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    // Bit i set if byte i of the word, in memory order, is zero
+    uint32_t getZeroBytes(uint32_t word) noexcept
+    {
+        uint8_t bytes[4];
+        std::memcpy(bytes, &word, sizeof(bytes));
+        return (uint32_t) (bytes[0] == 0) | ((uint32_t) (bytes[1] == 0) << 1)
+             | ((uint32_t) (bytes[2] == 0) << 2) | ((uint32_t) (bytes[3] == 0) << 3);
+    }
+
+    unsigned countTrailingZeros(uint32_t mask) noexcept
+    {
+       #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (unsigned) index;
+       #else
+        return (unsigned) __builtin_ctz(mask);
+       #endif
+    }
+
+    // Once a zero byte is at index first of a block whose zero bytes are in mask, every byte up
+    // to the next multiple of 4 must be zero too
+    bool isPaddingZero(uint32_t mask, unsigned first) noexcept
+    {
+        const unsigned paddedEnd = (first + 4) & ~3u;
+        const uint32_t needed = ((1u << paddedEnd) - 1) & ~((1u << first) - 1);
+        return (mask & needed) == needed;
+    }
+
+    // Size of the padded, null-terminated string at data, or 0 with result set. available is
+    // a multiple of 4, and so is every block boundary relative to data, so a string's padding
+    // never straddles two blocks.
+    size_t scanString(const char* data, size_t available, Result& result) noexcept
+    {
+        size_t offset = 0;
+
+       #if OSC_VALIDATOR_SSE2
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; available - offset >= 16; offset += 16)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            const auto mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block, zero));
+
+            if (mask != 0)
+            {
+                const unsigned first = countTrailingZeros(mask);
+
+                if (!isPaddingZero(mask, first))
+                {
+                    result = Result::badPadding;
+                    return 0;
+                }
+
+                return offset + ((first + 4) & ~3u);
+            }
+        }
+       #endif
+
+        for (; offset < available; offset += 4)
+        {
+            const uint32_t mask = getZeroBytes(load32(data + offset));
+
+            if (mask != 0)
+            {
+                if (!isPaddingZero(mask, countTrailingZeros(mask)))
+                {
+                    result = Result::badPadding;
+                    return 0;
+                }
+
+                return offset + 4;
+            }
+        }
+
+        result = Result::argumentOverrun; // callers replace this for the address and type tags
+        return 0;
+    }
+
+    Result validateMessage(const char* data, size_t size) noexcept
+    {
+        if (data[0] != '/')
+            return Result::badAddress;
+
+        Result result = Result::valid;
+        const size_t addressSize = scanString(data, size, result);
+
+        if (addressSize == 0)
+            return result == Result::badPadding ? result : Result::badAddress;
+
+        size_t position = addressSize;
+
+        // OSC 1.0 allows a message without a type tag string
+        if (position == size)
+            return Result::valid;
+
+        if (data[position] != ',')
+            return Result::badTypeTags;
+
+        const char* tags = data + position + 1;
+        const size_t tagsSize = scanString(data + position, size - position, result);
+
+        if (tagsSize == 0)
+            return result == Result::badPadding ? result : Result::badTypeTags;
+
+        position += tagsSize;
+        int arrayDepth = 0;
+
+        for (const char* tag = tags; *tag != 0; ++tag)
+        {
+            const size_t available = size - position;
+
+            switch (tagTable.kinds[(uint8_t) *tag])
+            {
+                case noData:
+                    break;
+
+                case fixed4:
+                    if (available < 4)
+                        return Result::argumentOverrun;
+
+                    position += 4;
+                    break;
+
+                case fixed8:
+                    if (available < 8)
+                        return Result::argumentOverrun;
+
+                    position += 8;
+                    break;
+
+                case string:
+                {
+                    const size_t stringSize = scanString(data + position, available, result);
+
+                    if (stringSize == 0)
+                        return result;
+
+                    position += stringSize;
+                    break;
+                }
+
+                case blob:
+                {
+                    if (available < 4)
+                        return Result::argumentOverrun;
+
+                    const size_t blobSize = OscArgument::readBigEndian32(data + position);
+                    const size_t paddedSize = (blobSize + 3) & ~(size_t) 3;
+
+                    if (paddedSize > available - 4)
+                        return Result::argumentOverrun;
+
+                    // The padding, if any, is at the end of the blob's last word
+                    const auto padding = (unsigned) (paddedSize - blobSize);
+                    const uint32_t needed = ((1u << padding) - 1) << (4 - padding);
+
+                    if (padding != 0 && (getZeroBytes(load32(data + position + paddedSize)) & needed) != needed)
+                        return Result::badPadding;
+
+                    position += 4 + paddedSize;
+                    break;
+                }
+
+                case arrayOpen:
+                    ++arrayDepth;
+                    break;
+
+                case arrayClose:
+                    if (--arrayDepth < 0)
+                        return Result::badTypeTags;
+
+                    break;
+
+                default:
+                    return Result::badTypeTags;
+            }
+        }
+
+        if (arrayDepth != 0)
+            return Result::badTypeTags;
+
+        return position == size ? Result::valid : Result::trailingBytes;
+    }
+
+    Result validateElement(const char* data, size_t size, int depth) noexcept
+    {
+        if (!OscPacketReader::isBundle(data, size))
+        {
+            if (size >= 8 && std::memcmp(data, "#bundle", 8) == 0)
+                return Result::badBundle; // no room for the time tag
+
+            return validateMessage(data, size);
+        }
+
+        if (depth >= OscPacketReader::maxBundleDepth)
+            return Result::badBundle;
+
+        for (size_t position = 16; position < size;)
+        {
+            // size and position are multiples of 4, so the size field always fits
+            const uint32_t elementSize = OscArgument::readBigEndian32(data + position);
+            position += 4;
+
+            if (elementSize == 0 || elementSize > size - position)
+                return Result::badBundle;
+
+            if ((elementSize & 3) != 0)
+                return Result::misaligned;
+
+            const Result result = validateElement(data + position, elementSize, depth + 1);
+
+            if (result != Result::valid)
+                return result;
+
+            position += elementSize;
+        }
+
+        return Result::valid;
+    }
+}
+
+OscPacketValidator::Result OscPacketValidator::validate(const char* data, size_t size, size_t maxSize) noexcept
+{
+    if (size > maxSize)
+        return Result::oversized;
+
+    if (size == 0 || (size & 3) != 0)
+        return Result::misaligned;
+
+    return validateElement(data, size, 0);
+}
+
+const char* OscPacketValidator::getName(Result result) noexcept
+{
+    switch (result)
+    {
+        case Result::valid:           return "valid";
+        case Result::oversized:       return "oversized";
+        case Result::misaligned:      return "misaligned";
+        case Result::badAddress:      return "bad address";
+        case Result::badTypeTags:     return "bad type tags";
+        case Result::badPadding:      return "bad padding";
+        case Result::argumentOverrun: return "argument overrun";
+        case Result::trailingBytes:   return "trailing bytes";
+        case Result::badBundle:       return "bad bundle";
+        case Result::numResults:      break;
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Checks a received packet against the OSC encoding rules in one pass, before anything
+// decodes or copies it, and says what is wrong with it. Stricter than OscPacketReader, which
+// only guarantees it never reads outside the packet: padding must be zero, array brackets
+// balanced and the arguments must fill the message exactly, as every conforming sender
+// produces. Strings are scanned 16 bytes at a time with SSE2 where available (4 bytes at a
+// time otherwise), and type tags are looked up in a table, so garbage costs about as much to
+// reject as a valid packet of the same size costs to accept.
+namespace OscPacketValidator
+{
+    enum class Result
+    {
+        valid,
+        oversized,       // larger than the limit given
+        misaligned,      // empty, or a size that is not a multiple of 4
+        badAddress,      // not starting with '/', or not terminated inside the packet
+        badTypeTags,     // no ',', not terminated, unknown type or unbalanced '[' and ']'
+        badPadding,      // non-zero bytes after a string's terminator or a blob's contents
+        argumentOverrun, // the type tags promise more argument bytes than the message holds
+        trailingBytes,   // bytes left over after the last argument
+        badBundle,       // bad element size, an empty element or nested too deeply
+        numResults
+    };
+
+    Result validate(const char* data, size_t size, size_t maxSize = 65536) noexcept;
+
+    // Short lower-case name for reports, e.g. "bad padding"
+    const char* getName(Result result) noexcept;
+}
@@ -0,0 +1,140 @@
+#include "OscPacketWriter.h"
+#include <cassert>
+#include <cstring>
+
+void OscPacketWriter::clear() noexcept
+{
+    buffer.clear();
+    openElements.clear();
+    openIsBundle.clear();
+}
+
+size_t OscPacketWriter::getMessageSize(std::string_view address, std::string_view typeTags, size_t argumentBytes) noexcept
+{
+    return padded(address.size() + 1) + padded(typeTags.size() + 2) + argumentBytes;
+}
+
+uint64_t OscPacketWriter::timeTagFromUnixMilliseconds(double unixMilliseconds) noexcept
+{
+    constexpr double secondsFrom1900To1970 = 2208988800.0;
+    const double seconds = unixMilliseconds / 1000.0 + secondsFrom1900To1970;
+    const double wholeSeconds = (double) (uint64_t) seconds;
+
+    return ((uint64_t) wholeSeconds << 32) | (uint64_t) ((seconds - wholeSeconds) * 4294967296.0);
+}
+
+void OscPacketWriter::beginElement()
+{
+    // Inside a bundle every element is preceded by its size, patched in when it ends
+    const bool insideBundle = !openIsBundle.empty() && openIsBundle.back();
+    openElements.push_back(insideBundle ? buffer.size() : SIZE_MAX);
+
+    if (insideBundle)
+        writeBigEndian32(0);
+}
+
+void OscPacketWriter::endElement()
+{
+    assert(!openElements.empty());
+    const auto sizeField = openElements.back();
+    openElements.pop_back();
+    openIsBundle.pop_back();
+
+    if (sizeField == SIZE_MAX)
+        return;
+
+    const auto elementSize = (uint32_t) (buffer.size() - sizeField - 4);
+    const char bytes[4] = { (char) (elementSize >> 24), (char) (elementSize >> 16),
+                            (char) (elementSize >> 8), (char) elementSize };
+    std::memcpy(buffer.data() + sizeField, bytes, 4);
+}
+
+void OscPacketWriter::beginMessage(std::string_view address, std::string_view typeTags)
+{
+    beginElement();
+    openIsBundle.push_back(false);
+    writePaddedString(address);
+    writePaddedString(typeTags, ',');
+}
+
+void OscPacketWriter::endMessage()
+{
+    assert(!openIsBundle.empty() && !openIsBundle.back());
+    endElement();
+}
+
+void OscPacketWriter::beginBundle(uint64_t timeTag)
+{
+    beginElement();
+    openIsBundle.push_back(true);
+    writePaddedString("#bundle");
+    writeBigEndian64(timeTag);
+}
+
+void OscPacketWriter::endBundle()
+{
+    assert(!openIsBundle.empty() && openIsBundle.back());
+    endElement();
+}
+
+void OscPacketWriter::addInt32(int32_t value)     { writeBigEndian32((uint32_t) value); }
+void OscPacketWriter::addUint32(uint32_t value)   { writeBigEndian32(value); }
+void OscPacketWriter::addInt64(int64_t value)     { writeBigEndian64((uint64_t) value); }
+void OscPacketWriter::addTimeTag(uint64_t value)  { writeBigEndian64(value); }
+
+void OscPacketWriter::addFloat32(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeBigEndian32(bits);
+}
+
+void OscPacketWriter::addFloat64(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeBigEndian64(bits);
+}
+
+void OscPacketWriter::addString(std::string_view value)
+{
+    writePaddedString(value);
+}
+
+void OscPacketWriter::addBlob(const void* data, size_t numBytes)
+{
+    writeBigEndian32((uint32_t) numBytes);
+    const auto start = buffer.size();
+    buffer.resize(start + padded(numBytes), 0);
+
+    if (numBytes > 0)
+        std::memcpy(buffer.data() + start, data, numBytes);
+}
+
+void OscPacketWriter::writeBigEndian32(uint32_t value)
+{
+    const char bytes[4] = { (char) (value >> 24), (char) (value >> 16), (char) (value >> 8), (char) value };
+    buffer.insert(buffer.end(), bytes, bytes + 4);
+}
+
+void OscPacketWriter::writeBigEndian64(uint64_t value)
+{
+    writeBigEndian32((uint32_t) (value >> 32));
+    writeBigEndian32((uint32_t) value);
+}
+
+void OscPacketWriter::writePaddedString(std::string_view text, char prefix)
+{
+    // Null-terminated and zero-padded to a multiple of four bytes
+    const size_t length = text.size() + (prefix != 0 ? 1 : 0);
+    const auto start = buffer.size();
+    buffer.resize(start + padded(length + 1), 0);
+
+    char* dest = buffer.data() + start;
+
+    if (prefix != 0)
+        *dest++ = prefix;
+
+    if (!text.empty())
+        std::memcpy(dest, text.data(), text.size());
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Serialises OSC 1.0 messages and bundles straight into a reusable byte buffer, so a packet
+// can be encoded once and the same bytes handed to any number of sockets. Type tags are
+// given up front, which lets every message be written in a single pass:
+//
+//     OscPacketWriter writer;
+//     writer.beginMessage("/knob", "f");
+//     writer.addFloat32(0.5f);
+//     writer.endMessage();
+//     send(writer.data(), writer.size());
+//
+// Messages written between beginBundle() and endBundle() become size-prefixed bundle
+// elements; bundles can be nested. The writer does not check that the arguments added
+// match the type tags.
+class OscPacketWriter
+{
+public:
+    // OSC time tag meaning "immediately"
+    static constexpr uint64_t immediately = 1;
+
+    void clear() noexcept;
+    void reserve(size_t numBytes) { buffer.reserve(numBytes); }
+
+    const char* data() const noexcept { return buffer.data(); }
+    size_t size() const noexcept { return buffer.size(); }
+    bool empty() const noexcept { return buffer.empty(); }
+
+    void beginMessage(std::string_view address, std::string_view typeTags);
+    void endMessage();
+
+    void beginBundle(uint64_t timeTag = immediately);
+    void endBundle();
+
+    // Number of elements still open (messages or bundles)
+    size_t getDepth() const noexcept { return openElements.size(); }
+
+    void addInt32(int32_t value);
+    void addFloat32(float value);
+    void addString(std::string_view value);
+    void addBlob(const void* data, size_t numBytes);
+    void addInt64(int64_t value);
+    void addFloat64(double value);
+    void addTimeTag(uint64_t value);
+    void addUint32(uint32_t value); // 'c', 'r' and 'm' arguments are four raw bytes
+
+    // Encoded size of a message with this address, type tags and argument payload size
+    static size_t getMessageSize(std::string_view address, std::string_view typeTags, size_t argumentBytes) noexcept;
+
+    static size_t padded(size_t numBytes) noexcept { return (numBytes + 3) & ~(size_t) 3; }
+
+    // NTP time tag (seconds since 1900 in the upper 32 bits, binary fraction in the lower 32)
+    // for a time given in milliseconds since the Unix epoch
+    static uint64_t timeTagFromUnixMilliseconds(double unixMilliseconds) noexcept;
+
+private:
+    void writeBigEndian32(uint32_t value);
+    void writeBigEndian64(uint64_t value);
+    void writePaddedString(std::string_view text, char prefix = 0);
+    void beginElement();
+    void endElement();
+
+    std::vector<char> buffer;
+    std::vector<size_t> openElements; // offsets of the size fields of open bundle elements
+    std::vector<bool> openIsBundle;
+};
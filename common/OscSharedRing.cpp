@@ -0,0 +1,336 @@
+#include "OscSharedRing.h"
+
+#if defined(__linux__)
+ #include <cerrno>
+ #include <cstring>
+ #include <ctime>
+ #include <fcntl.h>
+ #include <linux/futex.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+// Lives at the start of the segment, shared by every process that maps it. The fields are
+// only ever accessed through the __atomic builtins, which work on any suitably aligned
+// memory, including memory mapped into several processes.
+struct OscSharedRing::Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+
+    alignas(64) uint64_t head;            // next byte producers claim
+    alignas(64) uint64_t tail;            // next byte the consumer reads
+    alignas(64) uint32_t consumerWaiting; // futex word: 1 while the consumer sleeps
+    uint64_t dropped;
+};
+
+// Each packet is preceded by 8 bytes: its size, then the size of the whole record rounded
+// up to 8. The record size is written last and is what publishes the packet; the consumer
+// zeroes records as it releases them, so 0 always means "not written yet".
+namespace
+{
+    constexpr uint32_t ringMagic = 0x4f534352; // "OSCR"
+    constexpr uint32_t ringVersion = 1;
+    constexpr uint32_t paddingMarker = 0xffffffff;
+    constexpr size_t recordHeaderSize = 8;
+    constexpr size_t headerSpace = 256; // keeps records 64-byte aligned
+
+    size_t roundUpToRecord(size_t size) noexcept { return (size + 7) & ~(size_t) 7; }
+}
+
+OscSharedRing::~OscSharedRing()
+{
+    close();
+}
+
+#if defined(__linux__)
+
+static void futexWait(uint32_t* word, uint32_t expected, int timeoutMs) noexcept
+{
+    timespec timeout { timeoutMs / 1000, (long) (timeoutMs % 1000) * 1000000L };
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+static void futexWake(uint32_t* word) noexcept
+{
+    syscall(SYS_futex, word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+// Takes ownership of fd, which is closed whether or not mapping succeeds
+bool OscSharedRing::map(int fd, size_t totalSize)
+{
+    void* memory = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (memory == MAP_FAILED)
+        return false;
+
+    header = static_cast<Header*>(memory);
+    records = static_cast<char*>(memory) + headerSpace;
+    mappedSize = totalSize;
+    return true;
+}
+
+bool OscSharedRing::create(const std::string& name, size_t capacityToUse)
+{
+    static_assert(sizeof(Header) <= headerSpace, "ring header does not fit");
+
+    close();
+
+    size_t rounded = 64 * 1024;
+
+    while (rounded < capacityToUse)
+        rounded *= 2;
+
+    // A segment left by an earlier run is replaced; producers still attached to it must
+    // open the new one
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0660);
+
+    if (fd < 0)
+        return false;
+
+    if (ftruncate(fd, (off_t) (headerSpace + rounded)) != 0)
+    {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    if (!map(fd, headerSpace + rounded))
+    {
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate() zero-fills, so every record starts out unpublished
+    header->capacity = rounded;
+    header->version = ringVersion;
+    __atomic_store_n(&header->magic, ringMagic, __ATOMIC_RELEASE);
+
+    capacity = rounded;
+    createdName = name;
+    return true;
+}
+
+bool OscSharedRing::open(const std::string& name)
+{
+    close();
+
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size <= headerSpace)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    if (!map(fd, (size_t) info.st_size))
+        return false;
+
+    const size_t ringCapacity = (size_t) header->capacity;
+
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != ringMagic
+        || header->version != ringVersion
+        || headerSpace + ringCapacity != mappedSize
+        || (ringCapacity & (ringCapacity - 1)) != 0)
+    {
+        close();
+        return false;
+    }
+
+    capacity = ringCapacity;
+    return true;
+}
+
+void OscSharedRing::close() noexcept
+{
+    if (header != nullptr)
+        munmap(header, mappedSize);
+
+    if (!createdName.empty())
+        shm_unlink(createdName.c_str());
+
+    header = nullptr;
+    records = nullptr;
+    capacity = mappedSize = 0;
+    createdName.clear();
+}
+
+bool OscSharedRing::write(const char* data, size_t size) noexcept
+{
+    if (header == nullptr || size == 0 || size > getMaxPacketSize())
+        return false;
+
+    const size_t mask = capacity - 1;
+    const size_t needed = roundUpToRecord(recordHeaderSize + size);
+    uint64_t head = __atomic_load_n(&header->head, __ATOMIC_RELAXED);
+    size_t position, contiguous, total;
+
+    for (;;)
+    {
+        const uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+
+        // Records never wrap; a packet that does not fit before the end pads it out and
+        // starts again at the beginning
+        position = (size_t) head & mask;
+        contiguous = capacity - position;
+        total = needed <= contiguous ? needed : contiguous + needed;
+
+        if (head + total - tail > capacity)
+        {
+            __atomic_fetch_add(&header->dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+
+        if (__atomic_compare_exchange_n(&header->head, &head, head + total, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            break;
+    }
+
+    if (total != needed)
+    {
+        auto* padding = reinterpret_cast<uint32_t*>(records + position);
+        padding[0] = paddingMarker;
+        __atomic_store_n(&padding[1], (uint32_t) contiguous, __ATOMIC_RELEASE);
+        position = 0;
+    }
+
+    auto* record = reinterpret_cast<uint32_t*>(records + position);
+    record[0] = (uint32_t) size;
+    std::memcpy(records + position + recordHeaderSize, data, size);
+    __atomic_store_n(&record[1], (uint32_t) needed, __ATOMIC_RELEASE);
+
+    // Pairs with the fence in waitForData(): either the consumer sees this record before it
+    // sleeps, or we see that it is sleeping
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&header->consumerWaiting, __ATOMIC_RELAXED) != 0
+        && __atomic_exchange_n(&header->consumerWaiting, 0, __ATOMIC_RELAXED) != 0)
+        futexWake(&header->consumerWaiting);
+
+    return true;
+}
+
+bool OscSharedRing::peek(const char*& data, size_t& size) noexcept
+{
+    if (header == nullptr)
+        return false;
+
+    const size_t position = (size_t) __atomic_load_n(&header->tail, __ATOMIC_RELAXED) & (capacity - 1);
+    auto* record = reinterpret_cast<uint32_t*>(records + position);
+    const uint32_t recordSize = __atomic_load_n(&record[1], __ATOMIC_ACQUIRE);
+
+    if (recordSize == 0)
+        return false;
+
+    // Anything in the segment may have been written by any producer, and may be changed again
+    // while we look, so the packet size is read once and only that copy is checked and used
+    const uint32_t packetSize = __atomic_load_n(&record[0], __ATOMIC_RELAXED);
+    const bool isPadding = packetSize == paddingMarker;
+
+    if ((recordSize & 7) != 0
+        || recordSize > capacity - position
+        || (!isPadding && (packetSize == 0 || packetSize > getMaxPacketSize()
+                           || (size_t) packetSize + recordHeaderSize > recordSize)))
+    {
+        corrupt = true;
+        return false;
+    }
+
+    releaseBytes = recordSize;
+
+    if (isPadding)
+    {
+        data = nullptr;
+        size = 0;
+    }
+    else
+    {
+        data = records + position + recordHeaderSize;
+        size = packetSize;
+    }
+
+    return true;
+}
+
+void OscSharedRing::release() noexcept
+{
+    // Only ever a record peek() has checked
+    if (releaseBytes == 0)
+        return;
+
+    const uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_RELAXED);
+
+    // Any 8-byte boundary in here may hold the next record header after the ring wraps
+    std::memset(records + ((size_t) tail & (capacity - 1)), 0, (size_t) releaseBytes);
+    __atomic_store_n(&header->tail, tail + releaseBytes, __ATOMIC_RELEASE);
+    releaseBytes = 0;
+}
+
+void OscSharedRing::recreate()
+{
+    const std::string name = createdName;
+    const size_t size = capacity;
+
+    corrupt = false;
+    ++numCorrupt;
+
+    // Producers keep writing into the old segment until they open() the new one. If the new
+    // one cannot be created the ring is left closed.
+    create(name, size);
+}
+
+void OscSharedRing::waitForData(int timeoutMs) noexcept
+{
+    if (header == nullptr)
+        return;
+
+    __atomic_store_n(&header->consumerWaiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    const size_t position = (size_t) __atomic_load_n(&header->tail, __ATOMIC_RELAXED) & (capacity - 1);
+    auto* record = reinterpret_cast<uint32_t*>(records + position);
+
+    if (__atomic_load_n(&record[1], __ATOMIC_ACQUIRE) == 0)
+        futexWait(&header->consumerWaiting, 1, timeoutMs);
+
+    __atomic_store_n(&header->consumerWaiting, 0, __ATOMIC_RELAXED);
+}
+
+void OscSharedRing::wakeConsumer() noexcept
+{
+    if (header == nullptr)
+        return;
+
+    __atomic_store_n(&header->consumerWaiting, 0, __ATOMIC_RELAXED);
+    futexWake(&header->consumerWaiting);
+}
+
+uint64_t OscSharedRing::getNumDropped() const noexcept
+{
+    return header != nullptr ? __atomic_load_n(&header->dropped, __ATOMIC_RELAXED) : 0;
+}
+
+#else
+
+bool OscSharedRing::map(int, size_t) { return false; }
+bool OscSharedRing::create(const std::string&, size_t) { return false; }
+bool OscSharedRing::open(const std::string&) { return false; }
+void OscSharedRing::close() noexcept {}
+bool OscSharedRing::write(const char*, size_t) noexcept { return false; }
+bool OscSharedRing::peek(const char*&, size_t&) noexcept { return false; }
+void OscSharedRing::release() noexcept {}
+void OscSharedRing::recreate() {}
+void OscSharedRing::waitForData(int) noexcept {}
+void OscSharedRing::wakeConsumer() noexcept {}
+uint64_t OscSharedRing::getNumDropped() const noexcept { return 0; }
+
+#endif
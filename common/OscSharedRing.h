@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A ring of OSC packets in a named shared-memory segment, for producers on the same machine
+// that send far more messages than a socket round through the kernel per packet allows.
+// Any number of producers, in any number of processes and threads, append packets without
+// locks or system calls; one consumer drains them in order.
+//
+// Producers claim space with a compare-and-swap on the head and publish a packet by writing
+// its length last. The consumer sleeps on a futex in the segment only once the ring is
+// empty, and producers pay for a wake-up call only while it sleeps, so under load nobody
+// makes a system call at all. A full ring drops the packet and counts it; producers never
+// wait.
+//
+//     OscSharedRing ring;                         // producer process
+//     ring.open("/osc_host");
+//     OscPacketWriter writer;
+//     writer.beginMessage("/fader", "f");
+//     writer.addFloat32(0.5f);
+//     writer.endMessage();
+//     ring.write(writer.data(), writer.size());
+//
+// A producer that dies between claiming space and publishing stalls the ring at that packet
+// until the consumer recreates it. A malformed record, from a buggy or hostile producer, makes
+// the consumer recreate the ring by itself, losing whatever was queued; producers then have
+// to open() it again. Linux only; elsewhere create() and open() fail.
+class OscSharedRing
+{
+public:
+    OscSharedRing() = default;
+    ~OscSharedRing();
+
+    OscSharedRing(const OscSharedRing&) = delete;
+    OscSharedRing& operator=(const OscSharedRing&) = delete;
+
+    // Consumer: creates (or replaces) the segment with room for capacity bytes of packets,
+    // rounded up to a power of two. The segment is removed again by close().
+    bool create(const std::string& name, size_t capacity = defaultCapacity);
+
+    // Producer: attaches to a segment created by the consumer
+    bool open(const std::string& name);
+
+    void close() noexcept;
+    bool isOpen() const noexcept { return header != nullptr; }
+
+    // Producer, any thread: appends one packet. Returns false if it does not fit right now.
+    bool write(const char* data, size_t size) noexcept;
+
+    // Consumer: calls callback(const char* data, size_t size) for up to maxPackets published
+    // packets and returns how many there were. The data is only valid during the call. size is
+    // checked against the ring and at most getMaxPacketSize(), but data points into the shared
+    // segment, where a hostile producer can still change it, so copy it before validating it.
+    template <typename Callback>
+    size_t drain(Callback&& callback, size_t maxPackets = 4096)
+    {
+        size_t count = 0;
+        const char* data;
+        size_t size;
+
+        while (count < maxPackets && peek(data, size))
+        {
+            if (data != nullptr)
+            {
+                callback(data, size);
+                ++count;
+            }
+
+            release();
+        }
+
+        if (corrupt)
+            recreate();
+
+        return count;
+    }
+
+    // Consumer: sleeps until a producer publishes a packet or timeoutMs passes. Returns
+    // immediately if packets are waiting.
+    void waitForData(int timeoutMs) noexcept;
+
+    // Consumer: wakes a waitForData() call from another thread, e.g. to shut down
+    void wakeConsumer() noexcept;
+
+    uint64_t getNumDropped() const noexcept;
+
+    // Consumer: how often a malformed record made drain() recreate the ring
+    uint64_t getNumCorrupt() const noexcept { return numCorrupt; }
+    size_t getCapacity() const noexcept { return capacity; }
+
+    // Largest packet accepted; bigger ones would leave too little room for anyone else
+    size_t getMaxPacketSize() const noexcept { return capacity / 4; }
+
+    static constexpr size_t defaultCapacity = 4 << 20;
+
+private:
+    struct Header;
+
+    bool map(int fd, size_t totalSize);
+
+    // Consumer: the packet at the tail, or data == nullptr for padding; false if nothing is
+    // published there yet, or if the record there is malformed, which sets corrupt
+    bool peek(const char*& data, size_t& size) noexcept;
+    void release() noexcept;
+    void recreate();
+
+    Header* header = nullptr;
+    char* records = nullptr;
+    size_t capacity = 0;
+    size_t mappedSize = 0;
+    std::string createdName; // set on the consumer side, which unlinks the segment
+
+    // Consumer only
+    uint64_t releaseBytes = 0;
+    bool corrupt = false;
+    uint64_t numCorrupt = 0;
+};
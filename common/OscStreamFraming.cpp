@@ -0,0 +1,38 @@
+#include "OscStreamFraming.h"
+
+void appendFramedPacket(OscFraming framing, const char* data, size_t size, std::vector<char>& output)
+{
+    if (framing == OscFraming::lengthPrefix)
+    {
+        const char length[4] = { (char) (size >> 24), (char) (size >> 16), (char) (size >> 8), (char) size };
+        output.insert(output.end(), length, length + 4);
+        output.insert(output.end(), data, data + size);
+        return;
+    }
+
+    // A leading END flushes any line noise the receiver has collected (RFC 1055)
+    output.reserve(output.size() + size + 2);
+    output.push_back((char) OscStreamDecoder::slipEnd);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto byte = (uint8_t) data[i];
+
+        if (byte == OscStreamDecoder::slipEnd)
+        {
+            output.push_back((char) OscStreamDecoder::slipEscape);
+            output.push_back((char) OscStreamDecoder::slipEscapedEnd);
+        }
+        else if (byte == OscStreamDecoder::slipEscape)
+        {
+            output.push_back((char) OscStreamDecoder::slipEscape);
+            output.push_back((char) OscStreamDecoder::slipEscapedEscape);
+        }
+        else
+        {
+            output.push_back((char) byte);
+        }
+    }
+
+    output.push_back((char) OscStreamDecoder::slipEnd);
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Packet framing for OSC over stream transports such as TCP:
+//
+//   lengthPrefix - OSC 1.0: each packet is preceded by its size as a big-endian int32
+//   slip         - OSC 1.1: each packet is SLIP-encoded (RFC 1055) and ends with an END byte
+//
+// OscStreamDecoder takes bytes in whatever chunks the socket returns them and hands out
+// complete packets; appendFramedPacket() writes one framed packet to an output buffer.
+enum class OscFraming
+{
+    lengthPrefix,
+    slip
+};
+
+class OscStreamDecoder
+{
+public:
+    OscStreamDecoder(OscFraming framingToUse, size_t maxPacketSizeToUse)
+        : framing(framingToUse), maxPacketSize(maxPacketSizeToUse) {}
+
+    OscFraming getFraming() const noexcept { return framing; }
+
+    // Feeds received bytes and calls callback(const char* packet, size_t size) for every
+    // packet they complete. Returns false if the stream is corrupt (a length prefix beyond
+    // maxPacketSize, or a SLIP packet growing past it); the connection should then be closed.
+    template <typename Callback>
+    bool feed(const char* data, size_t size, Callback&& callback)
+    {
+        return framing == OscFraming::slip ? feedSlip(data, size, callback)
+                                           : feedLengthPrefixed(data, size, callback);
+    }
+
+    // Bytes held for a packet that has not been completed yet
+    size_t getNumPendingBytes() const noexcept { return pending.size(); }
+
+    static constexpr uint8_t slipEnd = 0xc0;
+    static constexpr uint8_t slipEscape = 0xdb;
+    static constexpr uint8_t slipEscapedEnd = 0xdc;
+    static constexpr uint8_t slipEscapedEscape = 0xdd;
+
+private:
+    template <typename Callback>
+    bool feedLengthPrefixed(const char* data, size_t size, Callback& callback)
+    {
+        // Whole packets in data are handed out without copying; only a packet split across
+        // reads is assembled in pending
+        while (size > 0)
+        {
+            if (pending.empty() && size >= 4)
+            {
+                const size_t packetSize = readLength(data);
+
+                if (packetSize > maxPacketSize)
+                    return false;
+
+                if (size - 4 >= packetSize)
+                {
+                    callback(data + 4, packetSize);
+                    data += 4 + packetSize;
+                    size -= 4 + packetSize;
+                    continue;
+                }
+            }
+
+            const size_t wanted = pending.size() < 4 ? 4 - pending.size()
+                                                     : 4 + readLength(pending.data()) - pending.size();
+            const size_t take = wanted < size ? wanted : size;
+            pending.insert(pending.end(), data, data + take);
+            data += take;
+            size -= take;
+
+            if (pending.size() < 4)
+                continue;
+
+            const size_t packetSize = readLength(pending.data());
+
+            if (packetSize > maxPacketSize)
+                return false;
+
+            if (pending.size() == 4 + packetSize)
+            {
+                callback(pending.data() + 4, packetSize);
+                pending.clear();
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Callback>
+    bool feedSlip(const char* data, size_t size, Callback& callback)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const auto byte = (uint8_t) data[i];
+
+            if (escaped)
+            {
+                escaped = false;
+                pending.push_back((char) (byte == slipEscapedEnd ? slipEnd
+                                        : byte == slipEscapedEscape ? slipEscape : byte));
+            }
+            else if (byte == slipEscape)
+            {
+                escaped = true;
+                continue;
+            }
+            else if (byte == slipEnd)
+            {
+                // Empty frames are allowed; senders often start each packet with END as well
+                if (!pending.empty())
+                    callback(pending.data(), pending.size());
+
+                pending.clear();
+                continue;
+            }
+            else
+            {
+                pending.push_back((char) byte);
+            }
+
+            if (pending.size() > maxPacketSize)
+                return false;
+        }
+
+        return true;
+    }
+
+    static size_t readLength(const char* bytes) noexcept
+    {
+        const auto* b = reinterpret_cast<const uint8_t*>(bytes);
+        return ((size_t) b[0] << 24) | ((size_t) b[1] << 16) | ((size_t) b[2] << 8) | (size_t) b[3];
+    }
+
+    OscFraming framing;
+    size_t maxPacketSize;
+    std::vector<char> pending;
+    bool escaped = false;
+};
+
+// Appends one framed packet to output
+void appendFramedPacket(OscFraming framing, const char* data, size_t size, std::vector<char>& output);
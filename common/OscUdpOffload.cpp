@@ -0,0 +1,124 @@
+#include "OscUdpOffload.h"
+
+#if defined(__linux__)
+ #include <arpa/inet.h>
+ #include <cerrno>
+ #include <cstring>
+ #include <netinet/in.h>
+ #include <netinet/udp.h>
+ #include <poll.h>
+ #include <sys/socket.h>
+
+ // Older C library headers predate the options even where the kernel supports them
+ #ifndef SOL_UDP
+  #define SOL_UDP 17
+ #endif
+ #ifndef UDP_SEGMENT
+  #define UDP_SEGMENT 103
+ #endif
+ #ifndef UDP_GRO
+  #define UDP_GRO 104
+ #endif
+
+bool OscUdpOffload::isSegmentationSupported(int socket) noexcept
+{
+    int segmentSize = 0;
+    socklen_t length = sizeof(segmentSize);
+    return getsockopt(socket, SOL_UDP, UDP_SEGMENT, &segmentSize, &length) == 0;
+}
+
+size_t OscUdpOffload::writeSegmentControl(char* control, size_t segmentSize) noexcept
+{
+    static_assert(CMSG_SPACE(sizeof(uint16_t)) <= segmentControlSpace, "control buffer too small");
+
+    std::memset(control, 0, segmentControlSpace);
+
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_UDP;
+    header->cmsg_type = UDP_SEGMENT;
+    header->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+    const auto size = (uint16_t) segmentSize;
+    std::memcpy(CMSG_DATA(header), &size, sizeof(size));
+    return CMSG_SPACE(sizeof(uint16_t));
+}
+
+bool OscUdpOffload::enableReceiveCoalescing(int socket) noexcept
+{
+    const int enable = 1;
+    return setsockopt(socket, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0;
+}
+
+int OscUdpOffload::receive(int socket, char* buffer, size_t bufferSize, int timeoutMs, size_t& segmentSize,
+                           uint32_t* sourceAddress, uint16_t* sourcePort) noexcept
+{
+    pollfd descriptor { socket, POLLIN, 0 };
+    const int ready = poll(&descriptor, 1, timeoutMs);
+
+    if (ready <= 0)
+        return ready < 0 && errno != EINTR ? -1 : 0;
+
+    static_assert(CMSG_SPACE(sizeof(int)) <= receiveControlSpace, "control buffer too small");
+
+    iovec data { buffer, bufferSize };
+    alignas(cmsghdr) char control[receiveControlSpace];
+    sockaddr_in source{};
+
+    msghdr message{};
+    message.msg_name = &source;
+    message.msg_namelen = sizeof(source);
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    const ssize_t bytesRead = recvmsg(socket, &message, MSG_DONTWAIT);
+
+    if (bytesRead < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+
+    segmentSize = getSegmentSize(control, message.msg_controllen, (size_t) bytesRead);
+
+    if (sourceAddress != nullptr)
+        *sourceAddress = ntohl(source.sin_addr.s_addr);
+
+    if (sourcePort != nullptr)
+        *sourcePort = ntohs(source.sin_port);
+
+    return (int) bytesRead;
+}
+
+size_t OscUdpOffload::getSegmentSize(const void* control, size_t controlLength, size_t size) noexcept
+{
+    msghdr message{};
+    message.msg_control = const_cast<void*>(control);
+    message.msg_controllen = controlLength;
+
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header))
+    {
+        if (header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO)
+        {
+            int segmentSize = 0;
+            std::memcpy(&segmentSize, CMSG_DATA(header), sizeof(segmentSize));
+
+            if (segmentSize > 0)
+                return (size_t) segmentSize;
+        }
+    }
+
+    return size;
+}
+
+#else
+
+bool OscUdpOffload::isSegmentationSupported(int) noexcept { return false; }
+size_t OscUdpOffload::writeSegmentControl(char*, size_t) noexcept { return 0; }
+bool OscUdpOffload::enableReceiveCoalescing(int) noexcept { return false; }
+int OscUdpOffload::receive(int, char*, size_t, int, size_t&, uint32_t*, uint16_t*) noexcept { return -1; }
+size_t OscUdpOffload::getSegmentSize(const void*, size_t, size_t size) noexcept { return size; }
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// UDP segmentation and receive offload (Linux 4.18 and 5.0 onwards). With segmentation
+// (UDP_SEGMENT, "GSO") a sender passes one buffer holding many datagrams of the same size
+// to a single sendmsg() and the kernel or NIC cuts it up; with receive offload (UDP_GRO)
+// the kernel may hand a receiver several datagrams from the same flow in one buffer,
+// together with their size. Either way one system call moves dozens of small OSC packets.
+//
+// Every function fails harmlessly where the kernel or platform lacks support, so callers
+// can fall back to one datagram per call.
+namespace OscUdpOffload
+{
+    // Per buffer; the kernel refuses more, and the total is bounded by the 64 KiB IP limit
+    constexpr size_t maxSegments = 64;
+    constexpr size_t maxBufferSize = 65000;
+
+    // Larger segments would not fit an Ethernet frame, and segmentation never fragments
+    constexpr size_t maxSegmentSize = 1472;
+
+    // Room for the control message that writeSegmentControl() produces
+    constexpr size_t segmentControlSpace = 32;
+
+    bool isSegmentationSupported(int socket) noexcept;
+
+    // Writes a UDP_SEGMENT control message for sendmsg()/sendmmsg() into control, which must
+    // hold segmentControlSpace bytes, and returns the msg_controllen to use (0 if unsupported)
+    size_t writeSegmentControl(char* control, size_t segmentSize) noexcept;
+
+    // Asks the kernel to coalesce received datagrams; receive() then splits them up again
+    bool enableReceiveCoalescing(int socket) noexcept;
+
+    // Receives one datagram, or several coalesced ones laid back to back, waiting at most
+    // timeoutMs. segmentSize is set to the size of each datagram in the buffer (the last one
+    // may be shorter), and the sender's IPv4 address and port (host byte order) are stored
+    // where given. Returns the number of bytes, 0 on timeout, or -1 on error.
+    int receive(int socket, char* buffer, size_t bufferSize, int timeoutMs, size_t& segmentSize,
+                uint32_t* sourceAddress = nullptr, uint16_t* sourcePort = nullptr) noexcept;
+
+    // For callers receiving by other means (e.g. io_uring): the segment size recorded in the
+    // control data of a received buffer of size bytes, or size if it was not coalesced.
+    // Receivers need receiveControlSpace bytes of control buffer to get it.
+    size_t getSegmentSize(const void* control, size_t controlLength, size_t size) noexcept;
+    constexpr size_t receiveControlSpace = 24;
+
+    // Calls callback(const char* data, size_t size) for each datagram in a received buffer
+    template <typename Callback>
+    void forEachSegment(const char* data, size_t size, size_t segmentSize, Callback&& callback)
+    {
+        if (segmentSize == 0)
+            segmentSize = size;
+
+        for (size_t offset = 0; offset < size; offset += segmentSize)
+            callback(data + offset, size - offset < segmentSize ? size - offset : segmentSize);
+    }
+}
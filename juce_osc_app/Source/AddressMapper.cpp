@@ -0,0 +1,204 @@
+#include "AddressMapper.h"
+
+//==============================================================================
+juce::var AddressMapping::toVar(const ParameterSchema& schema) const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("address", addressPattern);
+    object->setProperty("argument", argumentIndex);
+
+    // Parameters are referred to by address so mappings survive schema edits
+    object->setProperty("parameter", schema[parameterIndex].address);
+    object->setProperty("min", inputMinimum);
+    object->setProperty("max", inputMaximum);
+    object->setProperty("invert", inverted);
+    return juce::var(object);
+}
+
+bool AddressMapping::fromVar(const juce::var& json, const ParameterSchema& schema, AddressMapping& result)
+{
+    if (!json.isObject())
+        return false;
+
+    AddressMapping mapping;
+    mapping.addressPattern = json.getProperty("address", {}).toString();
+    mapping.argumentIndex = (int) json.getProperty("argument", 0);
+    mapping.parameterIndex = schema.indexOf(json.getProperty("parameter", {}).toString());
+    mapping.inputMinimum = (float) (double) json.getProperty("min", 0.0);
+    mapping.inputMaximum = (float) (double) json.getProperty("max", 1.0);
+    mapping.inverted = (bool) json.getProperty("invert", false);
+
+    if (!mapping.addressPattern.startsWithChar('/') || mapping.parameterIndex < 0 || mapping.argumentIndex < 0)
+        return false;
+
+    result = mapping;
+    return true;
+}
+
+//==============================================================================
+AddressMapper::AddressMapper(std::shared_ptr<const ParameterSchema> schemaToUse)
+    : schema(std::move(schemaToUse))
+{
+    compiled = compile();
+}
+
+void AddressMapper::setMappings(std::vector<AddressMapping> newMappings)
+{
+    mappings = std::move(newMappings);
+    std::atomic_store(&compiled, compile());
+}
+
+std::shared_ptr<const AddressMapper::CompiledTable> AddressMapper::compile() const
+{
+    auto table = std::make_shared<CompiledTable>();
+
+    // Group routes by exact address so each address resolves to one contiguous run
+    std::unordered_map<std::string, std::vector<Route>> byAddress;
+    byAddress.reserve((size_t) schema->size() + mappings.size());
+
+    using PatternRoute = std::pair<OscAddressPattern, Route>;
+    std::unordered_map<std::string, std::vector<PatternRoute>> patternsByFirstPart;
+
+    for (int i = 0; i < schema->size(); ++i)
+    {
+        Route route;
+        route.parameterIndex = i;
+        byAddress[(*schema)[i].address.toStdString()].push_back(route);
+    }
+
+    for (const auto& mapping : mappings)
+    {
+        if (!juce::isPositiveAndBelow(mapping.parameterIndex, schema->size()))
+            continue;
+
+        const auto& spec = (*schema)[mapping.parameterIndex];
+
+        Route route;
+        route.argumentIndex = mapping.argumentIndex;
+        route.parameterIndex = mapping.parameterIndex;
+        route.scaled = true;
+        route.inverted = mapping.inverted;
+        route.inputMinimum = mapping.inputMinimum;
+        route.inputScale = mapping.inputMaximum != mapping.inputMinimum
+                               ? 1.0f / (mapping.inputMaximum - mapping.inputMinimum)
+                               : 0.0f;
+        route.outputMinimum = spec.minimum;
+        route.outputRange = spec.maximum - spec.minimum;
+
+        if (!OscAddressPattern::containsWildcards(mapping.addressPattern.toRawUTF8()))
+        {
+            byAddress[mapping.addressPattern.toStdString()].push_back(route);
+            continue;
+        }
+
+        // Invalid patterns are skipped; they were validated when the mapping was created
+        OscAddressPattern pattern;
+
+        if (!pattern.compile(mapping.addressPattern.toRawUTF8()))
+            continue;
+
+        const auto text = mapping.addressPattern.toStdString();
+        auto firstPart = text.substr(0, text.find('/', 1));
+
+        if (OscAddressPattern::containsWildcards(firstPart))
+            table->patternRoutes.emplace_back(std::move(pattern), route);
+        else
+            patternsByFirstPart[std::move(firstPart)].emplace_back(std::move(pattern), route);
+    }
+
+    table->numUnindexedPatterns = table->patternRoutes.size();
+    table->patternsByFirstPart.reserve(patternsByFirstPart.size());
+
+    for (auto& entry : patternsByFirstPart)
+    {
+        const size_t begin = table->patternRoutes.size();
+        table->patternRoutes.insert(table->patternRoutes.end(), entry.second.begin(), entry.second.end());
+        table->patternsByFirstPart.emplace(entry.first, std::make_pair(begin, table->patternRoutes.size()));
+    }
+
+    table->routes.reserve((size_t) schema->size() + mappings.size());
+    table->exactRoutes.reserve(byAddress.size());
+
+    for (auto& entry : byAddress)
+    {
+        const int begin = (int) table->routes.size();
+        table->routes.insert(table->routes.end(), entry.second.begin(), entry.second.end());
+        table->exactRoutes.emplace(entry.first, std::make_pair(begin, (int) table->routes.size()));
+    }
+
+    return table;
+}
+
+void AddressMapper::startLearning(int parameterIndex)
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(learnLock);
+        hasLearnCandidate = false;
+    }
+
+    learningParameter.store(parameterIndex, std::memory_order_relaxed);
+}
+
+void AddressMapper::cancelLearning()
+{
+    learningParameter.store(-1, std::memory_order_relaxed);
+}
+
+void AddressMapper::offerLearnCandidate(const OscMessageView& message)
+{
+    int i = -1;
+
+    for (const auto argument : message)
+    {
+        ++i;
+
+        if (!argument.isNumeric())
+            continue;
+
+        const juce::SpinLock::ScopedTryLockType sl(learnLock);
+
+        // The first candidate wins; later messages until completeLearning() are ignored
+        if (sl.isLocked() && !hasLearnCandidate)
+        {
+            hasLearnCandidate = true;
+            learnAddress = juce::String::fromUTF8(message.getAddress().data(), (int) message.getAddress().size());
+            learnArgumentIndex = i;
+        }
+
+        return;
+    }
+}
+
+bool AddressMapper::completeLearning(AddressMapping& learned)
+{
+    const int parameterIndex = learningParameter.load(std::memory_order_relaxed);
+
+    if (parameterIndex < 0)
+        return false;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(learnLock);
+
+        if (!hasLearnCandidate)
+            return false;
+
+        learned.addressPattern = learnAddress;
+        learned.argumentIndex = learnArgumentIndex;
+        hasLearnCandidate = false;
+    }
+
+    learningParameter.store(-1, std::memory_order_relaxed);
+
+    // Learned mappings pass the parameter's own range through unchanged until the input range
+    // is set from the control's menu, e.g. 0-127 for a MIDI-style controller
+    const auto& spec = (*schema)[parameterIndex];
+    learned.parameterIndex = parameterIndex;
+    learned.inputMinimum = spec.minimum;
+    learned.inputMaximum = spec.maximum;
+    learned.inverted = false;
+
+    auto newMappings = mappings;
+    newMappings.push_back(learned);
+    setMappings(std::move(newMappings));
+    return true;
+}
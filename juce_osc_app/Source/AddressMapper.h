@@ -0,0 +1,174 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "OscAddressPattern.h"
+#include "OscPacketReader.h"
+#include "ParameterSchema.h"
+
+// Binds one argument of incoming messages to a parameter. The argument is scaled from
+// [inputMinimum, inputMaximum] to the parameter's range, optionally inverted.
+struct AddressMapping
+{
+    juce::String addressPattern; // an exact address, or an OSC pattern using * ? [] {}
+    int argumentIndex = 0;
+    int parameterIndex = -1;
+    float inputMinimum = 0.0f;
+    float inputMaximum = 1.0f;
+    bool inverted = false;
+
+    juce::var toVar(const ParameterSchema& schema) const;
+    static bool fromVar(const juce::var& json, const ParameterSchema& schema, AddressMapping& result);
+};
+
+// Routes incoming messages to parameters. Every parameter is reachable at its own schema
+// address; learned or configured mappings add more routes. All of them are compiled into one
+// immutable table (a hash map for exact addresses plus precompiled wildcard patterns) that is
+// swapped in atomically whenever the mappings change, so the network thread never waits and
+// the cost per packet stays one hash lookup however many exact mappings exist.
+//
+// Patterns are only tried for addresses without an exact route. They are grouped by their
+// first address part, so an address is only matched against the patterns that share its
+// first part (one more hash lookup) and those whose first part is itself a wildcard.
+class AddressMapper
+{
+public:
+    explicit AddressMapper(std::shared_ptr<const ParameterSchema> schemaToUse);
+
+    // Message thread
+    void setMappings(std::vector<AddressMapping> newMappings);
+    const std::vector<AddressMapping>& getMappings() const noexcept { return mappings; }
+
+    // Message thread: the next incoming message with a numeric argument is bound to the
+    // parameter. completeLearning() adds that mapping once such a message has arrived.
+    void startLearning(int parameterIndex);
+    void cancelLearning();
+    int getLearningParameter() const noexcept { return learningParameter.load(std::memory_order_relaxed); }
+    bool completeLearning(AddressMapping& learned);
+
+    // Network thread: calls callback(parameterIndex, value) for every route matching the
+    // message, with the value scaled and constrained to the parameter's range. Any numeric
+    // argument type (int32, int64, float32, float64, true/false) drives a parameter.
+    template <typename Callback>
+    void map(const OscMessageView& message, Callback&& callback)
+    {
+        const auto table = std::atomic_load(&compiled);
+
+        if (learningParameter.load(std::memory_order_relaxed) >= 0)
+            offerLearnCandidate(message);
+
+        // Reused per thread, so looking up an address does not allocate
+        thread_local std::string address;
+        address.assign(message.getAddress());
+
+        const auto found = table->exactRoutes.find(address);
+
+        if (found != table->exactRoutes.end())
+        {
+            for (int i = found->second.first; i < found->second.second; ++i)
+                applyRoute(table->routes[(size_t) i], message, callback);
+        }
+        else if (!table->patternRoutes.empty())
+        {
+            mapPatterns(*table, message, callback);
+        }
+    }
+
+private:
+    struct Route
+    {
+        int argumentIndex = 0;
+        int parameterIndex = 0;
+        bool scaled = false;
+        bool inverted = false;
+        float inputMinimum = 0.0f;
+        float inputScale = 1.0f;  // 1 / (inputMaximum - inputMinimum)
+        float outputMinimum = 0.0f;
+        float outputRange = 1.0f;
+    };
+
+    struct CompiledTable
+    {
+        std::unordered_map<std::string, std::pair<int, int>> exactRoutes; // [begin, end) in routes
+        std::vector<Route> routes;
+        // Patterns whose first address part has wildcards come first, then the rest grouped
+        // by their literal first part, e.g. "/mixer" for "/mixer/*/gain"
+        std::vector<std::pair<OscAddressPattern, Route>> patternRoutes;
+        size_t numUnindexedPatterns = 0;
+        std::unordered_map<std::string, std::pair<size_t, size_t>> patternsByFirstPart; // [begin, end)
+    };
+
+    std::shared_ptr<const CompiledTable> compile() const;
+    void offerLearnCandidate(const OscMessageView& message);
+
+    static bool getNumericArgument(const OscMessageView& message, int argumentIndex, float& value) noexcept
+    {
+        return argumentIndex < message.size() && message[argumentIndex].toFloat32(value);
+    }
+
+    template <typename Callback>
+    void applyRoute(const Route& route, const OscMessageView& message, Callback& callback) const
+    {
+        float value;
+
+        if (!getNumericArgument(message, route.argumentIndex, value))
+            return;
+
+        if (route.scaled)
+        {
+            auto normalised = juce::jlimit(0.0f, 1.0f, (value - route.inputMinimum) * route.inputScale);
+
+            if (route.inverted)
+                normalised = 1.0f - normalised;
+
+            value = route.outputMinimum + normalised * route.outputRange;
+        }
+
+        callback(route.parameterIndex, (*schema)[route.parameterIndex].constrain(value));
+    }
+
+    template <typename Callback>
+    void mapPatterns(const CompiledTable& table, const OscMessageView& message, Callback& callback) const
+    {
+        const auto address = message.getAddress();
+
+        // Incoming addresses that are themselves patterns can't be matched against patterns
+        if (OscAddressPattern::containsWildcards(address))
+            return;
+
+        const auto tryPatterns = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                if (table.patternRoutes[i].first.matches(address))
+                    applyRoute(table.patternRoutes[i].second, message, callback);
+        };
+
+        tryPatterns(0, table.numUnindexedPatterns);
+
+        // Wildcards never match a '/', so only patterns with the same first part can match
+        thread_local std::string firstPart;
+        firstPart.assign(address.substr(0, address.find('/', 1)));
+
+        const auto found = table.patternsByFirstPart.find(firstPart);
+
+        if (found != table.patternsByFirstPart.end())
+            tryPatterns(found->second.first, found->second.second);
+    }
+
+    std::shared_ptr<const ParameterSchema> schema;
+    std::vector<AddressMapping> mappings;
+
+    // Swapped atomically; the network thread holds a reference while mapping one message
+    std::shared_ptr<const CompiledTable> compiled;
+
+    std::atomic<int> learningParameter{-1};
+    juce::SpinLock learnLock;
+    bool hasLearnCandidate = false;
+    juce::String learnAddress;
+    int learnArgumentIndex = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AddressMapper)
+};
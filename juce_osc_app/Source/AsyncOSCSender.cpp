@@ -0,0 +1,813 @@
+#ifdef _WIN32
+ #include <winsock2.h>
+ #include <ws2tcpip.h>
+#else
+ #include <sys/types.h>
+ #include <sys/socket.h>
+ #include <netinet/in.h>
+ #include <netdb.h>
+ #include <arpa/inet.h>
+ #include <poll.h>
+ #include <unistd.h>
+ #include <cerrno>
+#endif
+
+#include "AsyncOSCSender.h"
+#include "OscMulticast.h"
+#include "OscPacketReader.h"
+#include "OscStreamFraming.h"
+#include "OscUdpOffload.h"
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+//==============================================================================
+struct AsyncOSCSender::LocalLink
+{
+    juce::CriticalSection lock; // stream writes from several threads must not interleave
+    OscLocalSocket socket;
+};
+
+struct AsyncOSCSender::RoutingTable
+{
+    struct Route
+    {
+        Destination destination;
+        std::string prefix; // UTF-8 copy of destination.addressPrefix for cheap matching
+        std::unique_ptr<LocalLink> local; // local transports only
+
+       #if JUCE_LINUX
+        sockaddr_in address{};
+       #else
+        juce::String address;
+        std::unique_ptr<juce::DatagramSocket> socket;
+       #endif
+    };
+
+    ~RoutingTable()
+    {
+       #if JUCE_LINUX
+        if (socketHandle >= 0)
+            ::close(socketHandle);
+       #endif
+    }
+
+    std::vector<Route> routes;
+
+   #if JUCE_LINUX
+    int socketHandle = -1;
+    std::atomic<bool> canSegment{false}; // cleared if the kernel rejects a segmented send
+   #endif
+};
+
+namespace
+{
+    // Appends a copy of the bundle at data holding only its messages whose address starts
+    // with prefix, looking inside nested bundles, and returns the copy's size; 0, with
+    // nothing appended, if there are none
+    size_t appendFilteredBundle(const char* data, size_t size, const std::string& prefix,
+                                std::vector<char>& output, int depth = 0)
+    {
+        const size_t start = output.size();
+        bool anyMatched = false;
+
+        output.insert(output.end(), data, data + 16); // "#bundle\0" and the time tag
+
+        for (size_t position = 16; size - position >= 4;)
+        {
+            const uint32_t elementSize = OscArgument::readBigEndian32(data + position);
+            const char* element = data + position + 4;
+            position += 4;
+
+            if (elementSize > size - position)
+                break;
+
+            position += elementSize;
+
+            const size_t sizeField = output.size();
+            output.resize(sizeField + 4);
+            size_t copiedSize = 0;
+
+            if (OscPacketReader::isBundle(element, elementSize))
+            {
+                if (depth + 1 < OscPacketReader::maxBundleDepth)
+                    copiedSize = appendFilteredBundle(element, elementSize, prefix, output, depth + 1);
+            }
+            else if (elementSize >= prefix.size() && std::memcmp(element, prefix.data(), prefix.size()) == 0)
+            {
+                output.insert(output.end(), element, element + elementSize);
+                copiedSize = elementSize;
+            }
+
+            if (copiedSize == 0)
+            {
+                output.resize(sizeField);
+                continue;
+            }
+
+            for (int i = 0; i < 4; ++i)
+                output[sizeField + (size_t) i] = (char) (copiedSize >> (24 - 8 * i));
+
+            anyMatched = true;
+        }
+
+        if (!anyMatched)
+        {
+            output.resize(start);
+            return 0;
+        }
+
+        return output.size() - start;
+    }
+
+    // The part of a packet one destination gets: the packet itself (data set), or a filtered
+    // copy of a bundle at offset in a scratch buffer (data == nullptr); nothing if size is 0
+    struct Selection
+    {
+        const char* data;
+        size_t offset, size;
+    };
+
+    // address is the packet's OSC address, or for a bundle the prefix its messages share. A
+    // destination whose prefix is longer than that may still want some of a bundle's
+    // messages, so it gets a copy, appended to filtered, with just those.
+    Selection selectForPrefix(const std::string& prefix, const char* address, const char* data, size_t size,
+                              std::vector<char>& filtered)
+    {
+        if (std::strncmp(address, prefix.data(), prefix.size()) == 0)
+            return { data, 0, size };
+
+        // Every message in the bundle starts with address, so a prefix can only match some of
+        // them if it starts with address as well
+        const size_t addressLength = std::strlen(address);
+
+        if (!OscPacketReader::isBundle(data, size)
+            || prefix.size() <= addressLength
+            || std::memcmp(prefix.data(), address, addressLength) != 0)
+            return { nullptr, 0, 0 };
+
+        const size_t offset = filtered.size();
+        return { nullptr, offset, appendFilteredBundle(data, size, prefix, filtered) };
+    }
+}
+
+//==============================================================================
+juce::String AsyncOSCSender::Destination::toString() const
+{
+    if (isLocal())
+        return juce::String(transport == Transport::localStream ? "unix-stream:" : "unix:") + host
+             + (addressPrefix.isEmpty() ? juce::String() : "#" + addressPrefix);
+
+    return host + ":" + juce::String(port) + addressPrefix;
+}
+
+bool AsyncOSCSender::Destination::fromString(const juce::String& text, Destination& result)
+{
+    const auto trimmed = text.trim();
+
+    if (trimmed.startsWith("unix:") || trimmed.startsWith("unix-stream:"))
+    {
+        const auto location = trimmed.fromFirstOccurrenceOf(":", false, false);
+
+        Destination destination;
+        destination.transport = trimmed.startsWith("unix:") ? Transport::localDatagram : Transport::localStream;
+        destination.host = location.upToFirstOccurrenceOf("#", false, false);
+        destination.addressPrefix = location.fromFirstOccurrenceOf("#", false, false);
+
+        if (destination.host.isEmpty() || destination.host.getNumBytesAsUTF8() > OscLocalSocket::getMaxPathLength())
+            return false;
+
+        result = destination;
+        return true;
+    }
+
+    const auto hostAndPort = trimmed.upToFirstOccurrenceOf("/", false, false);
+    const auto portText = hostAndPort.fromLastOccurrenceOf(":", false, false);
+
+    if (!hostAndPort.containsChar(':') || portText.isEmpty() || !portText.containsOnly("0123456789"))
+        return false;
+
+    Destination destination;
+    destination.host = hostAndPort.upToLastOccurrenceOf(":", false, false);
+    destination.port = portText.getIntValue();
+    destination.addressPrefix = trimmed.fromFirstOccurrenceOf("/", true, false);
+
+    if (destination.host.isEmpty() || destination.port < 1 || destination.port > 65535)
+        return false;
+
+    result = destination;
+    return true;
+}
+
+//==============================================================================
+AsyncOSCSender::AsyncOSCSender()
+    : juce::Thread("OSC target resolver")
+{
+    startThread();
+}
+
+AsyncOSCSender::~AsyncOSCSender()
+{
+    *alive = false;
+    signalThreadShouldExit();
+    notify();
+
+    // A lookup stuck in the system resolver can take several seconds to time out
+    stopThread(10000);
+}
+
+void AsyncOSCSender::setTargets(const std::vector<Destination>& destinations)
+{
+    {
+        const juce::ScopedLock sl(targetLock);
+        targets = destinations;
+        ++targetGeneration;
+    }
+
+    {
+        // From now on packets are queued until the new destinations are resolved
+        const juce::ScopedLock sl(queueLock);
+        std::atomic_store(&activeRoutes, std::shared_ptr<RoutingTable>());
+    }
+
+    notify();
+}
+
+void AsyncOSCSender::setMulticastOptions(const MulticastOptions& options)
+{
+    const juce::ScopedLock sl(targetLock);
+    multicastOptions = options;
+}
+
+bool AsyncOSCSender::send(const juce::String& address, const char* data, size_t size)
+{
+    if (auto table = std::atomic_load(&activeRoutes))
+        return sendThroughTable(*table, address, data, size);
+
+    const juce::ScopedLock sl(queueLock);
+
+    // The worker may have swapped a table in (and flushed the queue) while we waited
+    if (auto table = std::atomic_load(&activeRoutes))
+        return sendThroughTable(*table, address, data, size);
+
+    if ((int) queuedPackets.size() >= maxQueuedPackets)
+    {
+        queuedPackets.pop_front();
+        queueDrops.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    queuedPackets.push_back({ address, std::vector<char>(data, data + size) });
+    numQueued.store((int) queuedPackets.size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool AsyncOSCSender::sendThroughTable(RoutingTable& table, const juce::String& address, const char* data, size_t size)
+{
+    const char* addressText = address.toRawUTF8();
+    thread_local std::vector<char> filtered;
+    filtered.clear();
+
+   #if JUCE_LINUX
+    // One entry per destination. The packet itself is never copied per destination; only
+    // destinations that get part of a bundle have their own copy in filtered.
+    struct Datagram
+    {
+        const sockaddr_in* address;
+        const char* data; // nullptr: at offset in filtered
+        size_t offset;
+        size_t size;
+    };
+
+    thread_local std::vector<Datagram> datagrams;
+    thread_local std::vector<iovec> payloads;
+    thread_local std::vector<mmsghdr> headers;
+    bool ok = true;
+
+    datagrams.clear();
+
+    for (auto& route : table.routes)
+    {
+        const auto selection = selectForPrefix(route.prefix, addressText, data, size, filtered);
+
+        if (selection.size == 0)
+            continue;
+
+        if (route.local != nullptr)
+        {
+            const char* bytes = selection.data != nullptr ? selection.data : filtered.data() + selection.offset;
+
+            if (sendLocal(route.destination, *route.local, bytes, selection.size))
+                datagramsSent.fetch_add(1, std::memory_order_relaxed);
+            else
+                ok = false;
+
+            continue;
+        }
+
+        datagrams.push_back({ &route.address, selection.data, selection.offset, selection.size });
+    }
+
+    // filtered has stopped growing, so pointers into it are stable from here on
+    payloads.resize(datagrams.size());
+    headers.assign(datagrams.size(), mmsghdr{});
+
+    for (size_t i = 0; i < datagrams.size(); ++i)
+    {
+        const auto& datagram = datagrams[i];
+        payloads[i].iov_base = const_cast<char*>(datagram.data != nullptr ? datagram.data : filtered.data() + datagram.offset);
+        payloads[i].iov_len = datagram.size;
+
+        auto& header = headers[i].msg_hdr;
+        header.msg_name = const_cast<sockaddr_in*>(datagram.address);
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &payloads[i];
+        header.msg_iovlen = 1;
+    }
+
+    size_t numSent = 0;
+
+    while (numSent < headers.size())
+    {
+        const int result = ::sendmmsg(table.socketHandle, headers.data() + numSent,
+                                      (unsigned int) (headers.size() - numSent), 0);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // Skip the destination that failed and carry on with the rest
+            ++numSent;
+            ok = false;
+            continue;
+        }
+
+        numSent += (size_t) result;
+        datagramsSent.fetch_add((juce::uint64) result, std::memory_order_relaxed);
+    }
+
+    return ok;
+   #else
+    bool ok = true;
+
+    for (auto& route : table.routes)
+    {
+        filtered.clear();
+        const auto selection = selectForPrefix(route.prefix, addressText, data, size, filtered);
+
+        if (selection.size == 0)
+            continue;
+
+        const char* bytes = selection.data != nullptr ? selection.data : filtered.data() + selection.offset;
+
+        if (route.local != nullptr)
+        {
+            if (sendLocal(route.destination, *route.local, bytes, selection.size))
+                datagramsSent.fetch_add(1, std::memory_order_relaxed);
+            else
+                ok = false;
+
+            continue;
+        }
+
+        if (route.socket->write(route.address, route.destination.port, bytes, (int) selection.size) == (int) selection.size)
+            datagramsSent.fetch_add(1, std::memory_order_relaxed);
+        else
+            ok = false;
+    }
+
+    return ok;
+   #endif
+}
+
+bool AsyncOSCSender::sendBatch(const BatchPacket* packets, size_t numPackets)
+{
+    if (auto table = std::atomic_load(&activeRoutes))
+        return sendBatchThroughTable(*table, packets, numPackets);
+
+    // Not connected yet: queued one by one like any other packet
+    bool ok = true;
+
+    for (size_t i = 0; i < numPackets; ++i)
+        ok = send(juce::String::fromUTF8(packets[i].address), packets[i].data, packets[i].size) && ok;
+
+    return ok;
+}
+
+bool AsyncOSCSender::sendBatchThroughTable(RoutingTable& table, const BatchPacket* packets, size_t numPackets)
+{
+   #if JUCE_LINUX
+    // One entry per sendmmsg() message: either a single packet, or segmentCount packets of
+    // segmentSize bytes (the last may be shorter) copied back to back into coalesced
+    struct Datagram
+    {
+        const sockaddr_in* address;
+        const char* data; // nullptr: at offset in coalesced
+        size_t offset;
+        size_t size;
+        size_t segmentSize;
+        size_t segmentCount;
+    };
+
+    struct alignas(cmsghdr) Control
+    {
+        char bytes[OscUdpOffload::segmentControlSpace];
+    };
+
+    thread_local std::vector<Datagram> datagrams;
+    thread_local std::vector<char> coalesced;
+    thread_local std::vector<iovec> payloads;
+    thread_local std::vector<Control> controls;
+    thread_local std::vector<mmsghdr> headers;
+
+    datagrams.clear();
+    coalesced.clear();
+
+    const bool segment = table.canSegment.load(std::memory_order_relaxed)
+                      && segmentationOffloadEnabled.load(std::memory_order_relaxed);
+    bool ok = true;
+
+    for (auto& route : table.routes)
+    {
+        if (route.local != nullptr)
+        {
+            thread_local std::vector<char> filtered;
+
+            for (size_t i = 0; i < numPackets; ++i)
+            {
+                filtered.clear();
+                const auto selection = selectForPrefix(route.prefix, packets[i].address, packets[i].data, packets[i].size, filtered);
+
+                if (selection.size == 0)
+                    continue;
+
+                if (sendLocal(route.destination, *route.local,
+                              selection.data != nullptr ? selection.data : filtered.data(), selection.size))
+                    datagramsSent.fetch_add(1, std::memory_order_relaxed);
+                else
+                    ok = false;
+            }
+
+            continue;
+        }
+
+        size_t run = datagrams.size(); // index of the open run; none while it is datagrams.size()
+
+        for (size_t i = 0; i < numPackets; ++i)
+        {
+            const auto& packet = packets[i];
+            const auto selection = selectForPrefix(route.prefix, packet.address, packet.data, packet.size, coalesced);
+
+            if (selection.size == 0)
+                continue;
+
+            // Part of a bundle, already copied to the end of coalesced, goes out on its own
+            if (selection.data == nullptr)
+            {
+                datagrams.push_back({ &route.address, nullptr, selection.offset, selection.size, selection.size, 1 });
+                run = datagrams.size();
+                continue;
+            }
+
+            if (!segment || packet.size > OscUdpOffload::maxSegmentSize)
+            {
+                datagrams.push_back({ &route.address, packet.data, 0, packet.size, 0, 1 });
+                run = datagrams.size();
+                continue;
+            }
+
+            // A run takes packets of its segment size; a shorter one ends it
+            if (run < datagrams.size())
+            {
+                const auto& open = datagrams[run];
+
+                if (packet.size > open.segmentSize
+                    || open.size % open.segmentSize != 0
+                    || open.segmentCount == OscUdpOffload::maxSegments
+                    || open.size + packet.size > OscUdpOffload::maxBufferSize)
+                    run = datagrams.size();
+            }
+
+            if (run == datagrams.size())
+                datagrams.push_back({ &route.address, nullptr, coalesced.size(), 0, packet.size, 0 });
+
+            coalesced.insert(coalesced.end(), packet.data, packet.data + packet.size);
+            datagrams[run].size += packet.size;
+            ++datagrams[run].segmentCount;
+        }
+    }
+
+    // coalesced has stopped growing, so pointers into it are stable from here on
+    payloads.resize(datagrams.size());
+    controls.resize(datagrams.size());
+    headers.assign(datagrams.size(), mmsghdr{});
+
+    for (size_t i = 0; i < datagrams.size(); ++i)
+    {
+        const auto& datagram = datagrams[i];
+        payloads[i].iov_base = const_cast<char*>(datagram.data != nullptr ? datagram.data : coalesced.data() + datagram.offset);
+        payloads[i].iov_len = datagram.size;
+
+        auto& header = headers[i].msg_hdr;
+        header.msg_name = const_cast<sockaddr_in*>(datagram.address);
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &payloads[i];
+        header.msg_iovlen = 1;
+
+        if (datagram.segmentCount > 1)
+        {
+            header.msg_control = controls[i].bytes;
+            header.msg_controllen = OscUdpOffload::writeSegmentControl(controls[i].bytes, datagram.segmentSize);
+        }
+    }
+
+    size_t numSent = 0;
+    int numRetries = 0;
+
+    while (numSent < headers.size())
+    {
+        const int result = ::sendmmsg(table.socketHandle, headers.data() + numSent,
+                                      (unsigned int) (headers.size() - numSent), 0);
+
+        if (result < 0)
+        {
+            const int error = errno;
+
+            if (error == EINTR)
+                continue;
+
+            // The socket buffer is full for the moment: wait for room instead of losing the
+            // datagram, but not for ever
+            if ((error == EAGAIN || error == EWOULDBLOCK) && numRetries < maxSendRetries)
+            {
+                ++numRetries;
+                pollfd writable { table.socketHandle, POLLOUT, 0 };
+                ::poll(&writable, 1, sendRetryTimeoutMs);
+                continue;
+            }
+
+            const auto& failed = datagrams[numSent];
+
+            // Only these mean the kernel or device cannot segment after all: send this run's
+            // packets one by one and stop segmenting through this table. Anything else, such
+            // as an unreachable network, would fail just the same without segmentation.
+            if (failed.segmentCount > 1 && (error == EIO || error == EINVAL || error == EOPNOTSUPP))
+            {
+                table.canSegment = false;
+
+                OscUdpOffload::forEachSegment(coalesced.data() + failed.offset, failed.size, failed.segmentSize,
+                    [&](const char* data, size_t size) {
+                        if (::sendto(table.socketHandle, data, size, 0,
+                                     reinterpret_cast<const sockaddr*>(failed.address), sizeof(sockaddr_in)) == (ssize_t) size)
+                            datagramsSent.fetch_add(1, std::memory_order_relaxed);
+                        else
+                            ok = false;
+                    });
+            }
+            else
+            {
+                ok = false;
+            }
+
+            // Skip the datagram that failed and carry on with the rest
+            ++numSent;
+            numRetries = 0;
+            continue;
+        }
+
+        for (int i = 0; i < result; ++i)
+            datagramsSent.fetch_add(datagrams[numSent + (size_t) i].segmentCount, std::memory_order_relaxed);
+
+        numSent += (size_t) result;
+        numRetries = 0;
+    }
+
+    return ok;
+   #else
+    bool ok = true;
+
+    for (size_t i = 0; i < numPackets; ++i)
+        ok = sendThroughTable(table, juce::String::fromUTF8(packets[i].address), packets[i].data, packets[i].size) && ok;
+
+    return ok;
+   #endif
+}
+
+bool AsyncOSCSender::sendLocal(const Destination& destination, LocalLink& link, const char* data, size_t size)
+{
+    const bool isStream = destination.transport == Destination::Transport::localStream;
+    const juce::ScopedLock sl(link.lock);
+
+    // Connected lazily, so a receiver that starts late or restarts is picked up again
+    if (!link.socket.isOpen()
+        && !link.socket.connect(destination.host.toStdString(), isStream ? OscLocalSocket::Type::stream
+                                                                         : OscLocalSocket::Type::datagram))
+        return false;
+
+    if (!isStream)
+        return link.socket.send(data, size);
+
+    thread_local std::vector<char> framed;
+    framed.clear();
+    appendFramedPacket(OscFraming::slip, data, size, framed);
+    return link.socket.send(framed.data(), framed.size());
+}
+
+std::shared_ptr<AsyncOSCSender::RoutingTable> AsyncOSCSender::createRoutingTable(const std::vector<Destination>& destinations,
+                                                                                 const juce::StringArray& addresses,
+                                                                                 const MulticastOptions& multicast)
+{
+    auto table = std::make_shared<RoutingTable>();
+
+    // Failing to set them is not fatal: groups are then reached with the system defaults
+    auto applyMulticastOptions = [&multicast](int socketHandle) {
+        if (!OscMulticast::setSendOptions(socketHandle, multicast.timeToLive,
+                                          multicast.interfaceName.toStdString(), multicast.loopback))
+            std::cerr << "Could not apply multicast options (TTL " << multicast.timeToLive << ", interface '"
+                      << multicast.interfaceName << "')" << std::endl;
+    };
+
+   #if JUCE_LINUX
+    table->socketHandle = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (table->socketHandle < 0)
+        return nullptr;
+
+    table->canSegment = OscUdpOffload::isSegmentationSupported(table->socketHandle);
+    bool multicastOptionsApplied = false;
+   #endif
+
+    for (size_t i = 0; i < destinations.size(); ++i)
+    {
+        if (addresses[(int) i].isEmpty())
+            continue;
+
+        RoutingTable::Route route;
+        route.destination = destinations[i];
+        route.prefix = destinations[i].addressPrefix.toStdString();
+
+        if (destinations[i].isLocal())
+        {
+            route.local = std::make_unique<LocalLink>();
+            table->routes.push_back(std::move(route));
+            continue;
+        }
+
+       #if JUCE_LINUX
+        route.address.sin_family = AF_INET;
+        route.address.sin_port = htons((uint16_t) destinations[i].port);
+
+        if (inet_pton(AF_INET, addresses[(int) i].toRawUTF8(), &route.address.sin_addr) != 1)
+            continue;
+
+        // One socket serves every route, so the options are set once
+        if (OscMulticast::isGroupAddress(addresses[(int) i].toStdString()) && !multicastOptionsApplied)
+        {
+            applyMulticastOptions(table->socketHandle);
+            multicastOptionsApplied = true;
+        }
+       #else
+        route.address = addresses[(int) i];
+        route.socket = std::make_unique<juce::DatagramSocket>();
+
+        if (OscMulticast::isGroupAddress(route.address.toStdString()))
+            applyMulticastOptions((int) route.socket->getRawSocketHandle());
+       #endif
+
+        table->routes.push_back(std::move(route));
+    }
+
+    return table;
+}
+
+void AsyncOSCSender::run()
+{
+    while (!threadShouldExit())
+    {
+        std::vector<Destination> destinations;
+        MulticastOptions multicast;
+        int generation;
+
+        {
+            const juce::ScopedLock sl(targetLock);
+            destinations = targets;
+            multicast = multicastOptions;
+            generation = targetGeneration;
+        }
+
+        int waitMs = -1;
+
+        if (!destinations.empty())
+        {
+            juce::StringArray addresses, connected, failed;
+            double nextExpiry = std::numeric_limits<double>::max();
+
+            for (const auto& destination : destinations)
+            {
+                // Socket paths need no lookup
+                const auto address = destination.isLocal() ? destination.host : resolve(destination.host);
+                addresses.add(address);
+
+                if (!destination.isLocal())
+                    nextExpiry = juce::jmin(nextExpiry, cache[destination.host].expiryTime);
+
+                auto description = destination.toString();
+
+                if (address.isNotEmpty() && address != destination.host)
+                    description << " (" << address << ")";
+
+                (address.isNotEmpty() ? connected : failed).add(description);
+            }
+
+            const bool isNewTarget = generation != connectedGeneration;
+
+            // New destinations, or a cached address expired and a name now points elsewhere
+            if (isNewTarget || addresses != connectedAddresses)
+            {
+                std::shared_ptr<RoutingTable> table;
+
+                if (!connected.isEmpty())
+                    table = createRoutingTable(destinations, addresses, multicast);
+
+                bool superseded;
+
+                {
+                    const juce::ScopedLock sl(targetLock);
+                    superseded = generation != targetGeneration;
+                }
+
+                if (!superseded)
+                {
+                    if (table != nullptr)
+                    {
+                        const juce::ScopedLock sl(queueLock);
+
+                        for (const auto& packet : queuedPackets)
+                            sendThroughTable(*table, packet.address, packet.data.data(), packet.data.size());
+
+                        queuedPackets.clear();
+                        numQueued.store(0, std::memory_order_relaxed);
+                        std::atomic_store(&activeRoutes, table);
+                    }
+
+                    // With nothing resolvable, keep queueing until a retry succeeds
+                    connectedGeneration = generation;
+                    connectedAddresses = addresses;
+                    notifyTargetsChanged(table != nullptr ? connected : juce::StringArray(), failed);
+                }
+            }
+
+            // Wake up again when the first cache entry expires to follow address changes;
+            // with only local sockets there is nothing to refresh
+            if (nextExpiry < std::numeric_limits<double>::max())
+                waitMs = juce::jmax(100, (int) ((nextExpiry - juce::Time::getMillisecondCounterHiRes() / 1000.0) * 1000.0));
+        }
+
+        wait(waitMs);
+    }
+}
+
+juce::String AsyncOSCSender::resolve(const juce::String& host)
+{
+    const double now = juce::Time::getMillisecondCounterHiRes() / 1000.0;
+    auto& entry = cache[host];
+
+    if (entry.expiryTime > now)
+        return entry.address;
+
+   #if JUCE_WINDOWS
+    static const bool winsockInitialised = [] { WSADATA data; return WSAStartup(MAKEWORD(2, 2), &data) == 0; }();
+    juce::ignoreUnused(winsockInitialised);
+   #endif
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    struct addrinfo* info = nullptr;
+    juce::String address;
+
+    if (getaddrinfo(host.toRawUTF8(), nullptr, &hints, &info) == 0 && info != nullptr)
+    {
+        char text[INET_ADDRSTRLEN] = {};
+        const auto* ipv4 = reinterpret_cast<const struct sockaddr_in*>(info->ai_addr);
+
+        if (inet_ntop(AF_INET, &ipv4->sin_addr, text, sizeof(text)) != nullptr)
+            address = text;
+    }
+
+    if (info != nullptr)
+        freeaddrinfo(info);
+
+    entry.address = address;
+    entry.expiryTime = now + (address.isNotEmpty() ? cacheTimeToLiveSeconds : failedLookupRetrySeconds);
+    return address;
+}
+
+void AsyncOSCSender::notifyTargetsChanged(const juce::StringArray& connected, const juce::StringArray& failed)
+{
+    juce::MessageManager::callAsync([this, isAlive = alive, connected, failed] {
+        if (*isAlive && onTargetsChanged)
+            onTargetsChanged(connected, failed);
+    });
+}
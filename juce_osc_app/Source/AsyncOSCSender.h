@@ -0,0 +1,162 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include "OscLocalSocket.h"
+
+// Sends encoded OSC packets to a list of destinations, each with an optional address-prefix
+// filter. A packet is serialised once by the caller and the same bytes go to every matching
+// destination, in a single sendmmsg() call on Linux. A destination whose prefix matches only
+// some of a bundle's messages gets a copy of the bundle holding just those.
+//
+// sendBatch() sends many packets at once: on Linux every datagram of the batch goes out in one
+// sendmmsg() call, and runs of equal-size packets for the same destination are handed to the
+// kernel as a single UDP_SEGMENT (GSO) buffer where it supports that.
+//
+// Destinations on the same machine can be reached through AF_UNIX sockets instead of UDP:
+// datagram sockets carry one packet per datagram, stream sockets SLIP-framed packets. Local
+// sockets are reconnected on the next send after their receiver restarts.
+//
+// A destination may be an IPv4 multicast group (224.0.0.0/4): one datagram then reaches every
+// receiver that joined it, instead of one send per receiver. MulticastOptions set the
+// datagrams' TTL and the interface they leave through.
+//
+// Destination host names are resolved on a background thread, so changing targets never
+// blocks the caller on DNS. Resolved addresses are cached and refreshed when their TTL
+// expires. Once every destination has been looked up, the new routing table is swapped in
+// atomically; packets sent while no table is ready are queued and flushed, in order,
+// to the new destinations.
+class AsyncOSCSender : private juce::Thread
+{
+public:
+    struct Destination
+    {
+        enum class Transport
+        {
+            udp,
+            localDatagram,
+            localStream
+        };
+
+        juce::String host;          // socket path for local transports
+        int port = 0;
+        juce::String addressPrefix; // only packets whose address starts with this; empty = all
+        Transport transport = Transport::udp;
+
+        bool isLocal() const noexcept { return transport != Transport::udp; }
+        juce::String toString() const;
+
+        // Parses "host:port" or "host:port/prefix", e.g. "10.0.0.5:9000/mixer", or a local
+        // socket as "unix:path" or "unix-stream:path", optionally followed by "#prefix",
+        // e.g. "unix:/tmp/osc.sock#/mixer"
+        static bool fromString(const juce::String& text, Destination& result);
+    };
+
+    struct MulticastOptions
+    {
+        int timeToLive = 1;         // router hops; 1 keeps datagrams on the local network
+        juce::String interfaceName; // IPv4 address or interface name; empty = routing table
+        bool loopback = true;       // subscribers on this machine receive them too
+    };
+
+    AsyncOSCSender();
+    ~AsyncOSCSender() override;
+
+    // Returns immediately; resolution happens in the background
+    void setTargets(const std::vector<Destination>& destinations);
+
+    // Takes effect with the next setTargets()
+    void setMulticastOptions(const MulticastOptions& options);
+
+    // Any thread. address is the packet's OSC address, used by the destination filters.
+    // Returns false only if the packet could neither be sent nor queued.
+    bool send(const juce::String& address, const char* data, size_t size);
+
+    struct BatchPacket
+    {
+        const char* address; // UTF-8 OSC address (or common prefix of a bundle) for the filters
+        const char* data;
+        size_t size;
+    };
+
+    // Any thread: sends the packets in order, with as few system calls as possible
+    bool sendBatch(const BatchPacket* packets, size_t numPackets);
+
+    // UDP segmentation offload for sendBatch(); on by default where the kernel supports it
+    void setSegmentationOffloadEnabled(bool enabled) noexcept { segmentationOffloadEnabled.store(enabled, std::memory_order_relaxed); }
+
+    bool isReady() const noexcept { return std::atomic_load(&activeRoutes) != nullptr; }
+    int getNumQueued() const noexcept { return numQueued.load(std::memory_order_relaxed); }
+    juce::uint64 getNumDropped() const noexcept { return queueDrops.load(std::memory_order_relaxed); }
+    juce::uint64 getNumDatagramsSent() const noexcept { return datagramsSent.load(std::memory_order_relaxed); }
+
+    // Called on the message thread when a new set of destinations has been swapped in.
+    // failed lists the destinations that could not be resolved; they receive nothing until
+    // a later lookup succeeds.
+    std::function<void(const juce::StringArray& connected, const juce::StringArray& failed)> onTargetsChanged;
+
+    static constexpr int maxQueuedPackets = 1024;
+    static constexpr double cacheTimeToLiveSeconds = 60.0;
+    static constexpr double failedLookupRetrySeconds = 5.0;
+
+    // How often, and how long each time, a batch waits for room in a full socket buffer
+    // before giving up on a datagram
+    static constexpr int maxSendRetries = 3;
+    static constexpr int sendRetryTimeoutMs = 2;
+
+private:
+    struct CachedAddress
+    {
+        juce::String address; // empty if the lookup failed
+        double expiryTime = 0.0;
+    };
+
+    struct RoutingTable;
+    struct LocalLink;
+
+    struct QueuedPacket
+    {
+        juce::String address;
+        std::vector<char> data;
+    };
+
+    void run() override;
+    juce::String resolve(const juce::String& host);
+    std::shared_ptr<RoutingTable> createRoutingTable(const std::vector<Destination>& destinations,
+                                                     const juce::StringArray& addresses,
+                                                     const MulticastOptions& multicast);
+    bool sendThroughTable(RoutingTable& table, const juce::String& address, const char* data, size_t size);
+    bool sendBatchThroughTable(RoutingTable& table, const BatchPacket* packets, size_t numPackets);
+    bool sendLocal(const Destination& destination, LocalLink& link, const char* data, size_t size);
+    void notifyTargetsChanged(const juce::StringArray& connected, const juce::StringArray& failed);
+
+    // Swapped atomically; senders take a reference so an old table lives until its last
+    // send returns
+    std::shared_ptr<RoutingTable> activeRoutes;
+
+    juce::CriticalSection queueLock;
+    std::deque<QueuedPacket> queuedPackets;
+    std::atomic<int> numQueued{0}; // written under queueLock, read without it
+    std::atomic<juce::uint64> queueDrops{0};
+    std::atomic<juce::uint64> datagramsSent{0};
+    std::atomic<bool> segmentationOffloadEnabled{true};
+
+    juce::CriticalSection targetLock;
+    std::vector<Destination> targets;
+    MulticastOptions multicastOptions;
+    int targetGeneration = 0;
+
+    // Cleared on destruction so pending notifications on the message thread become no-ops
+    std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+
+    // Worker thread only
+    std::map<juce::String, CachedAddress> cache;
+    int connectedGeneration = -1;
+    juce::StringArray connectedAddresses;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncOSCSender)
+};
@@ -0,0 +1,272 @@
+#include "AutomationLog.h"
+#include "ParameterMessages.h"
+#include <cstring>
+
+namespace
+{
+    struct LogHeader
+    {
+        char magic[4];
+        juce::uint32 version;
+        juce::uint64 schemaFingerprint;
+        juce::int64 startTimeMs; // wall clock, milliseconds since the Unix epoch
+        juce::uint64 reserved;
+    };
+
+    static_assert(sizeof(LogHeader) == 32, "LogHeader layout changed");
+
+    constexpr char logMagic[4] = { 'O', 'S', 'C', 'A' };
+    constexpr juce::uint32 logVersion = 1;
+}
+
+//==============================================================================
+AutomationRecorder::AutomationRecorder(int queueCapacity)
+    : juce::Thread("Automation recorder"),
+      mask((juce::uint64) juce::nextPowerOfTwo(juce::jmax(2, queueCapacity)) - 1),
+      cells(new Cell[(size_t) mask + 1])
+{
+    for (juce::uint64 i = 0; i <= mask; ++i)
+        cells[(size_t) i].sequence.store(i, std::memory_order_relaxed);
+
+    batch.reserve((size_t) mask + 1);
+}
+
+AutomationRecorder::~AutomationRecorder()
+{
+    stop();
+}
+
+juce::Result AutomationRecorder::start(const juce::File& file, juce::uint64 schemaFingerprint)
+{
+    stop();
+
+    file.deleteFile();
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+
+    if (stream->failedToOpen())
+        return juce::Result::fail("Could not create automation log " + file.getFullPathName());
+
+    LogHeader header{};
+    std::memcpy(header.magic, logMagic, sizeof(logMagic));
+    header.version = logVersion;
+    header.schemaFingerprint = schemaFingerprint;
+    header.startTimeMs = juce::Time::currentTimeMillis();
+    stream->write(&header, sizeof(header));
+
+    output = std::move(stream);
+    numRecorded.store(0, std::memory_order_relaxed);
+    numDropped.store(0, std::memory_order_relaxed);
+    startTime = std::chrono::steady_clock::now();
+
+    recording.store(true, std::memory_order_release);
+    startThread();
+    return juce::Result::ok();
+}
+
+void AutomationRecorder::stop()
+{
+    if (output == nullptr)
+        return;
+
+    recording.store(false, std::memory_order_seq_cst);
+
+    // Only ever a push or two, so spinning is cheaper than anything that blocks
+    while (numInFlight.load(std::memory_order_acquire) != 0)
+        juce::Thread::yield();
+
+    signalThreadShouldExit();
+    notify();
+    stopThread(5000);
+
+    drain();
+    output->flush();
+    output.reset();
+}
+
+void AutomationRecorder::push(int parameterIndex, float value, bool outgoing) noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    auto position = enqueuePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    for (;;)
+    {
+        cell = &cells[(size_t) (position & mask)];
+        const auto sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto difference = (juce::int64) (sequence - position);
+
+        if (difference == 0)
+        {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // Full: the writer thread has fallen a whole queue behind
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->event.timeNs = (juce::uint64) std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime).count();
+    cell->event.parameter = (juce::uint32) parameterIndex | (outgoing ? AutomationEvent::outgoingFlag : 0u);
+    cell->event.value = value;
+    cell->sequence.store(position + 1, std::memory_order_release);
+}
+
+int AutomationRecorder::drain()
+{
+    batch.clear();
+
+    for (;;)
+    {
+        auto& cell = cells[(size_t) (dequeuePosition & mask)];
+
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+            break;
+
+        batch.push_back(cell.event);
+        cell.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+        ++dequeuePosition;
+    }
+
+    if (!batch.empty())
+    {
+        output->write(batch.data(), batch.size() * sizeof(AutomationEvent));
+        numRecorded.fetch_add(batch.size(), std::memory_order_relaxed);
+    }
+
+    return (int) batch.size();
+}
+
+void AutomationRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        drain();
+        wait(10);
+    }
+}
+
+//==============================================================================
+AutomationPlayer::AutomationPlayer(std::shared_ptr<const ParameterSchema> schemaToUse, size_t maxPacketSizeToUse,
+                                   PacketSink packetSinkToUse, EventSink eventSinkToUse)
+    : juce::Thread("Automation player"),
+      schema(std::move(schemaToUse)),
+      maxPacketSize(maxPacketSizeToUse),
+      packetSink(std::move(packetSinkToUse)),
+      eventSink(std::move(eventSinkToUse))
+{
+}
+
+AutomationPlayer::~AutomationPlayer()
+{
+    stop();
+}
+
+juce::Result AutomationPlayer::start(const juce::File& file)
+{
+    stop();
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+    if (mapped->getData() == nullptr || mapped->getSize() < sizeof(LogHeader))
+        return juce::Result::fail("Could not open automation log " + file.getFullPathName());
+
+    const auto& header = *static_cast<const LogHeader*>(mapped->getData());
+
+    if (std::memcmp(header.magic, logMagic, sizeof(logMagic)) != 0 || header.version != logVersion)
+        return juce::Result::fail(file.getFullPathName() + " is not an automation log");
+
+    if (header.schemaFingerprint != schema->getFingerprint())
+        return juce::Result::fail(file.getFullPathName() + " was recorded with a different parameter schema");
+
+    mappedFile = std::move(mapped);
+    events = reinterpret_cast<const AutomationEvent*>(static_cast<const char*>(mappedFile->getData()) + sizeof(LogHeader));
+    numEvents = (mappedFile->getSize() - sizeof(LogHeader)) / sizeof(AutomationEvent);
+
+    numPlayed.store(0, std::memory_order_relaxed);
+    maxLatenessMs.store(0.0, std::memory_order_relaxed);
+    playing.store(true, std::memory_order_relaxed);
+    startThread();
+    return juce::Result::ok();
+}
+
+void AutomationPlayer::stop()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+
+    playing.store(false, std::memory_order_relaxed);
+    mappedFile.reset();
+    events = nullptr;
+    numEvents = 0;
+}
+
+void AutomationPlayer::run()
+{
+    OscBundlePacker packer(maxPacketSize, [this](std::string_view prefix, const char* data, size_t size) {
+        packetSink(juce::String::fromUTF8(prefix.data(), (int) prefix.size()), data, size);
+    });
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const double startUnixMs = (double) juce::Time::currentTimeMillis();
+    const double firstEventMs = numEvents > 0 ? (double) events[0].timeNs / 1.0e6 : 0.0;
+    double lateness = 0.0;
+    double previousEventMs = 0.0;
+    size_t next = 0;
+
+    while (next < numEvents && !threadShouldExit())
+    {
+        const double nowMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        const double horizonMs = nowMs + lookaheadMs;
+
+        // Everything due within the lookahead goes out now, each event tagged with the time it
+        // should take effect: its recorded offset plus the lookahead, from the start of playback
+        for (; next < numEvents; ++next)
+        {
+            // Threads stamp events before queueing them, so they can be logged slightly out
+            // of order. Times never go backwards here, so no bundle nested in the packer's
+            // outer bundle is tagged earlier than it.
+            const auto& event = events[next];
+            const double eventMs = juce::jmax(previousEventMs, (double) event.timeNs / 1.0e6 - firstEventMs);
+
+            if (eventMs > horizonMs)
+                break;
+
+            previousEventMs = eventMs;
+            const int index = (int) (event.parameter & ~AutomationEvent::outgoingFlag);
+
+            if (!juce::isPositiveAndBelow(index, schema->size()))
+                continue;
+
+            lateness = juce::jmax(lateness, nowMs - (eventMs + lookaheadMs));
+
+            ParameterMessages::add(packer, (*schema)[index], event.value,
+                                   OscPacketWriter::timeTagFromUnixMilliseconds(startUnixMs + lookaheadMs + eventMs));
+
+            if (eventSink)
+                eventSink(index, event.value);
+        }
+
+        packer.flush();
+        numPlayed.store(next, std::memory_order_relaxed);
+        maxLatenessMs.store(lateness, std::memory_order_relaxed);
+        playbackSeconds.store(nowMs / 1000.0, std::memory_order_relaxed);
+
+        if (next < numEvents)
+        {
+            // Sleep until the next event enters the lookahead window, but wake at least every
+            // few milliseconds to keep bundles small
+            const double nextEventMs = (double) events[next].timeNs / 1.0e6 - firstEventMs;
+            wait(juce::jlimit(1, 5, (int) (nextEventMs - horizonMs)));
+        }
+    }
+
+    playing.store(false, std::memory_order_relaxed);
+}
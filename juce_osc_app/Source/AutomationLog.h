@@ -0,0 +1,131 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include "OscBundlePacker.h"
+#include "ParameterSchema.h"
+
+// Automation log file: a 32-byte header followed by fixed-size events in the order they
+// were recorded, all in native byte order. Events are only ever appended.
+struct AutomationEvent
+{
+    juce::uint64 timeNs;        // since the start of the recording
+    juce::uint32 parameter;     // parameter index; the top bit marks outgoing changes
+    float value;
+
+    static constexpr juce::uint32 outgoingFlag = 0x80000000u;
+};
+
+static_assert(sizeof(AutomationEvent) == 16, "AutomationEvent layout changed");
+
+// Records parameter changes from any thread into an automation log. record() only pushes
+// the event onto a bounded lock-free queue; a writer thread appends queued events to the
+// file in batches, so neither the network thread nor the UI ever waits on disk.
+class AutomationRecorder : private juce::Thread
+{
+public:
+    explicit AutomationRecorder(int queueCapacity = 1 << 16);
+    ~AutomationRecorder() override;
+
+    juce::Result start(const juce::File& file, juce::uint64 schemaFingerprint);
+
+    // Writes the remaining queued events and closes the file
+    void stop();
+    bool isRecording() const noexcept { return recording.load(std::memory_order_relaxed); }
+
+    // Any thread; does nothing unless recording. Events that don't fit in the queue are dropped.
+    void record(int parameterIndex, float value, bool outgoing) noexcept
+    {
+        if (!recording.load(std::memory_order_acquire))
+            return;
+
+        // stop() waits for every call that still saw recording set, so none of them can
+        // push after the final drain
+        numInFlight.fetch_add(1, std::memory_order_seq_cst);
+
+        if (recording.load(std::memory_order_seq_cst))
+            push(parameterIndex, value, outgoing);
+
+        numInFlight.fetch_sub(1, std::memory_order_release);
+    }
+
+    juce::uint64 getNumRecorded() const noexcept { return numRecorded.load(std::memory_order_relaxed); }
+    juce::uint64 getNumDropped() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+private:
+    // Cells of a bounded multi-producer queue; sequence tells producers and the consumer
+    // whose turn it is to use the cell
+    struct Cell
+    {
+        std::atomic<juce::uint64> sequence;
+        AutomationEvent event;
+    };
+
+    void push(int parameterIndex, float value, bool outgoing) noexcept;
+    int drain();
+    void run() override;
+
+    const juce::uint64 mask;
+    std::unique_ptr<Cell[]> cells;
+    std::atomic<juce::uint64> enqueuePosition{0};
+    juce::uint64 dequeuePosition = 0;
+
+    std::atomic<bool> recording{false};
+    std::atomic<int> numInFlight{0};
+    std::chrono::steady_clock::time_point startTime; // published by the store to recording
+    std::unique_ptr<juce::FileOutputStream> output;
+    std::vector<AutomationEvent> batch;
+
+    std::atomic<juce::uint64> numRecorded{0};
+    std::atomic<juce::uint64> numDropped{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutomationRecorder)
+};
+
+// Plays an automation log back on its own thread. Events are sent lookaheadMs before they
+// are due, inside bundles whose time tags carry the exact recorded timing, so receivers that
+// honour time tags reproduce the movement without network or scheduling jitter.
+class AutomationPlayer : private juce::Thread
+{
+public:
+    using PacketSink = std::function<void(const juce::String& addressPrefix, const char* data, size_t size)>;
+    using EventSink = std::function<void(int parameterIndex, float value)>;
+
+    AutomationPlayer(std::shared_ptr<const ParameterSchema> schemaToUse, size_t maxPacketSize,
+                     PacketSink packetSinkToUse, EventSink eventSinkToUse);
+    ~AutomationPlayer() override;
+
+    juce::Result start(const juce::File& file);
+    void stop();
+    bool isPlaying() const noexcept { return playing.load(std::memory_order_relaxed); }
+
+    // Statistics of the current or last playback. Lateness is how far past its time tag the
+    // latest event was sent; 0 means every event left before it was due.
+    juce::uint64 getNumEventsPlayed() const noexcept { return numPlayed.load(std::memory_order_relaxed); }
+    double getPlaybackSeconds() const noexcept { return playbackSeconds.load(std::memory_order_relaxed); }
+    double getMaxLatenessMs() const noexcept { return maxLatenessMs.load(std::memory_order_relaxed); }
+
+    static constexpr double lookaheadMs = 20.0;
+
+private:
+    void run() override;
+
+    std::shared_ptr<const ParameterSchema> schema;
+    const size_t maxPacketSize;
+    PacketSink packetSink;
+    EventSink eventSink;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const AutomationEvent* events = nullptr;
+    size_t numEvents = 0;
+
+    std::atomic<bool> playing{false};
+    std::atomic<juce::uint64> numPlayed{0};
+    std::atomic<double> playbackSeconds{0.0};
+    std::atomic<double> maxLatenessMs{0.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutomationPlayer)
+};
@@ -0,0 +1,928 @@
+#include "Benchmarks.h"
+#include <juce_osc/juce_osc.h>
+#include "AsyncOSCSender.h"
+#include "LatencyHistogram.h"
+#include "OSCEngine.h"
+#include "OscLocalSocket.h"
+#include "OscMulticast.h"
+#include "OscPacketReader.h"
+#include "OscPacketWriter.h"
+#include "OscSharedRing.h"
+#include "OscStreamFraming.h"
+#include "OscUdpOffload.h"
+#include "ParameterSmoother.h"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    // Bound but never read: once a socket buffer is full the kernel drops further datagrams,
+    // which keeps the measurement on the sending side
+    std::vector<std::unique_ptr<juce::DatagramSocket>> createReceivers(int count)
+    {
+        std::vector<std::unique_ptr<juce::DatagramSocket>> receivers;
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto socket = std::make_unique<juce::DatagramSocket>();
+
+            if (socket->bindToPort(0, "127.0.0.1"))
+                receivers.push_back(std::move(socket));
+        }
+
+        return receivers;
+    }
+
+    // Reads datagrams until none arrives for timeoutMs and counts the messages in them, those
+    // whose address starts with prefix and those whose address doesn't
+    void receiveMessages(juce::DatagramSocket& socket, int timeoutMs, std::string_view prefix,
+                         int& numInside, int& numOutside)
+    {
+        char buffer[65536];
+        numInside = numOutside = 0;
+
+        while (socket.waitUntilReady(true, timeoutMs) > 0)
+        {
+            const int bytesRead = socket.read(buffer, (int) sizeof(buffer), false);
+
+            if (bytesRead <= 0)
+                break;
+
+            OscPacketReader::forEachMessage(buffer, (size_t) bytesRead, [&](const OscMessageView& message, uint64_t) {
+                if (message.getAddress().substr(0, prefix.size()) == prefix)
+                    ++numInside;
+                else
+                    ++numOutside;
+            });
+        }
+    }
+
+    std::shared_ptr<ParameterSchema> createBenchmarkSchema(int numParameters)
+    {
+        auto schema = std::make_shared<ParameterSchema>();
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            ParameterSpec spec;
+            spec.address = "/bench/" + juce::String(i);
+            spec.label = spec.address;
+            schema->add(spec);
+        }
+
+        return schema;
+    }
+
+    struct Result
+    {
+        double elapsedSeconds = 0.0;
+        double messagesPerSecond = 0.0;
+        double datagramsPerSecond = 0.0;
+    };
+
+    template <typename SendFunction>
+    Result measure(double seconds, SendFunction&& sendOne)
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        const double end = start + seconds * 1000.0;
+        double now = start;
+        juce::uint64 messages = 0;
+        float value = 0.0f;
+
+        while (now < end)
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                sendOne(value);
+                value = value < 1.0f ? value + 0.001f : 0.0f;
+                ++messages;
+            }
+
+            now = juce::Time::getMillisecondCounterHiRes();
+        }
+
+        Result result;
+        result.elapsedSeconds = (now - start) / 1000.0;
+        result.messagesPerSecond = (double) messages / result.elapsedSeconds;
+        return result;
+    }
+
+    Result runFanOutSender(const std::vector<std::unique_ptr<juce::DatagramSocket>>& receivers, double seconds)
+    {
+        std::vector<AsyncOSCSender::Destination> destinations;
+
+        for (const auto& receiver : receivers)
+            destinations.push_back({ "127.0.0.1", receiver->getBoundPort(), {} });
+
+        AsyncOSCSender sender;
+        sender.setTargets(destinations);
+
+        for (int waited = 0; !sender.isReady() && waited < 5000; ++waited)
+            juce::Thread::sleep(1);
+
+        OscPacketWriter writer;
+        const auto startCount = sender.getNumDatagramsSent();
+
+        auto result = measure(seconds, [&](float value) {
+            writer.clear();
+            writer.beginMessage("/knob", "f");
+            writer.addFloat32(value);
+            writer.endMessage();
+            sender.send("/knob", writer.data(), writer.size());
+        });
+
+        result.datagramsPerSecond = (double) (sender.getNumDatagramsSent() - startCount) / result.elapsedSeconds;
+        return result;
+    }
+
+    Result runPerTargetSenders(const std::vector<std::unique_ptr<juce::DatagramSocket>>& receivers, double seconds)
+    {
+        std::vector<std::unique_ptr<juce::OSCSender>> senders;
+
+        for (const auto& receiver : receivers)
+        {
+            senders.push_back(std::make_unique<juce::OSCSender>());
+            senders.back()->connect("127.0.0.1", receiver->getBoundPort());
+        }
+
+        juce::uint64 datagrams = 0;
+
+        auto result = measure(seconds, [&](float value) {
+            const juce::OSCMessage message(juce::OSCAddressPattern("/knob"), value);
+
+            for (auto& sender : senders)
+                if (sender->send(message))
+                    ++datagrams;
+        });
+
+        result.datagramsPerSecond = (double) datagrams / result.elapsedSeconds;
+        return result;
+    }
+}
+
+void Benchmarks::runFanOut(double secondsPerRun)
+{
+    std::cout << "Fan-out benchmark, " << secondsPerRun << " s per run, loopback destinations" << std::endl;
+
+    for (const int numTargets : { 1, 8, 64 })
+    {
+        const auto receivers = createReceivers(numTargets);
+
+        if ((int) receivers.size() != numTargets)
+        {
+            std::cerr << "ERROR: Could not bind " << numTargets << " loopback receivers" << std::endl;
+            return;
+        }
+
+        const auto fanOut = runFanOutSender(receivers, secondsPerRun);
+        const auto perTarget = runPerTargetSenders(receivers, secondsPerRun);
+
+        std::cout << "  " << juce::String(numTargets).paddedLeft(' ', 2) << " targets: "
+                  << "fan-out " << juce::String(fanOut.messagesPerSecond, 0) << " msg/s ("
+                  << juce::String(fanOut.datagramsPerSecond, 0) << " datagrams/s), "
+                  << "per-target OSCSender " << juce::String(perTarget.messagesPerSecond, 0) << " msg/s ("
+                  << juce::String(perTarget.datagramsPerSecond, 0) << " datagrams/s), "
+                  << juce::String(fanOut.messagesPerSecond / juce::jmax(1.0, perTarget.messagesPerSecond), 2)
+                  << "x" << std::endl;
+    }
+}
+
+void Benchmarks::runPresetRecall(int numParameters, int numIterations)
+{
+    auto schema = createBenchmarkSchema(numParameters);
+
+    // The second receiver mirrors only /bench/1, /bench/10 and so on, a part of every recall
+    const auto receivers = createReceivers(2);
+    const char* const mirrorPrefix = "/bench/1";
+    const auto presetFile = juce::File::createTempFile(".bin");
+
+    if (receivers.size() != 2)
+    {
+        std::cerr << "ERROR: Could not bind 2 loopback receivers" << std::endl;
+        return;
+    }
+
+    {
+        OSCEngine engine(schema);
+        engine.setTarget("127.0.0.1", receivers[0]->getBoundPort());
+        engine.setMirrorTargets({ "127.0.0.1:" + juce::String(receivers[1]->getBoundPort()) + mirrorPrefix });
+        engine.applyConfiguration();
+
+        for (int waited = 0; !engine.isSenderReady() && waited < 5000; ++waited)
+            juce::Thread::sleep(1);
+
+        auto result = engine.openPresets(presetFile);
+
+        if (result.failed())
+        {
+            std::cerr << "ERROR: " << result.getErrorMessage() << std::endl;
+            return;
+        }
+
+        std::vector<float> current((size_t) numParameters, 0.0f);
+        std::vector<float> preset;
+        std::vector<int> changed;
+
+        std::cout << "Preset recall benchmark, " << numParameters << " parameters, "
+                  << numIterations << " recalls each" << std::endl;
+
+        for (const int changedPercent : { 1, 10, 100 })
+        {
+            preset = current;
+            const int step = 100 / changedPercent;
+
+            for (int i = 0; i < numParameters; i += step)
+                preset[(size_t) i] = 0.5f;
+
+            engine.getPresets().store(0, "bench", preset.data());
+
+            int numChanged = 0;
+            const double start = juce::Time::getMillisecondCounterHiRes();
+
+            // current is left untouched, so every iteration sends the same diff
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+                numChanged = engine.recallPreset(0, current.data(), changed);
+
+            const double averageMs = (juce::Time::getMillisecondCounterHiRes() - start) / numIterations;
+
+            // One more recall, with the mirror's backlog from the timed ones discarded first
+            int numInside, numOutside;
+            receiveMessages(*receivers[1], 0, mirrorPrefix, numInside, numOutside);
+
+            const int numBundles = engine.sendParameters(changed.data(), numChanged, preset.data());
+            const auto numExpected = std::count_if(changed.begin(), changed.begin() + numChanged, [&](int index) {
+                return (*schema)[index].address.startsWith(mirrorPrefix);
+            });
+
+            receiveMessages(*receivers[1], 200, mirrorPrefix, numInside, numOutside);
+
+            std::cout << "  " << juce::String(changedPercent).paddedLeft(' ', 3) << "% changed: "
+                      << numChanged << " parameters in " << numBundles << " bundles, "
+                      << juce::String(averageMs, 3) << " ms per recall, "
+                      << numInside << " of them to the " << mirrorPrefix << " mirror" << std::endl;
+
+            if (numInside != (int) numExpected || numOutside != 0)
+                std::cerr << "ERROR: The " << mirrorPrefix << " mirror received " << numInside << " of "
+                          << numExpected << " messages and " << numOutside << " others" << std::endl;
+        }
+    }
+
+    presetFile.deleteFile();
+}
+
+void Benchmarks::runAutomation(int eventsPerSecond, int numParameters)
+{
+    auto schema = createBenchmarkSchema(numParameters);
+    const auto receivers = createReceivers(1);
+    const auto logFile = juce::File::createTempFile(".osclog");
+
+    std::cout << "Automation benchmark, " << eventsPerSecond << " events/s over "
+              << numParameters << " parameters" << std::endl;
+
+    // Record one second of evenly paced changes from this thread
+    {
+        AutomationRecorder recorder;
+        auto result = recorder.start(logFile, schema->getFingerprint());
+
+        if (result.failed())
+        {
+            std::cerr << "ERROR: " << result.getErrorMessage() << std::endl;
+            return;
+        }
+
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        int numEvents = 0;
+
+        while (numEvents < eventsPerSecond)
+        {
+            const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - start;
+            const int due = juce::jmin(eventsPerSecond, (int) (elapsedMs * eventsPerSecond / 1000.0));
+
+            for (; numEvents < due; ++numEvents)
+                recorder.record(numEvents % numParameters, (float) (numEvents % 100) / 100.0f, false);
+        }
+
+        recorder.stop();
+        std::cout << "  recorded " << recorder.getNumRecorded() << " events ("
+                  << recorder.getNumDropped() << " dropped), "
+                  << logFile.getSize() / 1024 << " KiB" << std::endl;
+    }
+
+    {
+        OSCEngine engine(schema);
+        engine.setTarget("127.0.0.1", receivers.empty() ? 7770 : receivers[0]->getBoundPort());
+        engine.applyConfiguration();
+
+        for (int waited = 0; !engine.isSenderReady() && waited < 5000; ++waited)
+            juce::Thread::sleep(1);
+
+        const auto packetsBefore = engine.getNumMessagesSent();
+        auto result = engine.startPlayback(logFile);
+
+        if (result.failed())
+        {
+            std::cerr << "ERROR: " << result.getErrorMessage() << std::endl;
+            return;
+        }
+
+        while (engine.isPlaying())
+            juce::Thread::sleep(10);
+
+        const auto& player = engine.getPlayer();
+        const double seconds = juce::jmax(0.001, player.getPlaybackSeconds());
+
+        std::cout << "  played " << player.getNumEventsPlayed() << " events in "
+                  << juce::String(seconds, 3) << " s ("
+                  << juce::String((double) player.getNumEventsPlayed() / seconds, 0) << " events/s) as "
+                  << (engine.getNumMessagesSent() - packetsBefore) << " bundles, max lateness "
+                  << juce::String(player.getMaxLatenessMs(), 3) << " ms" << std::endl;
+    }
+
+    logFile.deleteFile();
+}
+
+void Benchmarks::runSmoothing(int numParameters, int numFrames)
+{
+    std::cout << "Smoothing benchmark, " << numParameters << " parameters, "
+              << numFrames << " frames of 16.7 ms" << std::endl;
+
+    const std::pair<ParameterSpec::Smoothing, const char*> modes[] = {
+        { ParameterSpec::Smoothing::linear, "linear" },
+        { ParameterSpec::Smoothing::onePole, "onepole" },
+        { ParameterSpec::Smoothing::interpolate, "interpolate" }
+    };
+
+    for (const auto& mode : modes)
+    {
+        ParameterSchema schema;
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            ParameterSpec spec;
+            spec.address = "/bench/" + juce::String(i);
+            spec.smoothing = mode.first;
+            spec.smoothingMs = 100.0f;
+            schema.add(spec);
+        }
+
+        ParameterSmoother smoother(schema);
+        juce::Random random(1);
+        juce::int64 ticks = juce::Time::getHighResolutionTicks();
+        const auto ticksPerMs = juce::Time::getHighResolutionTicksPerSecond() / 1000;
+        juce::uint64 numOutputs = 0;
+        double processMs = 0.0;
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            // Every parameter gets a new value roughly every fourth frame, at jittered times
+            for (int i = frame % 4; i < numParameters; i += 4)
+                smoother.setTarget(i, random.nextFloat(), ticks + random.nextInt(16) * ticksPerMs);
+
+            ticks += 17 * ticksPerMs;
+
+            const double start = juce::Time::getMillisecondCounterHiRes();
+            smoother.process(1000.0 / 60.0, [&numOutputs](int, float) { ++numOutputs; });
+            processMs += juce::Time::getMillisecondCounterHiRes() - start;
+        }
+
+        std::cout << "  " << juce::String(mode.second).paddedRight(' ', 11) << ": "
+                  << juce::String(processMs * 1000.0 / numFrames, 1) << " us per frame, "
+                  << juce::String((double) numOutputs / numFrames, 0) << " outputs per frame" << std::endl;
+    }
+}
+
+namespace
+{
+    // Two connected endpoints of one transport; end 0 is the client, end 1 the server.
+    // receive() waits up to timeoutMs and calls onPacket for every packet that arrived.
+    class Link
+    {
+    public:
+        virtual ~Link() = default;
+        virtual bool send(int end, const char* data, size_t size) = 0;
+        virtual void receive(int end, int timeoutMs, const std::function<void(const char*, size_t)>& onPacket) = 0;
+
+        std::vector<char> buffers[2] { std::vector<char>(65536), std::vector<char>(65536) };
+    };
+
+    class UdpLink : public Link
+    {
+    public:
+        bool open()
+        {
+            return sockets[0].bindToPort(0, "127.0.0.1") && sockets[1].bindToPort(0, "127.0.0.1");
+        }
+
+        bool send(int end, const char* data, size_t size) override
+        {
+            return sockets[end].write("127.0.0.1", sockets[1 - end].getBoundPort(), data, (int) size) == (int) size;
+        }
+
+        void receive(int end, int timeoutMs, const std::function<void(const char*, size_t)>& onPacket) override
+        {
+            if (sockets[end].waitUntilReady(true, timeoutMs) <= 0)
+                return;
+
+            const int bytesRead = sockets[end].read(buffers[end].data(), (int) buffers[end].size(), false);
+
+            if (bytesRead > 0)
+                onPacket(buffers[end].data(), (size_t) bytesRead);
+        }
+
+    private:
+        juce::DatagramSocket sockets[2] { juce::DatagramSocket(false), juce::DatagramSocket(false) };
+    };
+
+    class LocalDatagramLink : public Link
+    {
+    public:
+        bool open(const juce::File& directory)
+        {
+            for (int end = 0; end < 2; ++end)
+                paths[end] = directory.getChildFile("end" + juce::String(end) + ".sock").getFullPathName().toStdString();
+
+            return receivers[0].bind(paths[0], OscLocalSocket::Type::datagram)
+                && receivers[1].bind(paths[1], OscLocalSocket::Type::datagram)
+                && senders[0].connect(paths[1], OscLocalSocket::Type::datagram)
+                && senders[1].connect(paths[0], OscLocalSocket::Type::datagram);
+        }
+
+        bool send(int end, const char* data, size_t size) override
+        {
+            return senders[end].send(data, size);
+        }
+
+        void receive(int end, int timeoutMs, const std::function<void(const char*, size_t)>& onPacket) override
+        {
+            const int bytesRead = receivers[end].read(buffers[end].data(), buffers[end].size(), timeoutMs);
+
+            if (bytesRead > 0)
+                onPacket(buffers[end].data(), (size_t) bytesRead);
+        }
+
+    private:
+        std::string paths[2];
+        OscLocalSocket receivers[2], senders[2];
+    };
+
+    // SLIP-framed, as AsyncOSCSender sends to unix-stream targets
+    class LocalStreamLink : public Link
+    {
+    public:
+        bool open(const juce::File& directory)
+        {
+            const auto path = directory.getChildFile("stream.sock").getFullPathName().toStdString();
+
+            if (!listener.bind(path, OscLocalSocket::Type::stream)
+                || !sockets[0].connect(path, OscLocalSocket::Type::stream))
+                return false;
+
+            sockets[1] = listener.accept(1000);
+            return sockets[1].isOpen();
+        }
+
+        bool send(int end, const char* data, size_t size) override
+        {
+            thread_local std::vector<char> framed;
+            framed.clear();
+            appendFramedPacket(OscFraming::slip, data, size, framed);
+            return sockets[end].send(framed.data(), framed.size());
+        }
+
+        void receive(int end, int timeoutMs, const std::function<void(const char*, size_t)>& onPacket) override
+        {
+            const int bytesRead = sockets[end].read(buffers[end].data(), buffers[end].size(), timeoutMs);
+
+            if (bytesRead > 0)
+                decoders[end].feed(buffers[end].data(), (size_t) bytesRead, onPacket);
+        }
+
+    private:
+        OscLocalSocket listener, sockets[2];
+        OscStreamDecoder decoders[2] { { OscFraming::slip, 65536 }, { OscFraming::slip, 65536 } };
+    };
+
+    void runLink(const char* name, Link& link, double seconds)
+    {
+        OscPacketWriter writer;
+        writer.beginMessage("/bench/knob", "f");
+        writer.addFloat32(0.5f);
+        writer.endMessage();
+
+        // Round trips: the server end echoes every packet straight back
+        std::atomic<bool> running { true };
+        std::thread echo([&] {
+            while (running.load(std::memory_order_relaxed))
+                link.receive(1, 100, [&](const char* data, size_t size) { link.send(1, data, size); });
+        });
+
+        LatencyHistogram roundTrips;
+        const double end = juce::Time::getMillisecondCounterHiRes() + seconds * 500.0;
+
+        while (juce::Time::getMillisecondCounterHiRes() < end)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            bool answered = false;
+
+            link.send(0, writer.data(), writer.size());
+
+            while (!answered)
+            {
+                link.receive(0, 1000, [&](const char*, size_t) { answered = true; });
+
+                if (!answered && juce::Time::getMillisecondCounterHiRes() > end + 1000.0)
+                    break;
+            }
+
+            roundTrips.record(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0);
+        }
+
+        running = false;
+        echo.join();
+
+        // Throughput: one-way, as fast as the sender can go; the receiver counts what arrives
+        std::atomic<juce::uint64> received { 0 };
+        running = true;
+
+        std::thread counter([&] {
+            while (running.load(std::memory_order_relaxed))
+                link.receive(1, 100, [&](const char*, size_t) { received.fetch_add(1, std::memory_order_relaxed); });
+        });
+
+        const auto result = measure(seconds * 0.5, [&](float) { link.send(0, writer.data(), writer.size()); });
+
+        juce::Thread::sleep(100); // let the receiver drain what is still queued
+        running = false;
+        counter.join();
+
+        const auto snapshot = roundTrips.getSnapshot();
+
+        std::cout << "  " << juce::String(name).paddedRight(' ', 18) << ": round trip p50 "
+                  << juce::String(snapshot.getPercentileMs(0.5) * 1000.0, 1) << " us, p99 "
+                  << juce::String(snapshot.getPercentileMs(0.99) * 1000.0, 1) << " us ("
+                  << snapshot.getTotal() << " round trips); "
+                  << juce::String(result.messagesPerSecond, 0) << " msg/s sent, "
+                  << juce::String((double) received.load() / result.elapsedSeconds, 0) << " msg/s received" << std::endl;
+    }
+}
+
+void Benchmarks::runLocalTransports(double secondsPerRun)
+{
+    std::cout << "Local transport benchmark, " << secondsPerRun << " s per transport, "
+              << "half round trips and half one-way throughput" << std::endl;
+
+    {
+        UdpLink udp;
+
+        if (udp.open())
+            runLink("UDP loopback", udp, secondsPerRun);
+        else
+            std::cerr << "ERROR: Could not bind loopback UDP sockets" << std::endl;
+    }
+
+    if (!OscLocalSocket::isSupported())
+    {
+        std::cout << "  AF_UNIX sockets are not available on this platform" << std::endl;
+        return;
+    }
+
+    // Short paths: sockaddr_un only holds around 100 bytes
+    const auto directory = juce::File("/tmp").getNonexistentChildFile("osc-bench", "");
+    directory.createDirectory();
+
+    {
+        LocalDatagramLink datagram;
+
+        if (datagram.open(directory))
+            runLink("AF_UNIX datagram", datagram, secondsPerRun);
+        else
+            std::cerr << "ERROR: Could not create AF_UNIX datagram sockets" << std::endl;
+    }
+
+    {
+        LocalStreamLink stream;
+
+        if (stream.open(directory))
+            runLink("AF_UNIX stream", stream, secondsPerRun);
+        else
+            std::cerr << "ERROR: Could not create AF_UNIX stream sockets" << std::endl;
+    }
+
+    directory.deleteRecursively();
+}
+
+namespace
+{
+    struct ProducerResult
+    {
+        juce::uint64 sent = 0;
+        juce::uint64 received = 0;
+        double elapsedSeconds = 0.0;
+    };
+
+    // Runs numProducers threads calling produce() until the time is up, while consume()
+    // runs on another thread and returns how many packets it handled per call
+    ProducerResult runProducers(int numProducers, double seconds,
+                                const std::function<bool(int producer)>& produce,
+                                const std::function<size_t()>& consume)
+    {
+        std::atomic<bool> producing { true }, consuming { true };
+        std::atomic<juce::uint64> sent { 0 }, received { 0 };
+
+        std::thread consumer([&] {
+            while (consuming.load(std::memory_order_relaxed))
+                received.fetch_add(consume(), std::memory_order_relaxed);
+        });
+
+        std::vector<std::thread> producers;
+        const double start = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numProducers; ++i)
+        {
+            producers.emplace_back([&, i] {
+                juce::uint64 count = 0;
+
+                while (producing.load(std::memory_order_relaxed))
+                    count += produce(i) ? 1 : 0;
+
+                sent.fetch_add(count, std::memory_order_relaxed);
+            });
+        }
+
+        juce::Thread::sleep((int) (seconds * 1000.0));
+        producing = false;
+
+        for (auto& producer : producers)
+            producer.join();
+
+        ProducerResult result;
+        result.elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+        juce::Thread::sleep(100); // let the consumer drain what is still queued
+        consuming = false;
+        consumer.join();
+
+        result.sent = sent.load();
+        result.received = received.load();
+        return result;
+    }
+
+    void printProducerResult(const char* name, int numProducers, const ProducerResult& result)
+    {
+        std::cout << "  " << juce::String(name).paddedRight(' ', 18) << juce::String(numProducers).paddedLeft(' ', 2)
+                  << " producers: " << juce::String((double) result.sent / result.elapsedSeconds, 0) << " msg/s sent, "
+                  << juce::String((double) result.received / result.elapsedSeconds, 0) << " msg/s received" << std::endl;
+    }
+}
+
+void Benchmarks::runSharedRing(double secondsPerRun)
+{
+    std::cout << "Shared-memory ring benchmark, " << secondsPerRun << " s per run" << std::endl;
+
+    OscPacketWriter writer;
+    writer.beginMessage("/bench/knob", "f");
+    writer.addFloat32(0.5f);
+    writer.endMessage();
+
+    const std::string ringName = "/osc_bench_" + std::to_string(juce::Process::getCurrentProcessId());
+    const auto directory = juce::File("/tmp").getNonexistentChildFile("osc-bench", "");
+    directory.createDirectory();
+
+    for (int numProducers : { 1, 4, 8 })
+    {
+        OscSharedRing consumerRing, producerRing;
+
+        if (!consumerRing.create(ringName) || !producerRing.open(ringName))
+        {
+            std::cerr << "ERROR: Could not create shared-memory ring " << ringName << std::endl;
+            break;
+        }
+
+        const auto ringResult = runProducers(numProducers, secondsPerRun,
+            [&](int) { return producerRing.write(writer.data(), writer.size()); },
+            [&] {
+                const size_t count = consumerRing.drain([](const char*, size_t) {});
+
+                if (count == 0)
+                    consumerRing.waitForData(10);
+
+                return count;
+            });
+
+        printProducerResult("Shared ring", numProducers, ringResult);
+
+        OscLocalSocket receiver;
+        std::vector<OscLocalSocket> senders((size_t) numProducers);
+        const auto path = directory.getChildFile("ring.sock").getFullPathName().toStdString();
+        bool connected = receiver.bind(path, OscLocalSocket::Type::datagram);
+
+        for (auto& sender : senders)
+            connected = connected && sender.connect(path, OscLocalSocket::Type::datagram);
+
+        if (!connected)
+        {
+            std::cerr << "ERROR: Could not create AF_UNIX datagram sockets" << std::endl;
+            continue;
+        }
+
+        std::vector<char> buffer(65536);
+        const auto socketResult = runProducers(numProducers, secondsPerRun,
+            [&](int producer) { return senders[(size_t) producer].send(writer.data(), writer.size()); },
+            [&] { return receiver.read(buffer.data(), buffer.size(), 10) > 0 ? (size_t) 1 : (size_t) 0; });
+
+        printProducerResult("AF_UNIX datagram", numProducers, socketResult);
+    }
+
+    directory.deleteRecursively();
+}
+
+namespace
+{
+    // Sends one cue first and counts how many receivers got it, then sends cues for the
+    // given time and measures the process CPU time, which includes the kernel's loopback
+    // delivery to every receiver
+    void runCues(const char* name, const std::vector<std::unique_ptr<juce::DatagramSocket>>& receivers,
+                 const std::vector<AsyncOSCSender::Destination>& destinations, double seconds)
+    {
+        AsyncOSCSender sender;
+        AsyncOSCSender::MulticastOptions multicast;
+        multicast.interfaceName = "127.0.0.1";
+        sender.setMulticastOptions(multicast);
+        sender.setTargets(destinations);
+
+        for (int waited = 0; !sender.isReady() && waited < 5000; ++waited)
+            juce::Thread::sleep(1);
+
+        OscPacketWriter writer;
+        writer.beginMessage("/cue/go", "i");
+        writer.addInt32(1);
+        writer.endMessage();
+
+        sender.send("/cue/go", writer.data(), writer.size());
+
+        char buffer[256];
+        int reached = 0;
+
+        for (const auto& receiver : receivers)
+        {
+            if (receiver->waitUntilReady(true, 200) > 0 && receiver->read(buffer, (int) sizeof(buffer), false) > 0)
+                ++reached;
+        }
+
+        const auto startDatagrams = sender.getNumDatagramsSent();
+        const std::clock_t startCpu = std::clock();
+
+        const auto result = measure(seconds, [&](float) { sender.send("/cue/go", writer.data(), writer.size()); });
+
+        const double cpuSeconds = (double) (std::clock() - startCpu) / CLOCKS_PER_SEC;
+        const double cues = result.messagesPerSecond * result.elapsedSeconds;
+
+        std::cout << "  " << juce::String(name).paddedRight(' ', 10) << ": reached " << reached << "/" << (int) receivers.size()
+                  << " subscribers, " << juce::String(cpuSeconds * 1.0e6 / cues, 2) << " us CPU per cue, "
+                  << juce::String(result.messagesPerSecond, 0) << " cues/s, "
+                  << juce::String((double) (sender.getNumDatagramsSent() - startDatagrams) / result.elapsedSeconds, 0)
+                  << " datagrams/s" << std::endl;
+    }
+}
+
+void Benchmarks::runMulticast(int numSubscribers, double secondsPerRun)
+{
+    std::cout << "Multicast benchmark, " << numSubscribers << " loopback subscribers, "
+              << secondsPerRun << " s per run" << std::endl;
+
+    {
+        const auto receivers = createReceivers(numSubscribers);
+        std::vector<AsyncOSCSender::Destination> destinations;
+
+        for (const auto& receiver : receivers)
+            destinations.push_back({ "127.0.0.1", receiver->getBoundPort(), {} });
+
+        runCues("Unicast", receivers, destinations, secondsPerRun);
+    }
+
+    // Every subscriber binds the same port, as separate stage nodes on one machine would
+    const juce::String group = "239.255.77.70";
+    std::vector<std::unique_ptr<juce::DatagramSocket>> subscribers;
+    int port = 0;
+
+    for (int i = 0; i < numSubscribers; ++i)
+    {
+        auto socket = std::make_unique<juce::DatagramSocket>();
+        socket->setEnablePortReuse(true);
+
+        if (!socket->bindToPort(port)
+            || !OscMulticast::joinGroup((int) socket->getRawSocketHandle(), group.toStdString(), "127.0.0.1"))
+        {
+            std::cerr << "ERROR: Could not subscribe to " << group << " on the loopback interface" << std::endl;
+            return;
+        }
+
+        port = socket->getBoundPort();
+        subscribers.push_back(std::move(socket));
+    }
+
+    runCues("Multicast", subscribers, { { group, port, {} } }, secondsPerRun);
+}
+
+void Benchmarks::runUdpOffload(double secondsPerRun)
+{
+    constexpr size_t batchSize = 64;
+
+    std::cout << "UDP offload benchmark, " << secondsPerRun << " s per run, batches of "
+              << (int) batchSize << " messages to a loopback receiver" << std::endl;
+
+    juce::DatagramSocket receiver;
+
+    if (!receiver.bindToPort(0, "127.0.0.1"))
+    {
+        std::cerr << "ERROR: Could not bind loopback UDP socket" << std::endl;
+        return;
+    }
+
+    const int receiverHandle = (int) receiver.getRawSocketHandle();
+    const bool coalescing = OscUdpOffload::enableReceiveCoalescing(receiverHandle);
+    std::cout << "  Receive coalescing (GRO): " << (coalescing ? "enabled" : "unavailable") << std::endl;
+
+    // Equal-size messages, as a bulk stream of one parameter type produces
+    std::vector<std::vector<char>> messages;
+    std::vector<AsyncOSCSender::BatchPacket> batch;
+
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+        OscPacketWriter writer;
+        writer.beginMessage("/stream/" + std::to_string(10 + i), "f");
+        writer.addFloat32((float) i / batchSize);
+        writer.endMessage();
+        messages.emplace_back(writer.data(), writer.data() + writer.size());
+    }
+
+    for (const auto& message : messages)
+        batch.push_back({ "/stream", message.data(), message.size() });
+
+    const juce::String streamAddress("/stream");
+    const std::pair<const char*, int> modes[] { { "sendto", 0 }, { "sendmmsg", 1 }, { "UDP_SEGMENT", 2 } };
+
+    for (const auto& mode : modes)
+    {
+        AsyncOSCSender sender;
+        sender.setSegmentationOffloadEnabled(mode.second == 2);
+        sender.setTargets({ { "127.0.0.1", receiver.getBoundPort(), {} } });
+
+        for (int waited = 0; !sender.isReady() && waited < 5000; ++waited)
+            juce::Thread::sleep(1);
+
+        std::atomic<bool> running { true };
+        std::atomic<juce::uint64> received { 0 }, receiveCalls { 0 };
+
+        std::thread counter([&] {
+            std::vector<char> buffer(65536);
+
+            while (running.load(std::memory_order_relaxed))
+            {
+                size_t segmentSize = 0;
+                const int bytesRead = OscUdpOffload::receive(receiverHandle, buffer.data(), buffer.size(), 100, segmentSize);
+
+                if (bytesRead <= 0)
+                    continue;
+
+                receiveCalls.fetch_add(1, std::memory_order_relaxed);
+                OscUdpOffload::forEachSegment(buffer.data(), (size_t) bytesRead, segmentSize, [&](const char*, size_t) {
+                    received.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        });
+
+        const std::clock_t startCpu = std::clock();
+        juce::uint64 batches = 0;
+
+        const auto result = measure(secondsPerRun, [&](float) {
+            if (mode.second == 0)
+            {
+                for (const auto& packet : batch)
+                    sender.send(streamAddress, packet.data, packet.size);
+            }
+            else
+            {
+                sender.sendBatch(batch.data(), batch.size());
+            }
+
+            ++batches;
+        });
+
+        juce::Thread::sleep(100); // let the receiver drain what is still queued
+        running = false;
+        counter.join();
+
+        // Includes the receiving thread, which runs alongside
+        const double cpuSeconds = (double) (std::clock() - startCpu) / CLOCKS_PER_SEC;
+        const double sent = (double) batches * batchSize;
+
+        std::cout << "  " << juce::String(mode.first).paddedRight(' ', 11) << ": "
+                  << juce::String(sent / result.elapsedSeconds, 0) << " msg/s sent, "
+                  << juce::String((double) received.load() / result.elapsedSeconds, 0) << " msg/s received, "
+                  << juce::String(cpuSeconds * 1.0e9 / sent, 0) << " ns CPU per message, "
+                  << juce::String((double) received.load() / juce::jmax((juce::uint64) 1, receiveCalls.load()), 1)
+                  << " messages per receive" << std::endl;
+    }
+}
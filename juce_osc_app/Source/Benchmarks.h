@@ -0,0 +1,43 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Throughput benchmarks run from the command line; results are printed to stdout
+namespace Benchmarks
+{
+    // Sends one parameter message per iteration to 1, 8 and 64 loopback destinations,
+    // comparing AsyncOSCSender (encoded once, fanned out with sendmmsg where available)
+    // against one juce::OSCSender per destination (encoded and sent once per destination)
+    void runFanOut(double secondsPerRun);
+
+    // Recalls presets of numParameters parameters with 1%, 10% and 100% of the values changed
+    // against the current state, timing the diff plus bundle encoding and sending, and checks
+    // that a mirror target filtered on a prefix receives just its part of each recall
+    void runPresetRecall(int numParameters, int numIterations);
+
+    // Records one second of changes at eventsPerSecond spread over numParameters parameters,
+    // then plays the log back to a loopback target and reports the achieved rate and lateness
+    void runAutomation(int eventsPerSecond, int numParameters);
+
+    // Feeds numParameters smoothed parameters with new values at irregular intervals and
+    // times one 60 Hz smoothing frame for each smoothing mode
+    void runSmoothing(int numParameters, int numFrames);
+
+    // Compares loopback UDP with AF_UNIX datagram and SLIP-framed stream sockets: round-trip
+    // latency percentiles of a small message echoed back, then one-way message throughput
+    void runLocalTransports(double secondsPerRun);
+
+    // One-way throughput from 1, 4 and 8 producer threads into one consumer, through the
+    // shared-memory ring and through one AF_UNIX datagram socket for comparison
+    void runSharedRing(double secondsPerRun);
+
+    // Reaches numSubscribers loopback receivers with one cue, once as numSubscribers unicast
+    // datagrams and once as a single datagram to a multicast group they all joined, and
+    // reports the CPU time each cue costs
+    void runMulticast(int numSubscribers, double secondsPerRun);
+
+    // Streams batches of 64 equal-size messages to a loopback receiver with UDP_GRO enabled,
+    // sending one datagram per call, one sendmmsg() per batch, and one UDP_SEGMENT buffer per
+    // batch, and reports messages per second, sender CPU and packets per receive call
+    void runUdpOffload(double secondsPerRun);
+}
@@ -0,0 +1,90 @@
+#include "DatagramReceiver.h"
+
+DatagramReceiver::DatagramReceiver(PacketCallback callbackToUse)
+    : juce::Thread("OSC receiver"),
+      callback(std::move(callbackToUse)),
+      buffer((size_t) maxPacketSize)
+{
+}
+
+DatagramReceiver::~DatagramReceiver()
+{
+    stop();
+}
+
+bool DatagramReceiver::start(int port)
+{
+    stop();
+
+    socket = std::make_unique<juce::DatagramSocket>(false);
+
+    if (!socket->bindToPort(port))
+    {
+        socket.reset();
+        return false;
+    }
+
+    return startThread();
+}
+
+bool DatagramReceiver::startLocal(const std::string& path)
+{
+    stop();
+
+    if (!localSocket.bind(path, OscLocalSocket::Type::datagram))
+        return false;
+
+    return startThread();
+}
+
+void DatagramReceiver::stop()
+{
+    if (socket == nullptr && !localSocket.isOpen())
+        return;
+
+    signalThreadShouldExit();
+
+    // Wakes the thread from waitUntilReady() or read()
+    if (socket != nullptr)
+        socket->shutdown();
+
+    localSocket.shutdown();
+    stopThread(4000);
+    socket.reset();
+    localSocket.close();
+}
+
+void DatagramReceiver::run()
+{
+    if (localSocket.isOpen())
+    {
+        while (!threadShouldExit())
+        {
+            const int bytesRead = localSocket.read(buffer.data(), buffer.size(), 100);
+
+            if (bytesRead < 0)
+                break;
+
+            if (bytesRead > 0)
+                callback(buffer.data(), (size_t) bytesRead);
+        }
+
+        return;
+    }
+
+    while (!threadShouldExit())
+    {
+        const int ready = socket->waitUntilReady(true, 100);
+
+        if (ready < 0)
+            break;
+
+        if (ready == 0)
+            continue;
+
+        const int bytesRead = socket->read(buffer.data(), (int) buffer.size(), false);
+
+        if (bytesRead > 0)
+            callback(buffer.data(), (size_t) bytesRead);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "OscLocalSocket.h"
+
+// Receives UDP datagrams on a background thread and hands each one, as raw bytes, to a
+// callback on that thread. Unlike juce::OSCReceiver nothing is decoded or copied first,
+// so the callback sees every packet, whatever argument types it carries. startLocal()
+// receives from an AF_UNIX datagram socket instead, for senders on the same machine.
+class DatagramReceiver : private juce::Thread
+{
+public:
+    using PacketCallback = std::function<void(const char* data, size_t size)>;
+
+    explicit DatagramReceiver(PacketCallback callbackToUse);
+    ~DatagramReceiver() override;
+
+    bool start(int port);
+    bool startLocal(const std::string& path);
+    void stop();
+    bool isRunning() const noexcept { return isThreadRunning(); }
+
+    // Largest possible UDP payload
+    static constexpr int maxPacketSize = 65507;
+
+private:
+    void run() override;
+
+    PacketCallback callback;
+    std::unique_ptr<juce::DatagramSocket> socket;
+    OscLocalSocket localSocket;
+    std::vector<char> buffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DatagramReceiver)
+};
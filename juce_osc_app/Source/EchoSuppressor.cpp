@@ -0,0 +1,71 @@
+#include "EchoSuppressor.h"
+#include <cstring>
+
+static juce::uint32 getBits(float value) noexcept
+{
+    // +0 and -0 compare equal on the way back, so store them the same way
+    if (value == 0.0f)
+        value = 0.0f;
+
+    juce::uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+EchoSuppressor::EchoSuppressor(int numParametersToUse)
+    : numParameters(juce::jmax(1, numParametersToUse)),
+      slots(new Slot[(size_t) numParameters])
+{
+}
+
+void EchoSuppressor::noteSent(int index, float value) noexcept
+{
+    if (!juce::isPositiveAndBelow(index, numParameters) || windowMs.load(std::memory_order_relaxed) == 0)
+        return;
+
+    auto& slot = slots[(size_t) index];
+    const auto entry = ((juce::uint64) getBits(value) << 32) | (juce::Time::getMillisecondCounter() | 1u);
+    const auto position = slot.next.fetch_add(1, std::memory_order_relaxed) % (juce::uint32) historySize;
+    slot.recent[position].store(entry, std::memory_order_relaxed);
+}
+
+bool EchoSuppressor::isEcho(int index, float value) noexcept
+{
+    const auto window = windowMs.load(std::memory_order_relaxed);
+
+    if (!juce::isPositiveAndBelow(index, numParameters) || window == 0)
+        return false;
+
+    auto& slot = slots[(size_t) index];
+    const auto bits = getBits(value);
+    const auto now = juce::Time::getMillisecondCounter() | 1u; // same rounding as the stored times
+    juce::uint64 entries[historySize];
+    bool anyTagged = false;
+
+    for (int i = 0; i < historySize; ++i)
+    {
+        const auto entry = entries[i] = slot.recent[i].load(std::memory_order_relaxed);
+
+        if (entry == 0)
+            continue;
+
+        anyTagged = true;
+
+        // Unsigned difference stays correct when the millisecond counter wraps
+        if ((juce::uint32) (entry >> 32) == bits && now - (juce::uint32) entry <= window)
+        {
+            numSuppressed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // A genuinely new value: the peer is no longer echoing, so a later change back to
+    // a value we sent must not be mistaken for an echo. Only the entries looked at above are
+    // cleared; one noteSent() has stored since is kept.
+    if (anyTagged)
+        for (int i = 0; i < historySize; ++i)
+            if (entries[i] != 0)
+                slot.recent[i].compare_exchange_strong(entries[i], 0, std::memory_order_relaxed);
+
+    return false;
+}
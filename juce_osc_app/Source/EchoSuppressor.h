@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+
+// Breaks feedback loops with peers that send our own values back to us. Every value we
+// send is tagged with its parameter and send time; an incoming value that matches one of
+// the last few values sent for that parameter within the echo window is our own value
+// coming back and is dropped before it can be applied or re-sent. Any other incoming value
+// means the peer has moved on, so that parameter's tags are forgotten.
+//
+// noteSent() may be called from any thread and isEcho() from the network thread; both are
+// a handful of relaxed atomic operations on the parameter's own slot.
+class EchoSuppressor
+{
+public:
+    explicit EchoSuppressor(int numParameters);
+
+    // 0 disables suppression
+    void setWindowMs(int milliseconds) noexcept { windowMs.store((juce::uint32) juce::jmax(0, milliseconds), std::memory_order_relaxed); }
+    int getWindowMs() const noexcept { return (int) windowMs.load(std::memory_order_relaxed); }
+
+    // value must be what goes on the wire, e.g. already rounded for integer parameters
+    void noteSent(int index, float value) noexcept;
+
+    // True if value is an echo of something we sent for this parameter within the window
+    bool isEcho(int index, float value) noexcept;
+
+    juce::uint64 getNumSuppressed() const noexcept { return numSuppressed.load(std::memory_order_relaxed); }
+
+    static constexpr int historySize = 4; // values in flight per parameter we still recognise
+    static constexpr int defaultWindowMs = 250;
+
+private:
+    struct Slot
+    {
+        // Float bits in the upper half, send time in milliseconds (lowest bit forced on) in the
+        // lower half; 0 is an empty entry
+        std::atomic<juce::uint64> recent[historySize] = {};
+        std::atomic<juce::uint32> next{0};
+    };
+
+    const int numParameters;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<juce::uint32> windowMs{defaultWindowMs};
+    std::atomic<juce::uint64> numSuppressed{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EchoSuppressor)
+};
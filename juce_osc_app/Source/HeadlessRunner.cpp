@@ -0,0 +1,131 @@
+#include "HeadlessRunner.h"
+
+HeadlessRunner::HeadlessRunner(std::shared_ptr<const ParameterSchema> schema, const Options& optionsToUse)
+    : engine(std::move(schema)),
+      smoother(engine.getSchema()),
+      options(optionsToUse)
+{
+    if (options.host.isNotEmpty())
+    {
+        engine.setTarget(options.host, options.port);
+        engine.setMirrorTargets(options.mirrorTargets);
+        std::cout << "Using command-line configuration: " << options.host << ":" << options.port << std::endl;
+    }
+    else
+    {
+        engine.loadConfiguration();
+    }
+
+    if (options.echoWindowMs >= 0)
+        engine.setEchoWindowMs(options.echoWindowMs);
+
+    if (options.multicastTtl >= 0 || options.multicastInterface.isNotEmpty())
+    {
+        auto multicast = engine.getMulticastOptions();
+
+        if (options.multicastTtl >= 0)
+            multicast.timeToLive = options.multicastTtl;
+
+        if (options.multicastInterface.isNotEmpty())
+            multicast.interfaceName = options.multicastInterface;
+
+        engine.setMulticastOptions(multicast);
+    }
+
+    std::cout << "Running headless" << std::endl;
+
+    engine.startListening();
+
+    if (options.localSocketPath.isNotEmpty())
+        engine.startLocalListening(options.localSocketPath);
+
+    engine.applyConfiguration();
+
+    if (options.recordFile != juce::File())
+    {
+        auto result = engine.startRecording(options.recordFile);
+
+        if (result.failed())
+            std::cerr << "ERROR: " << result.getErrorMessage() << std::endl;
+    }
+
+    startTime = lastReportTime = juce::Time::getMillisecondCounter();
+    startTimerHz(60); // same rate as the UI refresh
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    stopTimer();
+    printStatistics();
+    engine.stopListening();
+
+    if (engine.isRecording())
+    {
+        engine.stopRecording();
+        std::cout << "Recorded " << engine.getRecorder().getNumRecorded() << " events ("
+                  << engine.getRecorder().getNumDropped() << " dropped) to "
+                  << options.recordFile.getFullPathName() << std::endl;
+    }
+}
+
+void HeadlessRunner::timerCallback()
+{
+    // Played events are only worth sending once the target has been resolved
+    if (options.playFile != juce::File() && !playbackStarted && engine.isSenderReady())
+    {
+        playbackStarted = true;
+        auto result = engine.startPlayback(options.playFile);
+
+        if (result.failed())
+            std::cerr << "ERROR: " << result.getErrorMessage() << std::endl;
+        else
+            std::cout << "Playing " << options.playFile.getFullPathName() << std::endl;
+    }
+
+    engine.drainChanges([this](int index, float value, juce::int64 arrivalTicks) {
+        ++changesApplied;
+        smoother.setTarget(index, value, arrivalTicks);
+    });
+
+    // Forwarded output moves at the timer rate however irregularly the input arrived
+    const auto frameTicks = juce::Time::getHighResolutionTicks();
+    const auto elapsedMs = lastFrameTicks != 0 ? juce::Time::highResolutionTicksToSeconds(frameTicks - lastFrameTicks) * 1000.0 : 0.0;
+    lastFrameTicks = frameTicks;
+
+    smoother.process(elapsedMs, [this](int index, float value) {
+        if (options.echo)
+            engine.sendParameter(index, value);
+    });
+
+    const auto now = juce::Time::getMillisecondCounter();
+
+    if (now - lastReportTime >= 1000)
+        printStatistics();
+
+    if (options.durationSeconds > 0.0 && now - startTime >= (juce::uint32) (options.durationSeconds * 1000.0))
+    {
+        stopTimer();
+        juce::JUCEApplicationBase::quit();
+    }
+}
+
+void HeadlessRunner::printStatistics()
+{
+    const auto now = juce::Time::getMillisecondCounter();
+    const double seconds = juce::jmax(1u, now - lastReportTime) / 1000.0;
+
+    const auto received = engine.getNumMessagesReceived();
+    const auto sent = engine.getNumMessagesSent();
+    const auto suppressed = engine.getNumEchoesSuppressed();
+
+    std::cout << "Headless: " << juce::String((double) (received - lastReceived) / seconds, 0) << " msg/s in, "
+              << juce::String((double) (changesApplied - lastChangesApplied) / seconds, 0) << " changes/s applied, "
+              << juce::String((double) (sent - lastSent) / seconds, 0) << " msg/s out, "
+              << juce::String((double) (suppressed - lastSuppressed) / seconds, 0) << " echoes/s suppressed" << std::endl;
+
+    lastReportTime = now;
+    lastReceived = received;
+    lastSent = sent;
+    lastSuppressed = suppressed;
+    lastChangesApplied = changesApplied;
+}
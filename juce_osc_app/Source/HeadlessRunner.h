@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_events/juce_events.h>
+#include "OSCEngine.h"
+#include "ParameterSmoother.h"
+
+// Runs the OSC engine without creating any window: drains coalesced parameter changes at
+// the same rate as the UI would, smooths them the same way, optionally echoes the smoothed
+// values back out through the send pipeline, and prints throughput once per second.
+// Used for load tests on display-less machines.
+class HeadlessRunner : private juce::Timer
+{
+public:
+    struct Options
+    {
+        juce::String host;        // empty: use the saved configuration
+        int port = -1;
+        juce::StringArray mirrorTargets; // used together with host and port
+        double durationSeconds = 0.0; // 0: run until interrupted
+        bool echo = false;        // re-send every applied change to the target
+        int echoWindowMs = -1;    // feedback-loop suppression window; -1: use the saved configuration
+        juce::File recordFile;    // record all parameter changes to this automation log
+        juce::File playFile;      // play this automation log once the target is connected
+        juce::String localSocketPath; // also receive on this AF_UNIX datagram socket
+        int multicastTtl = -1;    // for multicast targets; -1: use the saved configuration
+        juce::String multicastInterface; // for multicast targets; empty: use the saved configuration
+    };
+
+    HeadlessRunner(std::shared_ptr<const ParameterSchema> schema, const Options& options);
+    ~HeadlessRunner() override;
+
+private:
+    void timerCallback() override;
+    void printStatistics();
+
+    OSCEngine engine;
+    ParameterSmoother smoother;
+    Options options;
+
+    juce::int64 lastFrameTicks = 0;
+    juce::uint32 startTime = 0;
+    juce::uint32 lastReportTime = 0;
+    juce::uint64 lastReceived = 0;
+    juce::uint64 lastSent = 0;
+    juce::uint64 lastSuppressed = 0;
+    juce::uint64 changesApplied = 0;
+    juce::uint64 lastChangesApplied = 0;
+    bool playbackStarted = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HeadlessRunner)
+};
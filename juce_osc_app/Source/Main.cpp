@@ -1,4 +1,6 @@
 #include <juce_gui_extra/juce_gui_extra.h>
+#include "Benchmarks.h"
+#include "HeadlessRunner.h"
 #include "MainComponent.h"
 #include <iostream>
 
@@ -18,8 +20,20 @@ public:
         args.addTokens(commandLine, true);
         
         juce::String host;
+        juce::String schemaPath;
         int port = -1;
         bool showHelp = false;
+        bool headless = false;
+        bool benchFanOut = false;
+        bool benchPresets = false;
+        bool benchAutomation = false;
+        bool benchSmoothing = false;
+        bool benchLocal = false;
+        bool benchSharedRing = false;
+        bool benchMulticast = false;
+        bool benchUdpOffload = false;
+        juce::StringArray mirrorTargets;
+        HeadlessRunner::Options headlessOptions;
         
         for (int i = 0; i < args.size(); ++i)
         {
@@ -32,6 +46,82 @@ public:
             {
                 host = args[++i];
             }
+            else if (args[i] == "--headless")
+            {
+                headless = true;
+            }
+            else if (args[i] == "--target" && i + 1 < args.size())
+            {
+                mirrorTargets.add(args[++i]);
+            }
+            else if (args[i] == "--bench-fanout")
+            {
+                benchFanOut = true;
+            }
+            else if (args[i] == "--bench-presets")
+            {
+                benchPresets = true;
+            }
+            else if (args[i] == "--record" && i + 1 < args.size())
+            {
+                headlessOptions.recordFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i].unquoted());
+            }
+            else if (args[i] == "--play" && i + 1 < args.size())
+            {
+                headlessOptions.playFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i].unquoted());
+            }
+            else if (args[i] == "--bench-automation")
+            {
+                benchAutomation = true;
+            }
+            else if (args[i] == "--bench-smoothing")
+            {
+                benchSmoothing = true;
+            }
+            else if (args[i] == "--bench-local")
+            {
+                benchLocal = true;
+            }
+            else if (args[i] == "--bench-shm")
+            {
+                benchSharedRing = true;
+            }
+            else if (args[i] == "--bench-multicast")
+            {
+                benchMulticast = true;
+            }
+            else if (args[i] == "--bench-gso")
+            {
+                benchUdpOffload = true;
+            }
+            else if (args[i] == "--multicast-ttl" && i + 1 < args.size())
+            {
+                headlessOptions.multicastTtl = juce::jlimit(0, 255, args[++i].getIntValue());
+            }
+            else if (args[i] == "--multicast-iface" && i + 1 < args.size())
+            {
+                headlessOptions.multicastInterface = args[++i].unquoted();
+            }
+            else if (args[i] == "--listen-unix" && i + 1 < args.size())
+            {
+                headlessOptions.localSocketPath = args[++i].unquoted();
+            }
+            else if (args[i] == "--echo")
+            {
+                headlessOptions.echo = true;
+            }
+            else if (args[i] == "--echo-window" && i + 1 < args.size())
+            {
+                headlessOptions.echoWindowMs = juce::jmax(0, args[++i].getIntValue());
+            }
+            else if (args[i] == "--duration" && i + 1 < args.size())
+            {
+                headlessOptions.durationSeconds = args[++i].getDoubleValue();
+            }
+            else if (args[i] == "--schema" && i + 1 < args.size())
+            {
+                schemaPath = args[++i].unquoted();
+            }
             else if (args[i] == "--port" && i + 1 < args.size())
             {
                 juce::String portStr = args[++i];
@@ -66,10 +156,38 @@ public:
             std::cout << "Options:\n";
             std::cout << "  --host <address>    Set OSC target address (e.g., 127.0.0.1 or localhost)\n";
             std::cout << "  --port <number>     Set OSC target port (1-65535)\n";
+            std::cout << "  --target <host:port[/prefix]>\n";
+            std::cout << "                      Also send to this target, optionally only addresses starting\n";
+            std::cout << "                      with prefix (repeatable; requires --host and --port). Local\n";
+            std::cout << "                      sockets are given as unix:path or unix-stream:path[#prefix]\n";
+            std::cout << "  --schema <file>     Load the control surface from a JSON parameter schema\n";
+            std::cout << "  --headless          Run the OSC engine without a window\n";
+            std::cout << "  --duration <secs>   Headless only: quit after the given number of seconds\n";
+            std::cout << "  --echo              Headless only: re-send every received change to the target\n";
+            std::cout << "  --echo-window <ms>  Headless only: drop incoming values equal to one sent within\n";
+            std::cout << "                      this window, breaking feedback loops (0 disables; default 250)\n";
+            std::cout << "  --multicast-ttl <n> Headless only: router hops for multicast targets (default 1)\n";
+            std::cout << "  --multicast-iface <address|name>\n";
+            std::cout << "                      Headless only: interface multicast targets are sent through\n";
+            std::cout << "  --listen-unix <path>\n";
+            std::cout << "                      Headless only: also receive OSC datagrams on an AF_UNIX socket\n";
+            std::cout << "  --record <file>     Headless only: record all parameter changes to an automation log\n";
+            std::cout << "  --play <file>       Headless only: play an automation log with time-tagged bundles\n";
+            std::cout << "  --bench-fanout      Measure send throughput to 1, 8 and 64 loopback targets\n";
+            std::cout << "  --bench-presets     Measure preset recall time for 10000 parameters\n";
+            std::cout << "  --bench-automation  Measure automation recording and playback at 100k events/s\n";
+            std::cout << "  --bench-smoothing   Measure one smoothing frame for 10000 parameters per mode\n";
+            std::cout << "  --bench-local       Compare loopback UDP with AF_UNIX datagram and stream sockets\n";
+            std::cout << "  --bench-shm         Compare the shared-memory ring with an AF_UNIX datagram socket\n";
+            std::cout << "  --bench-multicast   Compare CPU per cue for 40 loopback subscribers, unicast vs multicast\n";
+            std::cout << "  --bench-gso         Compare per-datagram sends, sendmmsg and UDP_SEGMENT on loopback\n";
             std::cout << "  --help, -h          Display this help message\n\n";
             std::cout << "Examples:\n";
             std::cout << "  OSCControlApp --host 192.168.1.100 --port 8000\n";
-            std::cout << "  OSCControlApp --host localhost --port 7770\n\n";
+            std::cout << "  OSCControlApp --host localhost --port 7770\n";
+            std::cout << "  OSCControlApp --host 10.0.0.5 --port 9000 --target 10.0.0.6:9000/mixer\n";
+            std::cout << "  OSCControlApp --schema mixer.json\n";
+            std::cout << "  OSCControlApp --headless --duration 10 --host localhost --port 7770\n\n";
             std::cout << "If no options are provided, the application uses saved configuration\n";
             std::cout << "or defaults to 127.0.0.1:7770.\n\n";
             std::cout << "The application listens for incoming OSC messages on port 7771.\n";
@@ -77,7 +195,100 @@ public:
             return;
         }
         
+        if (benchFanOut)
+        {
+            Benchmarks::runFanOut(headlessOptions.durationSeconds > 0.0 ? headlessOptions.durationSeconds : 1.0);
+            quit();
+            return;
+        }
+        
+        if (benchAutomation)
+        {
+            Benchmarks::runAutomation(100000, 1000);
+            quit();
+            return;
+        }
+        
+        if (benchSmoothing)
+        {
+            Benchmarks::runSmoothing(10000, 1000);
+            quit();
+            return;
+        }
+        
+        if (benchLocal)
+        {
+            Benchmarks::runLocalTransports(headlessOptions.durationSeconds > 0.0 ? headlessOptions.durationSeconds : 1.0);
+            quit();
+            return;
+        }
+        
+        if (benchSharedRing)
+        {
+            Benchmarks::runSharedRing(headlessOptions.durationSeconds > 0.0 ? headlessOptions.durationSeconds : 1.0);
+            quit();
+            return;
+        }
+        
+        if (benchMulticast)
+        {
+            Benchmarks::runMulticast(40, headlessOptions.durationSeconds > 0.0 ? headlessOptions.durationSeconds : 1.0);
+            quit();
+            return;
+        }
+        
+        if (benchUdpOffload)
+        {
+            Benchmarks::runUdpOffload(headlessOptions.durationSeconds > 0.0 ? headlessOptions.durationSeconds : 1.0);
+            quit();
+            return;
+        }
+        
+        if (benchPresets)
+        {
+            Benchmarks::runPresetRecall(10000, 1000);
+            quit();
+            return;
+        }
+        
+        auto schema = std::make_shared<ParameterSchema>(ParameterSchema::createDefault());
+        
+        if (schemaPath.isNotEmpty())
+        {
+            auto result = ParameterSchema::loadFromFile(juce::File::getCurrentWorkingDirectory()
+                                                            .getChildFile(schemaPath), *schema);
+            
+            if (result.failed())
+            {
+                std::cerr << "Error: " << result.getErrorMessage() << "\n";
+                quit();
+                return;
+            }
+            
+            std::cout << "Loaded parameter schema: " << schema->size() << " parameters\n";
+        }
+        
         // Validate command-line arguments if provided
+        if (!mirrorTargets.isEmpty() && host.isEmpty())
+        {
+            std::cerr << "Error: --target requires --host and --port\n";
+            std::cerr << "Use --help for usage information\n";
+            quit();
+            return;
+        }
+        
+        for (const auto& target : mirrorTargets)
+        {
+            AsyncOSCSender::Destination destination;
+            
+            if (!AsyncOSCSender::Destination::fromString(target, destination))
+            {
+                std::cerr << "Error: Invalid --target " << target << ". Expected host:port[/prefix] or unix:path[#prefix]\n";
+                quit();
+                return;
+            }
+        }
+        
         if (!host.isEmpty() || port != -1)
         {
             if (host.isEmpty())
@@ -102,18 +313,29 @@ public:
                 quit();
                 return;
             }
-            
-            mainWindow.reset(new MainWindow(getApplicationName(), host, port));
+        }
+        
+        if (headless)
+        {
+            headlessOptions.host = host;
+            headlessOptions.port = port;
+            headlessOptions.mirrorTargets = mirrorTargets;
+            headlessRunner.reset(new HeadlessRunner(schema, headlessOptions));
+        }
+        else if (!host.isEmpty())
+        {
+            mainWindow.reset(new MainWindow(getApplicationName(), schema, host, port, mirrorTargets));
         }
         else
         {
-            mainWindow.reset(new MainWindow(getApplicationName()));
+            mainWindow.reset(new MainWindow(getApplicationName(), schema));
         }
     }
 
     void shutdown() override
     {
         mainWindow = nullptr;
+        headlessRunner = nullptr;
     }
 
     void systemRequestedQuit() override
@@ -128,14 +350,14 @@ public:
     class MainWindow : public juce::DocumentWindow
     {
     public:
-        MainWindow(juce::String name)
+        MainWindow(juce::String name, std::shared_ptr<const ParameterSchema> schema)
             : DocumentWindow(name,
                            juce::Desktop::getInstance().getDefaultLookAndFeel()
                                                        .findColour(juce::ResizableWindow::backgroundColourId),
                            DocumentWindow::allButtons)
         {
             setUsingNativeTitleBar(true);
-            setContentOwned(new MainComponent(), true);
+            setContentOwned(new MainComponent(schema), true);
 
            #if JUCE_IOS || JUCE_ANDROID
             setFullScreen(true);
@@ -147,14 +369,15 @@ public:
             setVisible(true);
         }
         
-        MainWindow(juce::String name, const juce::String& host, int port)
+        MainWindow(juce::String name, std::shared_ptr<const ParameterSchema> schema,
+                   const juce::String& host, int port, const juce::StringArray& mirrorTargets)
             : DocumentWindow(name,
                            juce::Desktop::getInstance().getDefaultLookAndFeel()
                                                        .findColour(juce::ResizableWindow::backgroundColourId),
                            DocumentWindow::allButtons)
         {
             setUsingNativeTitleBar(true);
-            setContentOwned(new MainComponent(host, port), true);
+            setContentOwned(new MainComponent(schema, host, port, mirrorTargets), true);
 
            #if JUCE_IOS || JUCE_ANDROID
             setFullScreen(true);
@@ -177,6 +400,7 @@ public:
 
 private:
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<HeadlessRunner> headlessRunner;
 };
 
 START_JUCE_APPLICATION(OSCControlApplication)
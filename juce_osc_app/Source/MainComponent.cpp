@@ -1,63 +1,48 @@
 #include "MainComponent.h"
 
-MainComponent::MainComponent()
+MainComponent::MainComponent(std::shared_ptr<const ParameterSchema> schemaToUse)
+    : engine(std::move(schemaToUse)),
+      smoother(engine.getSchema()),
+      parameterGrid(engine.getSchemaPtr()),
+      performancePanel(engine)
 {
-    initializePropertiesFile();
-    loadConfiguration();
     initializeComponent();
+    
+    // The window shows immediately; the target is applied once the settings file has been read
+    statusLabel.setText("Loading configuration...", juce::dontSendNotification);
+    engine.loadConfigurationAsync([this] {
+        showConfiguration();
+        engine.applyConfiguration();
+    });
 }
 
-MainComponent::MainComponent(const juce::String& cmdLineHost, int cmdLinePort)
+MainComponent::MainComponent(std::shared_ptr<const ParameterSchema> schemaToUse,
+                             const juce::String& cmdLineHost, int cmdLinePort,
+                             const juce::StringArray& cmdLineMirrors)
+    : engine(std::move(schemaToUse)),
+      smoother(engine.getSchema()),
+      parameterGrid(engine.getSchemaPtr()),
+      performancePanel(engine)
 {
-    initializePropertiesFile();
-    
     // Initialize configuration from command-line arguments; allows subsequent modifications via UI
-    oscTargetHost = cmdLineHost;
-    oscTargetPort = cmdLinePort;
+    engine.setTarget(cmdLineHost, cmdLinePort);
+    engine.setMirrorTargets(cmdLineMirrors);
     
-    std::cout << "Using command-line configuration: " << oscTargetHost << ":" << oscTargetPort << std::endl;
+    std::cout << "Using command-line configuration: " << cmdLineHost << ":" << cmdLinePort << std::endl;
     
     initializeComponent();
-}
-
-void MainComponent::initializePropertiesFile()
-{
-    // Initialize configuration
-    juce::PropertiesFile::Options options;
-    options.applicationName = "OSCControlApp";
-    options.filenameSuffix = ".settings";
-    options.osxLibrarySubFolder = "Application Support";
-    options.folderName = juce::File::getSpecialLocation(
-        juce::File::userApplicationDataDirectory).getChildFile("OSCControlApp").getFullPathName();
-    
-    // Create folder if it doesn't exist
-    juce::File settingsDir(options.folderName);
-    if (!settingsDir.exists())
-        settingsDir.createDirectory();
-    
-    properties.reset(new juce::PropertiesFile(options));
+    engine.applyConfiguration();
 }
 
 void MainComponent::initializeComponent()
 {
-    // Set up OSC receiver
-    if (!oscReceiver.connect(OSC_PORT))
-    {
-        std::cerr << "ERROR: Failed to create OSC server on port " << OSC_PORT << std::endl;
-    }
-    else
-    {
-        oscReceiver.addListener(this);
-        std::cout << "OSC Server started on port " << OSC_PORT << std::endl;
-        std::cout << "Listening for OSC messages on:" << std::endl;
-        std::cout << "  /toggle  - integer (0=OFF, 1=ON)" << std::endl;
-        std::cout << "  /hslider - float (0.0-1.0)" << std::endl;
-        std::cout << "  /vslider - float (0.0-1.0)" << std::endl;
-        std::cout << "  /knob    - float (0.0-1.0)" << std::endl;
-    }
-    
-    // Set up OSC sender
-    applyConfiguration();
+    // Set up OSC receiver and sender
+    engine.onTargetStatusChanged = [this](bool ok, const juce::String& description) {
+        statusLabel.setText(ok ? "Sending to " + description : "Error: could not connect to " + description,
+                            juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, ok ? juce::Colours::green : juce::Colours::red);
+    };
+    engine.startListening();
     
     // Configure configuration UI
     addAndMakeVisible(configTitleLabel);
@@ -73,7 +58,6 @@ void MainComponent::initializeComponent()
     addressLabel.setJustificationType(juce::Justification::centredLeft);
     
     addAndMakeVisible(addressEditor);
-    addressEditor.setText(oscTargetHost);
     addressEditor.setInputRestrictions(0); // Allow any characters for localhost or IP
     addressEditor.setTooltip("Enter IP address (e.g., 127.0.0.1) or hostname (e.g., localhost)");
     
@@ -82,10 +66,18 @@ void MainComponent::initializeComponent()
     portLabel.setJustificationType(juce::Justification::centredLeft);
     
     addAndMakeVisible(portEditor);
-    portEditor.setText(juce::String(oscTargetPort));
     portEditor.setInputRestrictions(5, "0123456789");
     portEditor.setTooltip("Enter port number (1-65535)");
     
+    addAndMakeVisible(mirrorLabel);
+    mirrorLabel.setText("Mirror To:", juce::dontSendNotification);
+    mirrorLabel.setJustificationType(juce::Justification::centredLeft);
+    
+    addAndMakeVisible(mirrorEditor);
+    mirrorEditor.setTooltip("Additional targets, comma separated, as host:port or host:port/prefix, or local "
+                            "sockets as unix:path or unix-stream:path (e.g., 10.0.0.5:9000, 10.0.0.6:9000/mixer, "
+                            "unix:/tmp/osc.sock)");
+    
     addAndMakeVisible(applyButton);
     applyButton.setButtonText("Apply");
     applyButton.onClick = [this] { onApplyButtonClicked(); };
@@ -94,118 +86,69 @@ void MainComponent::initializeComponent()
     statusLabel.setText("", juce::dontSendNotification);
     statusLabel.setJustificationType(juce::Justification::centredLeft);
     
-    // Configure toggle button
-    addAndMakeVisible(toggleButton);
-    toggleButton.setButtonText("Toggle");
-    toggleButton.onClick = [this] {
-        bool state = toggleButton.getToggleState();
-        toggleValueLabel.setText(state ? "ON" : "OFF", juce::dontSendNotification);
-        std::cout << "Toggle clicked: " << (state ? "ON" : "OFF") << std::endl;
-        
-        juce::OSCMessage msg("/toggle");
-        msg.addInt32(state ? 1 : 0);
-        sendOscMessage("/toggle", msg);
-    };
+    showConfiguration();
     
-    addAndMakeVisible(toggleLabel);
-    toggleLabel.setText("Toggle Control", juce::dontSendNotification);
-    toggleLabel.setJustificationType(juce::Justification::centred);
-    
-    addAndMakeVisible(toggleValueLabel);
-    toggleValueLabel.setText("OFF", juce::dontSendNotification);
-    toggleValueLabel.setJustificationType(juce::Justification::centred);
-    
-    // Configure horizontal slider
-    addAndMakeVisible(horizontalSlider);
-    horizontalSlider.setRange(0.0, 1.0, 0.01);
-    horizontalSlider.setValue(0.5);
-    horizontalSlider.setSliderStyle(juce::Slider::LinearHorizontal);
-    horizontalSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    horizontalSlider.onValueChange = [this] {
-        float value = static_cast<float>(horizontalSlider.getValue());
-        hSliderValueLabel.setText(juce::String(value, 2), 
-                                  juce::dontSendNotification);
-        std::cout << "HSlider: " << value << std::endl;
-        
-        juce::OSCMessage msg("/hslider");
-        msg.addFloat32(value);
-        sendOscMessage("/hslider", msg);
-    };
+    // Presets
+    auto presetResult = engine.openPresets(engine.getDefaultPresetFile());
     
-    addAndMakeVisible(hSliderLabel);
-    hSliderLabel.setText("Horizontal Slider", juce::dontSendNotification);
-    hSliderLabel.setJustificationType(juce::Justification::centred);
-    
-    addAndMakeVisible(hSliderValueLabel);
-    hSliderValueLabel.setText("0.50", juce::dontSendNotification);
-    hSliderValueLabel.setJustificationType(juce::Justification::centred);
-    
-    // Configure vertical slider
-    addAndMakeVisible(verticalSlider);
-    verticalSlider.setRange(0.0, 1.0, 0.01);
-    verticalSlider.setValue(0.5);
-    verticalSlider.setSliderStyle(juce::Slider::LinearVertical);
-    verticalSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    verticalSlider.onValueChange = [this] {
-        float value = static_cast<float>(verticalSlider.getValue());
-        vSliderValueLabel.setText(juce::String(value, 2), 
-                                  juce::dontSendNotification);
-        std::cout << "VSlider: " << value << std::endl;
-        
-        juce::OSCMessage msg("/vslider");
-        msg.addFloat32(value);
-        sendOscMessage("/vslider", msg);
-    };
+    if (presetResult.failed())
+        std::cerr << "Presets unavailable: " << presetResult.getErrorMessage() << std::endl;
     
-    addAndMakeVisible(vSliderLabel);
-    vSliderLabel.setText("Vertical Slider", juce::dontSendNotification);
-    vSliderLabel.setJustificationType(juce::Justification::centred);
-    
-    addAndMakeVisible(vSliderValueLabel);
-    vSliderValueLabel.setText("0.50", juce::dontSendNotification);
-    vSliderValueLabel.setJustificationType(juce::Justification::centred);
-    
-    // Configure knob (rotary slider)
-    addAndMakeVisible(knobSlider);
-    knobSlider.setRange(0.0, 1.0, 0.01);
-    knobSlider.setValue(0.5);
-    knobSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-    knobSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    knobSlider.onValueChange = [this] {
-        float value = static_cast<float>(knobSlider.getValue());
-        knobValueLabel.setText(juce::String(value, 2), 
-                              juce::dontSendNotification);
-        std::cout << "Knob: " << value << std::endl;
-        
-        juce::OSCMessage msg("/knob");
-        msg.addFloat32(value);
-        sendOscMessage("/knob", msg);
-    };
+    addAndMakeVisible(presetLabel);
+    presetLabel.setText("Preset:", juce::dontSendNotification);
+    presetLabel.setJustificationType(juce::Justification::centredLeft);
+    
+    addAndMakeVisible(presetSelector);
+    updatePresetSelector();
+    presetSelector.setSelectedId(1, juce::dontSendNotification);
+    
+    addAndMakeVisible(storePresetButton);
+    storePresetButton.setButtonText("Store");
+    storePresetButton.onClick = [this] { onStorePresetClicked(); };
+    
+    addAndMakeVisible(recallPresetButton);
+    recallPresetButton.setButtonText("Recall");
+    recallPresetButton.onClick = [this] { onRecallPresetClicked(); };
+    
+    const bool presetsAvailable = engine.getPresets().isOpen();
+    presetSelector.setEnabled(presetsAvailable);
+    storePresetButton.setEnabled(presetsAvailable);
+    recallPresetButton.setEnabled(presetsAvailable);
     
-    addAndMakeVisible(knobLabel);
-    knobLabel.setText("Knob Control", juce::dontSendNotification);
-    knobLabel.setJustificationType(juce::Justification::centred);
+    // Automation
+    addAndMakeVisible(automationLabel);
+    automationLabel.setText("Automation:", juce::dontSendNotification);
+    automationLabel.setJustificationType(juce::Justification::centredLeft);
     
-    addAndMakeVisible(knobValueLabel);
-    knobValueLabel.setText("0.50", juce::dontSendNotification);
-    knobValueLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(recordButton);
+    recordButton.onClick = [this] { onRecordClicked(); };
     
-    // Start timer for UI updates
-    startTimer(50); // 20 FPS
+    addAndMakeVisible(playButton);
+    playButton.onClick = [this] { onPlayClicked(); };
     
-    setSize(600, 650);
+    addAndMakeVisible(automationStatusLabel);
+    automationStatusLabel.setJustificationType(juce::Justification::centredLeft);
+    updateAutomationButtons();
+    
+    // Control surface generated from the schema
+    addAndMakeVisible(parameterGrid);
+    parameterGrid.setScopeBank(&engine.getScopes());
+    parameterGrid.onUserChange = [this](int index, float value) { onParameterChangedByUser(index, value); };
+    parameterGrid.onMappingCommand = [this](int index, ParameterGrid::MappingCommand command) {
+        onMappingCommand(index, command);
+    };
+    
+    addAndMakeVisible(performancePanel);
+    
+    // Start timer for UI updates; smoothed controls move once per frame
+    startTimerHz(60);
+    
+    setSize(600, 825);
 }
 
 MainComponent::~MainComponent()
 {
-    if (properties)
-    {
-        properties->saveIfNeeded();
-    }
-    
-    oscReceiver.removeListener(this);
-    oscReceiver.disconnect();
-    oscSender.disconnect();
+    engine.stopListening();
 }
 
 void MainComponent::paint(juce::Graphics& g)
@@ -224,7 +167,7 @@ void MainComponent::resized()
     bounds.removeFromTop(60); // Space for title
     
     // Configuration section at the top
-    auto configBounds = bounds.removeFromTop(120);
+    auto configBounds = bounds.removeFromTop(155);
     configBounds = configBounds.reduced(10);
     
     configTitleLabel.setBounds(configBounds.removeFromTop(25));
@@ -239,186 +182,338 @@ void MainComponent::resized()
     configRow1.removeFromLeft(5); // spacing
     portEditor.setBounds(configRow1.removeFromLeft(80));
     
+    configBounds.removeFromTop(5); // spacing
+    auto mirrorRow = configBounds.removeFromTop(30);
+    mirrorLabel.setBounds(mirrorRow.removeFromLeft(120));
+    mirrorRow.removeFromLeft(5); // spacing
+    mirrorEditor.setBounds(mirrorRow.removeFromLeft(375));
+    
     configBounds.removeFromTop(5); // spacing
     auto configRow2 = configBounds.removeFromTop(30);
     applyButton.setBounds(configRow2.removeFromLeft(100));
     configRow2.removeFromLeft(10); // spacing
     statusLabel.setBounds(configRow2);
     
+    // Preset row
+    auto presetRow = bounds.removeFromTop(40).reduced(10, 5);
+    presetLabel.setBounds(presetRow.removeFromLeft(120));
+    presetRow.removeFromLeft(5); // spacing
+    presetSelector.setBounds(presetRow.removeFromLeft(200));
+    presetRow.removeFromLeft(10); // spacing
+    storePresetButton.setBounds(presetRow.removeFromLeft(80));
+    presetRow.removeFromLeft(5); // spacing
+    recallPresetButton.setBounds(presetRow.removeFromLeft(80));
+    
+    // Automation row
+    auto automationRow = bounds.removeFromTop(40).reduced(10, 5);
+    automationLabel.setBounds(automationRow.removeFromLeft(120));
+    automationRow.removeFromLeft(5); // spacing
+    recordButton.setBounds(automationRow.removeFromLeft(100));
+    automationRow.removeFromLeft(5); // spacing
+    playButton.setBounds(automationRow.removeFromLeft(100));
+    automationRow.removeFromLeft(10); // spacing
+    automationStatusLabel.setBounds(automationRow);
+    
+    performancePanel.setBounds(bounds.removeFromBottom(60));
+    
     bounds.removeFromTop(10); // spacing
     
-    auto section = bounds.removeFromTop(100);
+    parameterGrid.setBounds(bounds);
+}
+
+void MainComponent::timerCallback()
+{
+    const auto frameStart = juce::Time::getHighResolutionTicks();
     
-    // Toggle button section
-    auto toggleSection = section.removeFromLeft(150);
-    toggleLabel.setBounds(toggleSection.removeFromTop(25));
-    toggleButton.setBounds(toggleSection.removeFromTop(30).reduced(10));
-    toggleValueLabel.setBounds(toggleSection.removeFromTop(25));
+    // Only the latest value of each parameter changed since the last frame becomes its new target
+    engine.drainChanges([this](int index, float value, juce::int64 arrivalTicks) {
+        smoother.setTarget(index, value, arrivalTicks);
+        std::cout << "OSC " << engine.getSchema()[index].address << " received: " << value << std::endl;
+    });
     
-    section.removeFromLeft(10); // spacing
+    const auto elapsedMs = lastFrameTicks != 0 ? juce::Time::highResolutionTicksToSeconds(frameStart - lastFrameTicks) * 1000.0 : 0.0;
+    lastFrameTicks = frameStart;
+    smoother.process(elapsedMs, [this](int index, float value) { applyParameterChange(index, value); });
     
-    // Horizontal slider section
-    auto hSliderSection = section;
-    hSliderLabel.setBounds(hSliderSection.removeFromTop(25));
-    hSliderValueLabel.setBounds(hSliderSection.removeFromBottom(25));
-    horizontalSlider.setBounds(hSliderSection.reduced(10));
+    // Playback ends on its own thread; pick that up here
+    if (wasPlaying && !engine.isPlaying())
+        updateAutomationButtons();
     
-    bounds.removeFromTop(20); // spacing
+    AddressMapping learned;
     
-    // Bottom section for vertical slider and knob
-    auto bottomBounds = bounds;
+    if (engine.completeLearning(learned))
+    {
+        const auto& spec = engine.getSchema()[learned.parameterIndex];
+        parameterGrid.setLearningParameter(-1);
+        
+        std::cout << "Learned " << learned.addressPattern << " argument " << learned.argumentIndex
+                  << " -> " << spec.address << std::endl;
+        statusLabel.setText(learned.addressPattern + " now controls " + spec.label, juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::green);
+    }
     
-    // Vertical slider section
-    auto vSliderSection = bottomBounds.removeFromLeft(150);
-    vSliderLabel.setBounds(vSliderSection.removeFromTop(25));
-    vSliderValueLabel.setBounds(vSliderSection.removeFromBottom(25));
-    verticalSlider.setBounds(vSliderSection.reduced(20));
+    performancePanel.recordFrame(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - frameStart) * 1000.0);
+}
+
+void MainComponent::applyParameterChange(int index, float value)
+{
+    parameterGrid.setValue(index, value);
+}
+
+void MainComponent::onParameterChangedByUser(int index, float value)
+{
+    const auto& spec = engine.getSchema()[index];
+    std::cout << spec.label << ": " << value << std::endl;
     
-    bottomBounds.removeFromLeft(50); // spacing
+    // The user's value wins over any ramp still in progress
+    smoother.jumpTo(index, value);
     
-    // Knob section
-    auto knobSection = bottomBounds.removeFromLeft(150);
-    knobLabel.setBounds(knobSection.removeFromTop(25));
-    knobValueLabel.setBounds(knobSection.removeFromBottom(25));
-    knobSlider.setBounds(knobSection.reduced(20));
+    if (!engine.sendParameter(index, value))
+    {
+        std::cerr << "Error sending OSC message to " << spec.address << std::endl;
+    }
+    else
+    {
+        std::cout << "Sent OSC: " << spec.address << std::endl;
+    }
 }
 
-void MainComponent::timerCallback()
+void MainComponent::showConfiguration()
+{
+    addressEditor.setText(engine.getTargetHost(), false);
+    portEditor.setText(juce::String(engine.getTargetPort()), false);
+    mirrorEditor.setText(engine.getMirrorTargets().joinIntoString(", "), false);
+}
+
+void MainComponent::updatePresetSelector()
 {
-    // Update UI from OSC messages (thread-safe)
-    if (toggleNeedsUpdate.load())
+    const auto& presets = engine.getPresets();
+    const int selectedId = presetSelector.getSelectedId();
+    
+    presetSelector.clear(juce::dontSendNotification);
+    
+    for (int slot = 0; slot < presets.getNumSlots(); ++slot)
     {
-        toggleNeedsUpdate.store(false);
-        bool state = newToggleValue.load() != 0;
-        toggleButton.setToggleState(state, juce::dontSendNotification);
-        toggleValueLabel.setText(state ? "ON" : "OFF", juce::dontSendNotification);
+        const auto name = presets.isUsed(slot) ? presets.getName(slot) : juce::String("(empty)");
+        presetSelector.addItem(juce::String(slot + 1) + ": " + name, slot + 1);
     }
     
-    if (hsliderNeedsUpdate.load())
+    presetSelector.setSelectedId(selectedId, juce::dontSendNotification);
+}
+
+void MainComponent::onStorePresetClicked()
+{
+    const int slot = presetSelector.getSelectedId() - 1;
+    
+    if (slot < 0)
+        return;
+    
+    const auto name = "Preset " + juce::String(slot + 1) + " ("
+                      + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H:%M") + ")";
+    
+    if (engine.getPresets().store(slot, name, parameterGrid.getValues().data()))
     {
-        hsliderNeedsUpdate.store(false);
-        float value = newHSliderValue.load();
-        horizontalSlider.setValue(value, juce::dontSendNotification);
-        hSliderValueLabel.setText(juce::String(value, 2), juce::dontSendNotification);
+        std::cout << "Stored " << name << std::endl;
+        updatePresetSelector();
     }
+}
+
+void MainComponent::onRecallPresetClicked()
+{
+    const int slot = presetSelector.getSelectedId() - 1;
+    const float* presetValues = engine.getPresets().getValues(slot);
     
-    if (vsliderNeedsUpdate.load())
+    if (presetValues == nullptr)
     {
-        vsliderNeedsUpdate.store(false);
-        float value = newVSliderValue.load();
-        verticalSlider.setValue(value, juce::dontSendNotification);
-        vSliderValueLabel.setText(juce::String(value, 2), juce::dontSendNotification);
+        statusLabel.setText("Preset " + juce::String(slot + 1) + " is empty", juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::yellow);
+        return;
     }
     
-    if (knobNeedsUpdate.load())
+    // Only parameters that differ from what is on screen are sent and redrawn
+    const double start = juce::Time::getMillisecondCounterHiRes();
+    const int numChanged = engine.recallPreset(slot, parameterGrid.getValues().data(), recallChanges);
+    const double sendTime = juce::Time::getMillisecondCounterHiRes() - start;
+    
+    for (int i = 0; i < numChanged; ++i)
     {
-        knobNeedsUpdate.store(false);
-        float value = newKnobValue.load();
-        knobSlider.setValue(value, juce::dontSendNotification);
-        knobValueLabel.setText(juce::String(value, 2), juce::dontSendNotification);
+        const int index = recallChanges[(size_t) i];
+        parameterGrid.setValue(index, presetValues[index]);
+        smoother.jumpTo(index, presetValues[index]);
     }
+    
+    std::cout << "Recalled " << engine.getPresets().getName(slot) << ": " << numChanged
+              << " parameters changed, sent in " << juce::String(sendTime, 3) << " ms" << std::endl;
 }
 
-void MainComponent::oscMessageReceived(const juce::OSCMessage& message)
+void MainComponent::updateAutomationButtons()
 {
-    juce::String address = message.getAddressPattern().toString();
+    wasPlaying = engine.isPlaying();
+    recordButton.setButtonText(engine.isRecording() ? "Stop Recording" : "Record");
+    playButton.setButtonText(wasPlaying ? "Stop" : "Play");
+    recordButton.setEnabled(!wasPlaying);
+    playButton.setEnabled(!engine.isRecording());
     
-    if (address == "/toggle" && message.size() >= 1)
+    if (engine.isRecording())
     {
-        if (message[0].isInt32())
-        {
-            int value = message[0].getInt32();
-            newToggleValue.store(value);
-            toggleNeedsUpdate.store(true);
-            std::cout << "OSC /toggle received: " << value << std::endl;
-        }
+        automationStatusLabel.setText("Recording...", juce::dontSendNotification);
     }
-    else if (address == "/hslider" && message.size() >= 1)
+    else if (wasPlaying)
     {
-        if (message[0].isFloat32())
-        {
-            float value = message[0].getFloat32();
-            value = juce::jlimit(0.0f, 1.0f, value);
-            newHSliderValue.store(value);
-            hsliderNeedsUpdate.store(true);
-            std::cout << "OSC /hslider received: " << value << std::endl;
-        }
+        automationStatusLabel.setText("Playing...", juce::dontSendNotification);
     }
-    else if (address == "/vslider" && message.size() >= 1)
+    else if (engine.getPlayer().getNumEventsPlayed() > 0)
     {
-        if (message[0].isFloat32())
-        {
-            float value = message[0].getFloat32();
-            value = juce::jlimit(0.0f, 1.0f, value);
-            newVSliderValue.store(value);
-            vsliderNeedsUpdate.store(true);
-            std::cout << "OSC /vslider received: " << value << std::endl;
-        }
+        automationStatusLabel.setText("Played " + juce::String(engine.getPlayer().getNumEventsPlayed()) + " events",
+                                      juce::dontSendNotification);
+    }
+}
+
+void MainComponent::onRecordClicked()
+{
+    if (engine.isRecording())
+    {
+        engine.stopRecording();
+        std::cout << "Recorded " << engine.getRecorder().getNumRecorded() << " events ("
+                  << engine.getRecorder().getNumDropped() << " dropped)" << std::endl;
     }
-    else if (address == "/knob" && message.size() >= 1)
+    else
     {
-        if (message[0].isFloat32())
+        auto result = engine.startRecording(engine.getDefaultAutomationFile());
+        
+        if (result.failed())
         {
-            float value = message[0].getFloat32();
-            value = juce::jlimit(0.0f, 1.0f, value);
-            newKnobValue.store(value);
-            knobNeedsUpdate.store(true);
-            std::cout << "OSC /knob received: " << value << std::endl;
+            std::cerr << "ERROR: " << result.getErrorMessage() << std::endl;
+            automationStatusLabel.setText(result.getErrorMessage(), juce::dontSendNotification);
+            return;
         }
     }
+    
+    updateAutomationButtons();
 }
 
-void MainComponent::oscBundleReceived(const juce::OSCBundle& /*bundle*/)
-{
-    // OSC bundles are not used by this application as all UI controls send individual messages.
-    // Bundles would be useful for atomic updates of multiple parameters, but are not needed here.
-}
-
-void MainComponent::sendOscMessage(const juce::String& address, const juce::OSCMessage& message)
+void MainComponent::onPlayClicked()
 {
-    if (!oscSender.send(message))
+    if (engine.isPlaying())
     {
-        std::cerr << "Error sending OSC message to " << address << std::endl;
+        engine.stopPlayback();
     }
     else
     {
-        std::cout << "Sent OSC: " << address << std::endl;
+        auto result = engine.startPlayback(engine.getDefaultAutomationFile());
+        
+        if (result.failed())
+        {
+            std::cerr << "ERROR: " << result.getErrorMessage() << std::endl;
+            automationStatusLabel.setText(result.getErrorMessage(), juce::dontSendNotification);
+            return;
+        }
     }
-}
-
-void MainComponent::loadConfiguration()
-{
-    // Load saved configuration or use defaults
-    oscTargetHost = properties->getValue("oscTargetHost", "127.0.0.1");
-    oscTargetPort = properties->getIntValue("oscTargetPort", 7770);
     
-    std::cout << "Loaded configuration: " << oscTargetHost << ":" << oscTargetPort << std::endl;
+    updateAutomationButtons();
 }
 
-void MainComponent::saveConfiguration()
+void MainComponent::onMappingCommand(int index, ParameterGrid::MappingCommand command)
 {
-    properties->setValue("oscTargetHost", oscTargetHost);
-    properties->setValue("oscTargetPort", oscTargetPort);
-    properties->saveIfNeeded();
+    const auto& spec = engine.getSchema()[index];
     
-    std::cout << "Saved configuration: " << oscTargetHost << ":" << oscTargetPort << std::endl;
-}
-
-void MainComponent::applyConfiguration()
-{
-    // Disconnect existing sender
-    oscSender.disconnect();
+    if (command == ParameterGrid::MappingCommand::learn)
+    {
+        if (engine.getMapper().getLearningParameter() == index)
+        {
+            engine.cancelLearning();
+            parameterGrid.setLearningParameter(-1);
+            return;
+        }
+        
+        engine.startLearning(index);
+        parameterGrid.setLearningParameter(index);
+        statusLabel.setText("Send an OSC message to control " + spec.label, juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::yellow);
+        return;
+    }
     
-    // Connect to new target
-    if (!oscSender.connect(oscTargetHost, oscTargetPort))
+    if (command == ParameterGrid::MappingCommand::editRange)
     {
-        std::cerr << "ERROR: Failed to create OSC client" << std::endl;
+        showInputRangeEditor(index);
+        return;
+    }
+    
+    auto mappings = engine.getMapper().getMappings();
+    
+    if (command == ParameterGrid::MappingCommand::invert)
+    {
+        for (auto& mapping : mappings)
+            if (mapping.parameterIndex == index)
+                mapping.inverted = !mapping.inverted;
     }
     else
     {
-        std::cout << "OSC Client initialized, sending to: " << oscTargetHost 
-                  << ":" << oscTargetPort << std::endl;
+        mappings.erase(std::remove_if(mappings.begin(), mappings.end(),
+                                      [index](const AddressMapping& mapping) { return mapping.parameterIndex == index; }),
+                       mappings.end());
     }
+    
+    engine.setMappings(std::move(mappings));
+    std::cout << "Updated address mappings for " << spec.address << std::endl;
+}
+
+void MainComponent::showInputRangeEditor(int index)
+{
+    const auto& spec = engine.getSchema()[index];
+    const auto& mappings = engine.getMapper().getMappings();
+    const auto first = std::find_if(mappings.begin(), mappings.end(),
+                                    [index](const AddressMapping& mapping) { return mapping.parameterIndex == index; });
+    
+    if (first == mappings.end())
+    {
+        statusLabel.setText(spec.label + " has no learned addresses", juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::yellow);
+        return;
+    }
+    
+    // Shows the range of the first learned address; OK applies it to all of them
+    inputRangeEditor = std::make_unique<juce::AlertWindow>("Input range",
+                                                           "Incoming values from minimum to maximum are scaled to "
+                                                           + spec.label + "'s range.",
+                                                           juce::MessageBoxIconType::NoIcon);
+    inputRangeEditor->addTextEditor("min", juce::String(first->inputMinimum), "Minimum");
+    inputRangeEditor->addTextEditor("max", juce::String(first->inputMaximum), "Maximum");
+    inputRangeEditor->addButton("OK", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    inputRangeEditor->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+    
+    juce::Component::SafePointer<MainComponent> safeThis(this);
+    
+    inputRangeEditor->enterModalState(true, juce::ModalCallbackFunction::create([safeThis, index](int result) {
+        if (safeThis == nullptr || result != 1)
+            return;
+        
+        const auto minimum = safeThis->inputRangeEditor->getTextEditorContents("min").trim();
+        const auto maximum = safeThis->inputRangeEditor->getTextEditorContents("max").trim();
+        
+        if (!minimum.containsOnly("0123456789.-+eE") || !maximum.containsOnly("0123456789.-+eE")
+            || minimum.isEmpty() || maximum.isEmpty() || minimum.getFloatValue() == maximum.getFloatValue())
+        {
+            safeThis->statusLabel.setText("Input range needs two different numbers", juce::dontSendNotification);
+            safeThis->statusLabel.setColour(juce::Label::textColourId, juce::Colours::red);
+            return;
+        }
+        
+        auto newMappings = safeThis->engine.getMapper().getMappings();
+        
+        for (auto& mapping : newMappings)
+        {
+            if (mapping.parameterIndex == index)
+            {
+                mapping.inputMinimum = minimum.getFloatValue();
+                mapping.inputMaximum = maximum.getFloatValue();
+            }
+        }
+        
+        safeThis->engine.setMappings(std::move(newMappings));
+        std::cout << "Set input range of " << safeThis->engine.getSchema()[index].address << " mappings to "
+                  << minimum << ".." << maximum << std::endl;
+    }), false);
 }
 
 bool MainComponent::validateIPAddress(const juce::String& ip)
@@ -500,15 +595,21 @@ void MainComponent::onApplyButtonClicked()
         return;
     }
     
+    if (!engine.setMirrorTargets(juce::StringArray::fromTokens(mirrorEditor.getText(), ",", "")))
+    {
+        statusLabel.setText("Error: Mirror targets must be host:port[/prefix] or unix:path", juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::red);
+        return;
+    }
+    
     // Update configuration
-    oscTargetHost = address;
-    oscTargetPort = portStr.getIntValue();
+    engine.setTarget(address, portStr.getIntValue());
     
     // Save and apply
-    saveConfiguration();
-    applyConfiguration();
+    engine.saveConfiguration();
+    engine.applyConfiguration();
     
-    statusLabel.setText("Configuration applied successfully!", juce::dontSendNotification);
-    statusLabel.setColour(juce::Label::textColourId, juce::Colours::green);
+    statusLabel.setText("Configuration saved, connecting...", juce::dontSendNotification);
+    statusLabel.setColour(juce::Label::textColourId, juce::Colours::yellow);
 }
 
@@ -3,47 +3,49 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <juce_osc/juce_osc.h>
 #include <iostream>
+#include "OSCEngine.h"
+#include "ParameterGrid.h"
+#include "ParameterSmoother.h"
+#include "PerformancePanel.h"
 
 class MainComponent : public juce::Component, 
-                      public juce::Timer,
-                      public juce::OSCReceiver::Listener<juce::OSCReceiver::MessageLoopCallback>
+                      public juce::Timer
 {
 public:
-    MainComponent();
-    MainComponent(const juce::String& cmdLineHost, int cmdLinePort);
+    explicit MainComponent(std::shared_ptr<const ParameterSchema> schemaToUse);
+    MainComponent(std::shared_ptr<const ParameterSchema> schemaToUse,
+                  const juce::String& cmdLineHost, int cmdLinePort,
+                  const juce::StringArray& cmdLineMirrors = {});
     ~MainComponent() override;
 
     void paint(juce::Graphics&) override;
     void resized() override;
     void timerCallback() override;
-    
-    // OSC Receiver callbacks
-    void oscMessageReceived(const juce::OSCMessage& message) override;
-    void oscBundleReceived(const juce::OSCBundle& bundle) override;
 
 private:
-    // OSC Server
-    juce::OSCReceiver oscReceiver;
-    static const int OSC_PORT = 7771;
+    // Receive, parameter-state and send pipelines
+    OSCEngine engine;
     
-    // OSC Client
-    juce::OSCSender oscSender;
-    juce::String oscTargetHost;
-    int oscTargetPort;
+    // Smooths incoming values into one update per frame
+    ParameterSmoother smoother;
+    juce::int64 lastFrameTicks = 0;
     
-    // Configuration persistence
-    std::unique_ptr<juce::PropertiesFile> properties;
-    void initializePropertiesFile();
-    void loadConfiguration();
-    void saveConfiguration();
-    void applyConfiguration();
     void onApplyButtonClicked();
+    void onStorePresetClicked();
+    void onRecallPresetClicked();
+    void updatePresetSelector();
+    void onRecordClicked();
+    void onPlayClicked();
+    void updateAutomationButtons();
     void initializeComponent();
+    void showConfiguration();
     bool validateIPAddress(const juce::String& ip);
     bool validatePort(const juce::String& portStr);
     
-    // Helper method to send OSC messages
-    void sendOscMessage(const juce::String& address, const juce::OSCMessage& message);
+    void applyParameterChange(int index, float value);
+    void onParameterChangedByUser(int index, float value);
+    void onMappingCommand(int index, ParameterGrid::MappingCommand command);
+    void showInputRangeEditor(int index);
     
     // Configuration UI Components
     juce::Label configTitleLabel;
@@ -51,36 +53,33 @@ private:
     juce::TextEditor addressEditor;
     juce::Label portLabel;
     juce::TextEditor portEditor;
+    juce::Label mirrorLabel;
+    juce::TextEditor mirrorEditor;
     juce::TextButton applyButton;
     juce::Label statusLabel;
     
-    // UI Components
-    juce::ToggleButton toggleButton;
-    juce::Label toggleLabel;
-    juce::Label toggleValueLabel;
-    
-    juce::Slider horizontalSlider;
-    juce::Label hSliderLabel;
-    juce::Label hSliderValueLabel;
+    // Preset UI Components
+    juce::Label presetLabel;
+    juce::ComboBox presetSelector;
+    juce::TextButton storePresetButton;
+    juce::TextButton recallPresetButton;
+    std::vector<int> recallChanges;
     
-    juce::Slider verticalSlider;
-    juce::Label vSliderLabel;
-    juce::Label vSliderValueLabel;
+    // Automation UI Components
+    juce::Label automationLabel;
+    juce::TextButton recordButton;
+    juce::TextButton playButton;
+    juce::Label automationStatusLabel;
+    bool wasPlaying = false;
     
-    juce::Slider knobSlider;
-    juce::Label knobLabel;
-    juce::Label knobValueLabel;
+    // Control surface generated from the schema
+    ParameterGrid parameterGrid;
     
-    // Update flags
-    std::atomic<bool> toggleNeedsUpdate{false};
-    std::atomic<bool> hsliderNeedsUpdate{false};
-    std::atomic<bool> vsliderNeedsUpdate{false};
-    std::atomic<bool> knobNeedsUpdate{false};
-    
-    std::atomic<int> newToggleValue{0};
-    std::atomic<float> newHSliderValue{0.0f};
-    std::atomic<float> newVSliderValue{0.0f};
-    std::atomic<float> newKnobValue{0.0f};
+    // Live rates, drops and latencies along the bottom
+    PerformancePanel performancePanel;
+
+    // Asks for the incoming range of a parameter's learned addresses; kept until the next one
+    std::unique_ptr<juce::AlertWindow> inputRangeEditor;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
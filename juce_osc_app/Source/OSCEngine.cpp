@@ -0,0 +1,368 @@
+#include "OSCEngine.h"
+#include "ParameterMessages.h"
+#include <juce_data_structures/juce_data_structures.h>
+
+OSCEngine::OSCEngine(std::shared_ptr<const ParameterSchema> schemaToUse)
+    : schema(std::move(schemaToUse)),
+      parameterState(schema->size()),
+      echoes(schema->size()),
+      scopes(schema->size()),
+      mapper(schema),
+      oscReceiver([this](const char* data, size_t size) { handlePacket(data, size); }),
+      localReceiver([this](const char* data, size_t size) { handlePacket(data, size); }),
+      player(schema, maxDatagramSize,
+             [this](const juce::String& prefix, const char* data, size_t size) { sendPacket(prefix, data, size); },
+             [this](int index, float value) {
+                 // Played-back values show up on the control surface like incoming ones,
+                 // and go out like any other sent value
+                 echoes.noteSent(index, ParameterMessages::getWireValue((*schema)[index], value));
+                 parameterState.set(index, value);
+                 scopes.push(index, value);
+             })
+{
+    initializeSettings();
+
+    // Learned mappings apply whichever way the target is configured
+    settings->whenLoaded([this] { loadMappings(); });
+
+    oscSender.onTargetsChanged = [this](const juce::StringArray& connected, const juce::StringArray& failed) {
+        if (!connected.isEmpty())
+            std::cout << "OSC Client initialized, sending to: " << connected.joinIntoString(", ") << std::endl;
+
+        if (!failed.isEmpty())
+            std::cerr << "ERROR: Failed to create OSC client for " << failed.joinIntoString(", ")
+                      << " (could not resolve host)" << std::endl;
+
+        if (onTargetStatusChanged)
+            onTargetStatusChanged(failed.isEmpty(), (failed.isEmpty() ? connected : failed).joinIntoString(", "));
+    };
+}
+
+OSCEngine::~OSCEngine()
+{
+    stopListening();
+}
+
+void OSCEngine::initializeSettings()
+{
+    // Same location and format as the juce::PropertiesFile used by earlier versions
+    juce::PropertiesFile::Options options;
+    options.applicationName = "OSCControlApp";
+    options.filenameSuffix = ".settings";
+    options.osxLibrarySubFolder = "Application Support";
+    options.folderName = juce::File::getSpecialLocation(
+        juce::File::userApplicationDataDirectory).getChildFile("OSCControlApp").getFullPathName();
+
+    // Read in the background; nothing blocks until a value is actually needed
+    settings = std::make_unique<SettingsStore>(options.getDefaultFile());
+}
+
+bool OSCEngine::startListening(int port)
+{
+    if (!oscReceiver.start(port))
+    {
+        std::cerr << "ERROR: Failed to create OSC server on port " << port << std::endl;
+        return false;
+    }
+
+    std::cout << "OSC Server started on port " << port << std::endl;
+    std::cout << "Listening for OSC messages on:" << std::endl;
+
+    const int numToList = juce::jmin(schema->size(), 16);
+
+    for (int i = 0; i < numToList; ++i)
+    {
+        const auto& spec = (*schema)[i];
+        const char* typeName = spec.type == ParameterSpec::Type::boolean ? "bool"
+                             : spec.type == ParameterSpec::Type::integer ? "integer" : "float";
+        std::cout << "  " << spec.address << " - " << typeName
+                  << " (" << spec.minimum << "-" << spec.maximum << ")" << std::endl;
+    }
+
+    if (schema->size() > numToList)
+        std::cout << "  ... and " << (schema->size() - numToList) << " more" << std::endl;
+
+    return true;
+}
+
+bool OSCEngine::startLocalListening(const juce::String& path)
+{
+    if (!localReceiver.startLocal(path.toStdString()))
+    {
+        std::cerr << "ERROR: Failed to bind local OSC socket " << path << std::endl;
+        return false;
+    }
+
+    std::cout << "Listening for OSC datagrams on local socket " << path << std::endl;
+    return true;
+}
+
+void OSCEngine::stopListening()
+{
+    oscReceiver.stop();
+    localReceiver.stop();
+}
+
+void OSCEngine::handlePacket(const char* data, size_t size)
+{
+    // Bundles are unpacked on the network thread; their messages are coalesced like any other
+    const bool wellFormed = OscPacketReader::forEachMessage(data, size, [this](const OscMessageView& message, uint64_t) {
+        handleIncomingMessage(message);
+    });
+
+    if (!wellFormed)
+        packetsMalformed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OSCEngine::handleIncomingMessage(const OscMessageView& message)
+{
+    // Runs on the network thread: no UI access and no logging per packet here,
+    // only validation and a lock-free store into parameterState
+    messagesReceived.fetch_add(1, std::memory_order_relaxed);
+
+    if (message.isEmpty())
+        return;
+
+    mapper.map(message, [this](int index, float value) {
+        // Our own value reflected back by a peer: applying it (and, with echo enabled,
+        // sending it again) would keep the loop going
+        if (echoes.isEcho(index, value))
+            return;
+
+        parameterState.set(index, value);
+        scopes.push(index, value);
+        recorder.record(index, value, false);
+    });
+}
+
+bool OSCEngine::sendParameter(int index, float value)
+{
+    const auto& spec = (*schema)[index];
+    recorder.record(index, value, true);
+    echoes.noteSent(index, ParameterMessages::getWireValue(spec, value));
+
+    // Called from the message thread and from worker threads, so each keeps its own buffer
+    thread_local OscPacketWriter writer;
+    writer.clear();
+    ParameterMessages::write(writer, spec, value);
+    return sendPacket(spec.address, writer.data(), writer.size());
+}
+
+bool OSCEngine::sendPacket(const juce::String& address, const char* data, size_t size)
+{
+    if (!oscSender.send(address, data, size))
+        return false;
+
+    messagesSent.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+int OSCEngine::sendParameters(const int* indices, int numIndices, const float* values)
+{
+    // Each bundle is routed by its messages' common address prefix; a mirror target filtered
+    // on a longer prefix gets a copy with just its messages. The bundles are collected and
+    // sent as one batch, which takes a single system call on Linux.
+    struct PackedBundle
+    {
+        size_t offset, size, prefixOffset;
+    };
+
+    thread_local std::vector<char> bundleData;
+    thread_local std::string prefixes; // NUL-separated
+    thread_local std::vector<PackedBundle> bundles;
+    bundleData.clear();
+    prefixes.clear();
+    bundles.clear();
+
+    OscBundlePacker packer(maxDatagramSize, [](std::string_view prefix, const char* data, size_t size) {
+        bundles.push_back({ bundleData.size(), size, prefixes.size() });
+        bundleData.insert(bundleData.end(), data, data + size);
+        prefixes.append(prefix).push_back('\0');
+    });
+
+    for (int i = 0; i < numIndices; ++i)
+    {
+        const auto& spec = (*schema)[indices[i]];
+        ParameterMessages::add(packer, spec, values[indices[i]]);
+        recorder.record(indices[i], values[indices[i]], true);
+        echoes.noteSent(indices[i], ParameterMessages::getWireValue(spec, values[indices[i]]));
+    }
+
+    packer.flush();
+
+    thread_local std::vector<AsyncOSCSender::BatchPacket> batch;
+    batch.clear();
+
+    for (const auto& bundle : bundles)
+        batch.push_back({ prefixes.data() + bundle.prefixOffset, bundleData.data() + bundle.offset, bundle.size });
+
+    // Counted in messages, as sendPacket() does, not in the bundles carrying them
+    if (oscSender.sendBatch(batch.data(), batch.size()))
+        messagesSent.fetch_add((juce::uint64) numIndices, std::memory_order_relaxed);
+
+    return (int) packer.getNumPacketsSent();
+}
+
+juce::Result OSCEngine::startRecording(const juce::File& file)
+{
+    return recorder.start(file, schema->getFingerprint());
+}
+
+juce::File OSCEngine::getDefaultAutomationFile() const
+{
+    return settings->getFile().getSiblingFile("automation.osclog");
+}
+
+juce::File OSCEngine::getDefaultPresetFile() const
+{
+    // One preset file per schema, next to the settings file
+    const auto fingerprint = schema->getFingerprint();
+    return settings->getFile().getSiblingFile("presets-" + juce::String::toHexString((juce::int64) fingerprint) + ".bin");
+}
+
+juce::Result OSCEngine::openPresets(const juce::File& file)
+{
+    return presets.open(file, schema->size(), schema->getFingerprint());
+}
+
+int OSCEngine::recallPreset(int slot, const float* currentValues, std::vector<int>& changedIndices)
+{
+    const float* target = presets.getValues(slot);
+
+    if (target == nullptr)
+        return 0;
+
+    changedIndices.resize((size_t) schema->size());
+    const int numChanged = PresetStore::findChanges(currentValues, target, schema->size(), changedIndices.data());
+
+    sendParameters(changedIndices.data(), numChanged, target);
+    return numChanged;
+}
+
+void OSCEngine::loadMappings()
+{
+    std::vector<AddressMapping> mappings;
+    const auto json = juce::JSON::parse(settings->getValue("oscMappings", "[]"));
+
+    if (auto* entries = json.getArray())
+    {
+        for (const auto& entry : *entries)
+        {
+            AddressMapping mapping;
+
+            if (AddressMapping::fromVar(entry, *schema, mapping))
+                mappings.push_back(mapping);
+        }
+    }
+
+    mapper.setMappings(std::move(mappings));
+}
+
+void OSCEngine::setMappings(std::vector<AddressMapping> mappings)
+{
+    mapper.setMappings(std::move(mappings));
+    saveMappings();
+}
+
+void OSCEngine::saveMappings()
+{
+    juce::Array<juce::var> entries;
+
+    for (const auto& mapping : mapper.getMappings())
+        entries.add(mapping.toVar(*schema));
+
+    settings->setValue("oscMappings", juce::JSON::toString(juce::var(entries), true));
+}
+
+bool OSCEngine::completeLearning(AddressMapping& learned)
+{
+    if (!mapper.completeLearning(learned))
+        return false;
+
+    saveMappings();
+    return true;
+}
+
+void OSCEngine::loadConfiguration()
+{
+    // Load saved configuration or use defaults
+    oscTargetHost = settings->getValue("oscTargetHost", "127.0.0.1");
+    oscTargetPort = settings->getIntValue("oscTargetPort", 7770);
+    echoes.setWindowMs(settings->getIntValue("oscEchoWindowMs", EchoSuppressor::defaultWindowMs));
+    multicastOptions.timeToLive = juce::jlimit(0, 255, settings->getIntValue("oscMulticastTtl", 1));
+    multicastOptions.interfaceName = settings->getValue("oscMulticastInterface");
+
+    if (!setMirrorTargets(juce::StringArray::fromLines(settings->getValue("oscMirrorTargets"))))
+        std::cerr << "Ignoring malformed mirror targets in settings" << std::endl;
+
+    std::cout << "Loaded configuration: " << oscTargetHost << ":" << oscTargetPort << std::endl;
+}
+
+void OSCEngine::loadConfigurationAsync(std::function<void()> onLoaded)
+{
+    settings->whenLoaded([this, onLoaded] {
+        loadConfiguration();
+
+        if (onLoaded)
+            onLoaded();
+    });
+}
+
+void OSCEngine::saveConfiguration()
+{
+    // Written to disk by the settings thread once edits have settled
+    settings->setValue("oscTargetHost", oscTargetHost);
+    settings->setValue("oscTargetPort", oscTargetPort);
+    settings->setValue("oscMirrorTargets", mirrorTargets.joinIntoString("\n"));
+    settings->setValue("oscEchoWindowMs", echoes.getWindowMs());
+    settings->setValue("oscMulticastTtl", multicastOptions.timeToLive);
+    settings->setValue("oscMulticastInterface", multicastOptions.interfaceName);
+
+    std::cout << "Saved configuration: " << oscTargetHost << ":" << oscTargetPort << std::endl;
+}
+
+void OSCEngine::setTarget(const juce::String& host, int port)
+{
+    oscTargetHost = host;
+    oscTargetPort = port;
+}
+
+bool OSCEngine::setMirrorTargets(const juce::StringArray& targets)
+{
+    juce::StringArray parsed;
+
+    for (const auto& entry : targets)
+    {
+        if (entry.trim().isEmpty())
+            continue;
+
+        AsyncOSCSender::Destination destination;
+
+        if (!AsyncOSCSender::Destination::fromString(entry, destination))
+            return false;
+
+        parsed.add(destination.toString());
+    }
+
+    mirrorTargets = parsed;
+    return true;
+}
+
+void OSCEngine::applyConfiguration()
+{
+    std::vector<AsyncOSCSender::Destination> destinations;
+    destinations.push_back({ oscTargetHost, oscTargetPort, {} });
+
+    for (const auto& entry : mirrorTargets)
+    {
+        AsyncOSCSender::Destination destination;
+
+        if (AsyncOSCSender::Destination::fromString(entry, destination))
+            destinations.push_back(destination);
+    }
+
+    // Resolution and connection happen on the sender's thread; until the new targets are
+    // ready, outgoing messages are queued rather than sent to the old ones or lost
+    oscSender.setMulticastOptions(multicastOptions);
+    oscSender.setTargets(destinations);
+}
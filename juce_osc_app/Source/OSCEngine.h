@@ -0,0 +1,195 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_osc/juce_osc.h>
+#include <iostream>
+#include <type_traits>
+#include "AddressMapper.h"
+#include "AsyncOSCSender.h"
+#include "AutomationLog.h"
+#include "DatagramReceiver.h"
+#include "EchoSuppressor.h"
+#include "OscBundlePacker.h"
+#include "OscPacketReader.h"
+#include "OscPacketWriter.h"
+#include "ParameterSchema.h"
+#include "ParameterScope.h"
+#include "PresetStore.h"
+#include "SettingsStore.h"
+#include "ParameterState.h"
+#include "LatencyHistogram.h"
+
+// The application's OSC pipeline without any UI: receives and validates messages on the
+// network thread, coalesces them in a ParameterState, and sends parameter changes to the
+// configured targets. MainComponent drives it from the message thread, and so does the
+// headless runner.
+class OSCEngine
+{
+public:
+    explicit OSCEngine(std::shared_ptr<const ParameterSchema> schemaToUse);
+    ~OSCEngine();
+
+    static const int OSC_PORT = 7771;
+
+    const ParameterSchema& getSchema() const noexcept { return *schema; }
+    std::shared_ptr<const ParameterSchema> getSchemaPtr() const noexcept { return schema; }
+
+    // Receiving
+    bool startListening(int port = OSC_PORT);
+    void stopListening();
+
+    // Also receives datagrams on an AF_UNIX socket at path, through the same pipeline as UDP.
+    // Stopped by stopListening().
+    bool startLocalListening(const juce::String& path);
+
+    // Message thread: calls callback(index, value) for each parameter changed since the last call,
+    // or callback(index, value, arrivalTicks) to also get when the change arrived.
+    // The time each change waited between arriving and being drained goes into getUpdateLatency().
+    template <typename Callback>
+    void drainChanges(Callback&& callback)
+    {
+        const auto now = juce::Time::getHighResolutionTicks();
+
+        parameterState.drainChanges([&](int index, float value, juce::int64 pendingSince) {
+            updateLatency.record(juce::Time::highResolutionTicksToSeconds(now - pendingSince) * 1000.0);
+
+            if constexpr (std::is_invocable_v<Callback, int, float, juce::int64>)
+                callback(index, value, pendingSince);
+            else
+                callback(index, value);
+        });
+    }
+
+    // Routes from incoming addresses to parameters. Mapping changes are saved to the settings.
+    const AddressMapper& getMapper() const noexcept { return mapper; }
+    void setMappings(std::vector<AddressMapping> mappings);
+    void startLearning(int parameterIndex) { mapper.startLearning(parameterIndex); }
+    void cancelLearning() { mapper.cancelLearning(); }
+
+    // Message thread: adds and saves the mapping once a message arrived in learn mode
+    bool completeLearning(AddressMapping& learned);
+
+    // Sample history for parameters with a scope view attached
+    ScopeBank& getScopes() noexcept { return scopes; }
+
+    // Target configuration, persisted in the application's settings file. loadConfiguration()
+    // waits for the settings file to be read; the async version calls onLoaded on the message
+    // thread once it has been.
+    void loadConfiguration();
+    void loadConfigurationAsync(std::function<void()> onLoaded);
+    void saveConfiguration();
+    void setTarget(const juce::String& host, int port);
+    void applyConfiguration();
+    juce::String getTargetHost() const { return oscTargetHost; }
+    int getTargetPort() const noexcept { return oscTargetPort; }
+
+    // Additional destinations mirroring the primary target, as "host:port[/prefix]" entries.
+    // Returns false (and changes nothing) if any entry is malformed.
+    bool setMirrorTargets(const juce::StringArray& targets);
+    juce::StringArray getMirrorTargets() const { return mirrorTargets; }
+
+    // Incoming values equal to one we sent for the same parameter within this many
+    // milliseconds are treated as echoes and dropped, which stops feedback loops with peers
+    // that reflect what they receive. 0 disables the check. Saved with the configuration.
+    void setEchoWindowMs(int milliseconds) noexcept { echoes.setWindowMs(milliseconds); }
+    int getEchoWindowMs() const noexcept { return echoes.getWindowMs(); }
+
+    // TTL and outgoing interface for targets that are multicast groups. Saved with the
+    // configuration; takes effect with the next applyConfiguration().
+    void setMulticastOptions(const AsyncOSCSender::MulticastOptions& options) { multicastOptions = options; }
+    const AsyncOSCSender::MulticastOptions& getMulticastOptions() const noexcept { return multicastOptions; }
+
+    // Message thread: called once the targets set by applyConfiguration are resolved (or failed)
+    std::function<void(bool ok, const juce::String& description)> onTargetStatusChanged;
+
+    // Sending; every packet is encoded once and fanned out to all matching targets
+    bool sendParameter(int index, float value);
+    bool sendPacket(const juce::String& address, const char* data, size_t size);
+
+    // Sends values[index] for each of the given parameter indices, packed into bundles that
+    // fit in one Ethernet frame. Returns the number of bundles sent.
+    int sendParameters(const int* indices, int numIndices, const float* values);
+    bool isSenderReady() const noexcept { return oscSender.isReady(); }
+
+    // Presets; call openPresets() before using them
+    juce::Result openPresets(const juce::File& file);
+    juce::File getDefaultPresetFile() const;
+    PresetStore& getPresets() noexcept { return presets; }
+
+    // Sends every parameter whose value in the preset differs from currentValues and writes
+    // their indices to changedIndices (resized to hold all parameters). Returns how many changed.
+    int recallPreset(int slot, const float* currentValues, std::vector<int>& changedIndices);
+
+    // Automation: records incoming and outgoing parameter changes, and plays recordings
+    // back with time-tagged bundles
+    juce::Result startRecording(const juce::File& file);
+    void stopRecording() { recorder.stop(); }
+    bool isRecording() const noexcept { return recorder.isRecording(); }
+    juce::Result startPlayback(const juce::File& file) { return player.start(file); }
+    void stopPlayback() { player.stop(); }
+    bool isPlaying() const noexcept { return player.isPlaying(); }
+    const AutomationRecorder& getRecorder() const noexcept { return recorder; }
+    const AutomationPlayer& getPlayer() const noexcept { return player; }
+    juce::File getDefaultAutomationFile() const;
+
+    // Largest UDP payload that fits in a 1500-byte Ethernet frame without fragmentation
+    static constexpr size_t maxDatagramSize = 1472;
+
+    // Counters for throughput measurements
+    juce::uint64 getNumMessagesReceived() const noexcept { return messagesReceived.load(std::memory_order_relaxed); }
+    juce::uint64 getNumMessagesSent() const noexcept { return messagesSent.load(std::memory_order_relaxed); }
+    juce::uint64 getNumMalformed() const noexcept { return packetsMalformed.load(std::memory_order_relaxed); }
+    juce::uint64 getNumCoalesced() const noexcept { return parameterState.getNumCoalesced(); }
+    juce::uint64 getNumEchoesSuppressed() const noexcept { return echoes.getNumSuppressed(); }
+    juce::uint64 getNumSendDropped() const noexcept { return oscSender.getNumDropped(); }
+    juce::uint64 getNumDatagramsSent() const noexcept { return oscSender.getNumDatagramsSent(); }
+    int getNumSendQueued() const noexcept { return oscSender.getNumQueued(); }
+
+    // Receive-to-drain latency of every change the message thread has picked up
+    const LatencyHistogram& getUpdateLatency() const noexcept { return updateLatency; }
+
+private:
+    // Network thread: decodes a packet in place and handles every message in it
+    void handlePacket(const char* data, size_t size);
+
+    // Validates one message and stores the result
+    void handleIncomingMessage(const OscMessageView& message);
+
+    void initializeSettings();
+    void loadMappings();
+    void saveMappings();
+
+    std::shared_ptr<const ParameterSchema> schema;
+
+    // Latest incoming values, coalesced until the next drain
+    ParameterState parameterState;
+    EchoSuppressor echoes;
+    ScopeBank scopes;
+    AddressMapper mapper;
+
+    // OSC Server
+    DatagramReceiver oscReceiver;
+    DatagramReceiver localReceiver;
+
+    // OSC Client; resolves and reconnects in the background
+    AsyncOSCSender oscSender;
+    juce::String oscTargetHost{"127.0.0.1"};
+    int oscTargetPort = 7770;
+    juce::StringArray mirrorTargets;
+    AsyncOSCSender::MulticastOptions multicastOptions;
+
+    // Configuration persistence
+    std::unique_ptr<SettingsStore> settings;
+    PresetStore presets;
+
+    std::atomic<juce::uint64> messagesReceived{0};
+    std::atomic<juce::uint64> messagesSent{0};
+    std::atomic<juce::uint64> packetsMalformed{0};
+    LatencyHistogram updateLatency;
+
+    // Declared last so their threads stop before anything they send through is destroyed
+    AutomationRecorder recorder;
+    AutomationPlayer player;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCEngine)
+};
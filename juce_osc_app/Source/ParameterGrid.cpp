@@ -0,0 +1,402 @@
+#include "ParameterGrid.h"
+#include <cmath>
+
+//==============================================================================
+// One recyclable control cell: a title, the control for the bound parameter's widget kind
+// and a value readout. Rebinding only swaps text, range and value.
+class ParameterGrid::Cell : public juce::Component
+{
+public:
+    explicit Cell(ParameterGrid& ownerToUse) : owner(ownerToUse)
+    {
+        addChildComponent(toggleButton);
+        toggleButton.setButtonText("Toggle");
+        toggleButton.onClick = [this] {
+            if (!binding)
+                owner.userChangedValue(index, toggleButton.getToggleState() ? spec->maximum : spec->minimum);
+        };
+
+        addChildComponent(slider);
+        slider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+        slider.onValueChange = [this] {
+            if (!binding)
+                owner.userChangedValue(index, spec->constrain((float) slider.getValue()));
+        };
+
+        addAndMakeVisible(titleLabel);
+        titleLabel.setJustificationType(juce::Justification::centred);
+        titleLabel.setInterceptsMouseClicks(false, false);
+
+        addAndMakeVisible(valueLabel);
+        valueLabel.setJustificationType(juce::Justification::centred);
+        valueLabel.setInterceptsMouseClicks(false, false);
+    }
+
+    // The area behind the control where a scope trace is drawn
+    juce::Rectangle<int> getScopeArea() const
+    {
+        return getLocalBounds().reduced(4).withTrimmedTop(25).withTrimmedBottom(25).reduced(6, 2);
+    }
+
+    void bind(int newIndex, const ParameterSpec& newSpec, float value)
+    {
+        const juce::ScopedValueSetter<bool> svs(binding, true);
+
+        index = newIndex;
+        spec = &newSpec;
+
+        titleLabel.setText(spec->label, juce::dontSendNotification);
+
+        const bool isToggle = spec->widget == ParameterSpec::Widget::toggle;
+        toggleButton.setVisible(isToggle);
+        slider.setVisible(!isToggle);
+
+        if (!isToggle)
+        {
+            switch (spec->widget)
+            {
+                case ParameterSpec::Widget::verticalSlider: slider.setSliderStyle(juce::Slider::LinearVertical); break;
+                case ParameterSpec::Widget::knob:           slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag); break;
+                default:                                    slider.setSliderStyle(juce::Slider::LinearHorizontal); break;
+            }
+
+            const double interval = spec->type == ParameterSpec::Type::floating
+                                        ? (spec->maximum - spec->minimum) / 100.0
+                                        : 1.0;
+            slider.setRange(spec->minimum, spec->maximum, interval);
+        }
+
+        resized();
+        showValue(value);
+    }
+
+    void showValue(float value)
+    {
+        const juce::ScopedValueSetter<bool> svs(binding, true);
+
+        if (spec->widget == ParameterSpec::Widget::toggle)
+        {
+            const bool state = value > spec->minimum;
+            toggleButton.setToggleState(state, juce::dontSendNotification);
+            valueLabel.setText(state ? "ON" : "OFF", juce::dontSendNotification);
+        }
+        else
+        {
+            slider.setValue(value, juce::dontSendNotification);
+            valueLabel.setText(spec->type == ParameterSpec::Type::floating ? juce::String(value, 2)
+                                                                           : juce::String((int) value),
+                               juce::dontSendNotification);
+        }
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.setColour(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId).brighter(0.05f));
+        g.fillRoundedRectangle(getLocalBounds().reduced(4).toFloat(), 6.0f);
+
+        owner.drawScope(g, getScopeArea(), index);
+
+        if (owner.learningIndex == index)
+        {
+            g.setColour(juce::Colours::yellow);
+            g.drawRoundedRectangle(getLocalBounds().reduced(4).toFloat(), 6.0f, 2.0f);
+        }
+    }
+
+    void mouseDown(const juce::MouseEvent& event) override
+    {
+        if (!event.mods.isPopupMenu())
+            return;
+
+        juce::PopupMenu menu;
+
+        if (owner.scopes != nullptr)
+            menu.addItem(1, "Show scope", true, owner.scopes->isEnabled(index));
+
+        if (owner.onMappingCommand)
+        {
+            menu.addSeparator();
+            menu.addItem(2, "Learn OSC address", true, owner.learningIndex == index);
+            menu.addItem(5, "Set input range of learned addresses...");
+            menu.addItem(3, "Invert learned addresses");
+            menu.addItem(4, "Clear learned addresses");
+        }
+
+        const int boundIndex = index;
+        juce::Component::SafePointer<ParameterGrid> safeOwner(&owner);
+
+        menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this), [safeOwner, boundIndex](int result) {
+            if (safeOwner == nullptr || result == 0)
+                return;
+
+            if (result == 1)
+                safeOwner->toggleScope(boundIndex);
+            else if (safeOwner->onMappingCommand)
+                safeOwner->onMappingCommand(boundIndex, result == 2 ? MappingCommand::learn
+                                                      : result == 3 ? MappingCommand::invert
+                                                      : result == 5 ? MappingCommand::editRange
+                                                                    : MappingCommand::clear);
+        });
+    }
+
+    void resized() override
+    {
+        if (spec == nullptr)
+            return;
+
+        auto bounds = getLocalBounds().reduced(4);
+        titleLabel.setBounds(bounds.removeFromTop(25));
+        valueLabel.setBounds(bounds.removeFromBottom(25));
+
+        if (spec->widget == ParameterSpec::Widget::toggle)
+            toggleButton.setBounds(bounds.withSizeKeepingCentre(juce::jmin(bounds.getWidth(), 100), 30));
+        else if (spec->widget == ParameterSpec::Widget::horizontalSlider)
+            slider.setBounds(bounds.withSizeKeepingCentre(bounds.getWidth() - 10, 30));
+        else
+            slider.setBounds(bounds.reduced(10));
+    }
+
+private:
+    ParameterGrid& owner;
+    const ParameterSpec* spec = nullptr;
+    int index = -1;
+    bool binding = false;
+
+    juce::Label titleLabel;
+    juce::Label valueLabel;
+    juce::ToggleButton toggleButton;
+    juce::Slider slider;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Cell)
+};
+
+//==============================================================================
+ParameterGrid::ParameterGrid(std::shared_ptr<const ParameterSchema> schemaToUse)
+    : schema(std::move(schemaToUse))
+{
+    values.reserve((size_t) schema->size());
+
+    for (int i = 0; i < schema->size(); ++i)
+        values.push_back((*schema)[i].defaultValue);
+
+    setScrollBarsShown(true, false);
+    setViewedComponent(&content, false);
+}
+
+ParameterGrid::~ParameterGrid()
+{
+    stopTimer();
+    setViewedComponent(nullptr, false);
+}
+
+void ParameterGrid::setScopeBank(ScopeBank* bankToUse)
+{
+    scopes = bankToUse;
+}
+
+void ParameterGrid::toggleScope(int index)
+{
+    if (scopes == nullptr)
+        return;
+
+    if (scopes->isEnabled(index))
+        scopes->disable(index);
+    else if (!scopes->enable(index))
+        return; // every scope slot is in use
+
+    repaintCell(index);
+
+    // Scopes scroll continuously, so keep repainting at display rate while any is shown
+    if (scopes->getNumEnabled() > 0)
+        startTimerHz(30);
+    else
+        stopTimer();
+}
+
+void ParameterGrid::setLearningParameter(int index)
+{
+    const int previous = learningIndex;
+    learningIndex = index;
+
+    repaintCell(previous);
+    repaintCell(index);
+}
+
+void ParameterGrid::repaintCell(int index)
+{
+    auto found = visibleCells.find(index);
+
+    if (found != visibleCells.end())
+        found->second->repaint();
+}
+
+void ParameterGrid::timerCallback()
+{
+    for (auto& entry : visibleCells)
+        if (scopes->isEnabled(entry.first))
+            entry.second->repaint(entry.second->getScopeArea());
+}
+
+void ParameterGrid::drawScope(juce::Graphics& g, juce::Rectangle<int> area, int index)
+{
+    const auto* ring = scopes != nullptr ? scopes->getRing(index) : nullptr;
+
+    if (ring == nullptr || area.isEmpty())
+        return;
+
+    const int capacity = ring->getCapacity();
+
+    if ((int) scopeTimes.size() < capacity)
+    {
+        scopeTimes.resize((size_t) capacity);
+        scopeValues.resize((size_t) capacity);
+    }
+
+    scopeColumns.resize((size_t) area.getWidth());
+
+    const int numSamples = ring->copyLatest(scopeTimes.data(), scopeValues.data(), capacity);
+    const double now = juce::Time::getMillisecondCounterHiRes();
+
+    decimateMinMax(scopeTimes.data(), scopeValues.data(), numSamples, now - scopeWindowMs, now,
+                   scopeColumns.data(), area.getWidth());
+
+    const auto& spec = (*schema)[index];
+    const float scale = (float) area.getHeight() / (spec.maximum - spec.minimum);
+    const float bottom = (float) area.getBottom();
+
+    g.setColour(juce::Colours::orange.withAlpha(0.6f));
+
+    // One vertical span per pixel column covering every sample that fell into it
+    for (int column = 0; column < area.getWidth(); ++column)
+    {
+        const auto range = scopeColumns[(size_t) column];
+
+        if (std::isnan(range.getStart()))
+            continue;
+
+        const float top = bottom - (range.getEnd() - spec.minimum) * scale;
+        const float height = juce::jmax(1.0f, (range.getEnd() - range.getStart()) * scale);
+        g.fillRect((float) (area.getX() + column), top, 1.0f, height);
+    }
+}
+
+void ParameterGrid::setValue(int index, float value)
+{
+    if (!juce::isPositiveAndBelow(index, (int) values.size()))
+        return;
+
+    values[(size_t) index] = value;
+
+    auto found = visibleCells.find(index);
+
+    if (found != visibleCells.end())
+        found->second->showValue(value);
+}
+
+float ParameterGrid::getValue(int index) const
+{
+    return juce::isPositiveAndBelow(index, (int) values.size()) ? values[(size_t) index] : 0.0f;
+}
+
+void ParameterGrid::resized()
+{
+    Viewport::resized();
+    updateContentSize();
+}
+
+void ParameterGrid::visibleAreaChanged(const juce::Rectangle<int>& /*newVisibleArea*/)
+{
+    updateVisibleCells();
+}
+
+void ParameterGrid::updateContentSize()
+{
+    const int width = getMaximumVisibleWidth();
+    const int columns = juce::jmax(1, width / cellWidth);
+    const int rows = (schema->size() + columns - 1) / columns;
+
+    if (columns != numColumns)
+    {
+        // Every cell's position changes, so rebind from scratch
+        numColumns = columns;
+
+        for (auto& entry : visibleCells)
+        {
+            entry.second->setVisible(false);
+            spareCells.push_back(entry.second);
+        }
+
+        visibleCells.clear();
+    }
+
+    content.setSize(width, rows * cellHeight);
+    updateVisibleCells();
+}
+
+void ParameterGrid::updateVisibleCells()
+{
+    const auto area = getViewArea();
+
+    if (area.isEmpty() || schema->size() == 0)
+        return;
+
+    const int firstRow = area.getY() / cellHeight;
+    const int lastRow = (area.getBottom() - 1) / cellHeight;
+    const int first = firstRow * numColumns;
+    const int last = juce::jmin(schema->size(), (lastRow + 1) * numColumns);
+
+    // Recycle cells that scrolled out of view
+    for (auto it = visibleCells.begin(); it != visibleCells.end();)
+    {
+        if (it->first < first || it->first >= last)
+        {
+            it->second->setVisible(false);
+            spareCells.push_back(it->second);
+            it = visibleCells.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Bind cells that scrolled into view, creating new ones only when the pool runs dry
+    for (int index = first; index < last; ++index)
+    {
+        if (visibleCells.count(index) != 0)
+            continue;
+
+        Cell* cell = nullptr;
+
+        if (!spareCells.empty())
+        {
+            cell = spareCells.back();
+            spareCells.pop_back();
+        }
+        else
+        {
+            cellPool.push_back(std::make_unique<Cell>(*this));
+            cell = cellPool.back().get();
+            content.addChildComponent(cell);
+        }
+
+        cell->setBounds((index % numColumns) * cellWidth, (index / numColumns) * cellHeight,
+                        cellWidth, cellHeight);
+        cell->bind(index, (*schema)[index], values[(size_t) index]);
+        cell->setVisible(true);
+        visibleCells[index] = cell;
+    }
+}
+
+void ParameterGrid::userChangedValue(int index, float value)
+{
+    values[(size_t) index] = value;
+
+    auto found = visibleCells.find(index);
+
+    if (found != visibleCells.end())
+        found->second->showValue(value);
+
+    if (onUserChange)
+        onUserChange(index, value);
+}
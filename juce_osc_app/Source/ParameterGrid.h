@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_gui_extra/juce_gui_extra.h>
+#include "ParameterSchema.h"
+#include "ParameterScope.h"
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Scrolling grid of parameter controls generated from a ParameterSchema. Only the cells
+// inside the visible area exist as components; they are recycled while scrolling, so the
+// component count (and memory) stays constant however many parameters the schema holds.
+class ParameterGrid : public juce::Viewport,
+                      private juce::Timer
+{
+public:
+    explicit ParameterGrid(std::shared_ptr<const ParameterSchema> schemaToUse);
+    ~ParameterGrid() override;
+
+    // Called on the message thread when the user moves a control
+    std::function<void(int index, float value)> onUserChange;
+
+    // Source of sample history for per-parameter scopes (right-click a cell to toggle one)
+    void setScopeBank(ScopeBank* bankToUse);
+
+    // Address mapping commands from a cell's right-click menu
+    enum class MappingCommand { learn, editRange, invert, clear };
+    std::function<void(int index, MappingCommand command)> onMappingCommand;
+
+    // Outlines the cell that is waiting to learn an address; -1 for none
+    void setLearningParameter(int index);
+
+    // Updates the displayed value; repaints only if the parameter's cell is on screen
+    void setValue(int index, float value);
+    float getValue(int index) const;
+
+    // Every parameter's displayed value, indexed like the schema
+    const std::vector<float>& getValues() const noexcept { return values; }
+
+    void resized() override;
+    void visibleAreaChanged(const juce::Rectangle<int>& newVisibleArea) override;
+
+    static constexpr int cellWidth = 180;
+    static constexpr int cellHeight = 160;
+    static constexpr double scopeWindowMs = 2000.0;
+
+private:
+    class Cell;
+
+    void updateContentSize();
+    void updateVisibleCells();
+    void userChangedValue(int index, float value);
+    void toggleScope(int index);
+    void repaintCell(int index);
+    void drawScope(juce::Graphics& g, juce::Rectangle<int> area, int index);
+    void timerCallback() override;
+
+    std::shared_ptr<const ParameterSchema> schema;
+    std::vector<float> values;
+
+    juce::Component content;
+    int numColumns = 1;
+
+    std::vector<std::unique_ptr<Cell>> cellPool;
+    std::unordered_map<int, Cell*> visibleCells;
+    std::vector<Cell*> spareCells;
+
+    // Scope drawing: history is copied into these buffers and reduced to one min/max per pixel
+    ScopeBank* scopes = nullptr;
+    int learningIndex = -1;
+    std::vector<double> scopeTimes;
+    std::vector<float> scopeValues;
+    std::vector<juce::Range<float>> scopeColumns;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterGrid)
+};
@@ -0,0 +1,32 @@
+#include "ParameterMessages.h"
+
+float ParameterMessages::getWireValue(const ParameterSpec& spec, float value) noexcept
+{
+    return spec.type == ParameterSpec::Type::floating ? value : (float) juce::roundToInt(value);
+}
+
+void ParameterMessages::write(OscPacketWriter& writer, const ParameterSpec& spec, float value)
+{
+    if (spec.type == ParameterSpec::Type::floating)
+    {
+        writer.beginMessage(spec.address.toRawUTF8(), "f");
+        writer.addFloat32(value);
+    }
+    else
+    {
+        writer.beginMessage(spec.address.toRawUTF8(), "i");
+        writer.addInt32(juce::roundToInt(value));
+    }
+
+    writer.endMessage();
+}
+
+void ParameterMessages::add(OscBundlePacker& packer, const ParameterSpec& spec, float value, juce::uint64 timeTag)
+{
+    if (spec.type == ParameterSpec::Type::floating)
+        packer.beginMessage(spec.address.toRawUTF8(), "f", 4, timeTag).addFloat32(value);
+    else
+        packer.beginMessage(spec.address.toRawUTF8(), "i", 4, timeTag).addInt32(juce::roundToInt(value));
+
+    packer.endMessage();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "OscBundlePacker.h"
+#include "OscPacketWriter.h"
+#include "ParameterSchema.h"
+
+// How a parameter value goes on the wire, shared by the engine's sends and automation
+// playback: floating parameters as a float32 argument, boolean and integer ones rounded to
+// an int32, each addressed to the parameter's address.
+namespace ParameterMessages
+{
+    // The value a receiver sees after the parameter has been encoded
+    float getWireValue(const ParameterSpec& spec, float value) noexcept;
+
+    // Writes one message for the parameter
+    void write(OscPacketWriter& writer, const ParameterSpec& spec, float value);
+
+    // Appends one message to a bundle stream, optionally scheduled at timeTag
+    void add(OscBundlePacker& packer, const ParameterSpec& spec, float value,
+             juce::uint64 timeTag = OscPacketWriter::immediately);
+}
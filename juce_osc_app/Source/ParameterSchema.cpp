@@ -0,0 +1,191 @@
+#include "ParameterSchema.h"
+#include <cmath>
+
+float ParameterSpec::constrain(float value) const noexcept
+{
+    if (std::isnan(value))
+        return defaultValue;
+
+    value = juce::jlimit(minimum, maximum, value);
+
+    if (type == Type::boolean)
+        return value >= 0.5f * (minimum + maximum) ? maximum : minimum;
+
+    if (type == Type::integer)
+        return std::round(value);
+
+    return value;
+}
+
+ParameterSchema ParameterSchema::createDefault()
+{
+    ParameterSchema schema;
+
+    auto makeSpec = [](const char* address, const char* label, ParameterSpec::Type type,
+                       ParameterSpec::Widget widget, float defaultValue)
+    {
+        ParameterSpec spec;
+        spec.address = address;
+        spec.label = label;
+        spec.type = type;
+        spec.widget = widget;
+        spec.defaultValue = defaultValue;
+        return spec;
+    };
+
+    schema.add(makeSpec("/toggle", "Toggle Control", ParameterSpec::Type::boolean,
+                        ParameterSpec::Widget::toggle, 0.0f));
+    // The continuous controls are usually driven by jittery high-rate sources
+    auto makeSmoothedSpec = [&makeSpec](const char* address, const char* label, ParameterSpec::Widget widget)
+    {
+        auto spec = makeSpec(address, label, ParameterSpec::Type::floating, widget, 0.5f);
+        spec.smoothing = ParameterSpec::Smoothing::interpolate;
+        return spec;
+    };
+
+    schema.add(makeSmoothedSpec("/hslider", "Horizontal Slider", ParameterSpec::Widget::horizontalSlider));
+    schema.add(makeSmoothedSpec("/vslider", "Vertical Slider", ParameterSpec::Widget::verticalSlider));
+    schema.add(makeSmoothedSpec("/knob", "Knob Control", ParameterSpec::Widget::knob));
+
+    return schema;
+}
+
+juce::Result ParameterSchema::loadFromFile(const juce::File& file, ParameterSchema& result)
+{
+    if (!file.existsAsFile())
+        return juce::Result::fail("Schema file not found: " + file.getFullPathName());
+
+    juce::var json;
+    auto parseResult = juce::JSON::parse(file.loadFileAsString(), json);
+
+    if (parseResult.failed())
+        return juce::Result::fail("Invalid JSON in " + file.getFileName() + ": " + parseResult.getErrorMessage());
+
+    return parse(json, result);
+}
+
+juce::Result ParameterSchema::parse(const juce::var& json, ParameterSchema& result)
+{
+    // Accept either { "parameters": [...] } or a bare array
+    const auto* entries = json.isArray() ? json.getArray() : json["parameters"].getArray();
+
+    if (entries == nullptr)
+        return juce::Result::fail("Schema must contain a \"parameters\" array");
+
+    ParameterSchema schema;
+    schema.parameters.reserve((size_t) entries->size());
+    schema.addressToIndex.reserve((size_t) entries->size());
+
+    for (int i = 0; i < entries->size(); ++i)
+    {
+        const auto& entry = entries->getReference(i);
+        auto fail = [i](const juce::String& message)
+        {
+            return juce::Result::fail("parameter " + juce::String(i) + ": " + message);
+        };
+
+        ParameterSpec spec;
+        spec.address = entry["address"].toString();
+
+        if (!spec.address.startsWithChar('/'))
+            return fail("address must start with '/'");
+
+        if (spec.address.containsAnyOf(" #*,?[]{}"))
+            return fail("address contains characters not allowed in an OSC address: " + spec.address);
+
+        if (schema.indexOf(spec.address) >= 0)
+            return fail("duplicate address " + spec.address);
+
+        spec.label = entry.hasProperty("label") ? entry["label"].toString() : spec.address;
+
+        const auto type = entry.hasProperty("type") ? entry["type"].toString() : juce::String("float");
+
+        if (type == "bool")
+            spec.type = ParameterSpec::Type::boolean;
+        else if (type == "int")
+            spec.type = ParameterSpec::Type::integer;
+        else if (type == "float")
+            spec.type = ParameterSpec::Type::floating;
+        else
+            return fail("unknown type \"" + type + "\"");
+
+        const auto defaultWidget = spec.type == ParameterSpec::Type::boolean ? "toggle" : "hslider";
+        const auto widget = entry.hasProperty("widget") ? entry["widget"].toString() : juce::String(defaultWidget);
+
+        if (widget == "toggle")
+            spec.widget = ParameterSpec::Widget::toggle;
+        else if (widget == "hslider")
+            spec.widget = ParameterSpec::Widget::horizontalSlider;
+        else if (widget == "vslider")
+            spec.widget = ParameterSpec::Widget::verticalSlider;
+        else if (widget == "knob")
+            spec.widget = ParameterSpec::Widget::knob;
+        else
+            return fail("unknown widget \"" + widget + "\"");
+
+        spec.minimum = entry.hasProperty("min") ? (float) entry["min"] : 0.0f;
+        spec.maximum = entry.hasProperty("max") ? (float) entry["max"] : 1.0f;
+
+        if (!(spec.minimum < spec.maximum))
+            return fail("min must be less than max");
+
+        spec.defaultValue = spec.constrain(entry.hasProperty("default") ? (float) entry["default"]
+                                                                         : spec.minimum);
+
+        const auto smoothing = entry.hasProperty("smoothing") ? entry["smoothing"].toString() : juce::String("none");
+
+        if (smoothing == "none")
+            spec.smoothing = ParameterSpec::Smoothing::none;
+        else if (smoothing == "linear")
+            spec.smoothing = ParameterSpec::Smoothing::linear;
+        else if (smoothing == "onepole")
+            spec.smoothing = ParameterSpec::Smoothing::onePole;
+        else if (smoothing == "interpolate")
+            spec.smoothing = ParameterSpec::Smoothing::interpolate;
+        else
+            return fail("unknown smoothing \"" + smoothing + "\"");
+
+        if (spec.smoothing != ParameterSpec::Smoothing::none && spec.type != ParameterSpec::Type::floating)
+            return fail("smoothing only applies to float parameters");
+
+        if (entry.hasProperty("smoothingMs"))
+            spec.smoothingMs = (float) entry["smoothingMs"];
+
+        if (!(spec.smoothingMs > 0.0f))
+            return fail("smoothingMs must be positive");
+        schema.add(spec);
+    }
+
+    result = std::move(schema);
+    return juce::Result::ok();
+}
+
+int ParameterSchema::indexOf(const juce::String& address) const
+{
+    auto found = addressToIndex.find(address);
+    return found != addressToIndex.end() ? found->second : -1;
+}
+
+juce::uint64 ParameterSchema::getFingerprint() const noexcept
+{
+    // FNV-1a over every address, each terminated by its null byte
+    juce::uint64 hash = 14695981039346656037ull;
+
+    for (const auto& spec : parameters)
+    {
+        const char* address = spec.address.toRawUTF8();
+
+        do
+        {
+            hash = (hash ^ (juce::uint8) *address) * 1099511628211ull;
+        } while (*address++ != 0);
+    }
+
+    return hash;
+}
+
+void ParameterSchema::add(const ParameterSpec& spec)
+{
+    addressToIndex[spec.address] = (int) parameters.size();
+    parameters.push_back(spec);
+}
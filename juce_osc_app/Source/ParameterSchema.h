@@ -0,0 +1,66 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <unordered_map>
+#include <vector>
+
+// Description of one OSC-controllable parameter
+struct ParameterSpec
+{
+    enum class Type { boolean, integer, floating };
+    enum class Widget { toggle, horizontalSlider, verticalSlider, knob };
+    enum class Smoothing { none, linear, onePole, interpolate };
+
+    juce::String address;
+    juce::String label;
+    Type type = Type::floating;
+    Widget widget = Widget::horizontalSlider;
+    float minimum = 0.0f;
+    float maximum = 1.0f;
+    float defaultValue = 0.0f;
+
+    // How incoming values are smoothed before they reach the control and any forwarded
+    // output; smoothingMs is the ramp time, time constant or longest interpolation interval
+    Smoothing smoothing = Smoothing::none;
+    float smoothingMs = 50.0f;
+
+    // Clamps (and for boolean/integer parameters, rounds) a value into this parameter's range
+    float constrain(float value) const noexcept;
+};
+
+// The set of parameters shown on the control surface, loaded from a JSON schema file:
+//
+//   { "parameters": [ { "address": "/knob", "type": "float", "min": 0, "max": 1,
+//                       "widget": "knob", "label": "Knob Control", "default": 0.5,
+//                       "smoothing": "interpolate", "smoothingMs": 100 } ] }
+//
+// "type" is one of bool, int, float and "widget" one of toggle, hslider, vslider, knob.
+// "smoothing" (float parameters only) is one of none, linear, onepole, interpolate.
+class ParameterSchema
+{
+public:
+    ParameterSchema() = default;
+
+    // The four controls the application has always offered: /toggle, /hslider, /vslider, /knob
+    static ParameterSchema createDefault();
+
+    static juce::Result loadFromFile(const juce::File& file, ParameterSchema& result);
+    static juce::Result parse(const juce::var& json, ParameterSchema& result);
+
+    int size() const noexcept { return (int) parameters.size(); }
+    const ParameterSpec& operator[](int index) const noexcept { return parameters[(size_t) index]; }
+
+    // Returns the index of the parameter with this exact address, or -1. Safe to call from
+    // any thread once the schema has been built.
+    int indexOf(const juce::String& address) const;
+
+    // Hash of the addresses in order, which ties preset files and automation logs to the
+    // schema they were made with
+    juce::uint64 getFingerprint() const noexcept;
+
+    void add(const ParameterSpec& spec);
+
+private:
+    std::vector<ParameterSpec> parameters;
+    std::unordered_map<juce::String, int> addressToIndex;
+};
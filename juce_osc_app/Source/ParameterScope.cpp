@@ -0,0 +1,162 @@
+#include "ParameterScope.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+//==============================================================================
+SampleRing::SampleRing(int capacityPowerOfTwo)
+    : capacity(juce::nextPowerOfTwo(juce::jmax(16, capacityPowerOfTwo))),
+      mask((juce::uint64) capacity - 1),
+      sampleTimes(new double[(size_t) capacity]),
+      sampleValues(new float[(size_t) capacity])
+{
+}
+
+void SampleRing::push(double timeMs, float value) noexcept
+{
+    const auto position = writeCount.load(std::memory_order_relaxed);
+    sampleTimes[(size_t) (position & mask)] = timeMs;
+    sampleValues[(size_t) (position & mask)] = value;
+    writeCount.store(position + 1, std::memory_order_release);
+}
+
+int SampleRing::copyLatest(double* times, float* values, int maxSamples) const noexcept
+{
+    const auto end = writeCount.load(std::memory_order_acquire);
+    const auto oldestKept = clearedCount.load(std::memory_order_relaxed);
+    auto available = juce::jmin(end - oldestKept, (juce::uint64) capacity, (juce::uint64) juce::jmax(0, maxSamples));
+    auto start = end - available;
+
+    // Copy in at most two contiguous runs
+    for (juce::uint64 copied = 0; copied < available;)
+    {
+        const auto offset = (size_t) ((start + copied) & mask);
+        const auto run = (size_t) juce::jmin(available - copied, (juce::uint64) capacity - offset);
+        std::memcpy(times + copied, sampleTimes.get() + offset, run * sizeof(double));
+        std::memcpy(values + copied, sampleValues.get() + offset, run * sizeof(float));
+        copied += run;
+    }
+
+    // Anything older than one capacity behind the current write position may have been
+    // overwritten while copying: drop it from the front
+    const auto endAfterCopy = writeCount.load(std::memory_order_acquire);
+
+    if (endAfterCopy - start > (juce::uint64) capacity)
+    {
+        const auto overwritten = juce::jmin(available, endAfterCopy - start - (juce::uint64) capacity);
+        available -= overwritten;
+        std::memmove(times, times + overwritten, (size_t) available * sizeof(double));
+        std::memmove(values, values + overwritten, (size_t) available * sizeof(float));
+    }
+
+    return (int) available;
+}
+
+void SampleRing::clear() noexcept
+{
+    clearedCount.store(writeCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+//==============================================================================
+ScopeBank::ScopeBank(int numParametersToUse, int maxScopes)
+    : numParameters(numParametersToUse),
+      slotForParameter(new std::atomic<juce::int16>[(size_t) juce::jmax(1, numParametersToUse)]),
+      rings((size_t) juce::jlimit(1, 32767, maxScopes)),
+      slotInUse(rings.size(), false)
+{
+    for (int i = 0; i < numParameters; ++i)
+        slotForParameter[(size_t) i].store(-1, std::memory_order_relaxed);
+}
+
+bool ScopeBank::enable(int parameterIndex)
+{
+    if (!juce::isPositiveAndBelow(parameterIndex, numParameters))
+        return false;
+
+    if (isEnabled(parameterIndex))
+        return true;
+
+    for (size_t slot = 0; slot < slotInUse.size(); ++slot)
+    {
+        if (slotInUse[slot])
+            continue;
+
+        // Rings are never freed, so a producer still holding an old slot number can only
+        // ever write into a valid ring; clearing hides anything it wrote before the switch
+        if (rings[slot] == nullptr)
+            rings[slot] = std::make_unique<SampleRing>();
+
+        rings[slot]->clear();
+        slotInUse[slot] = true;
+        ++numEnabled;
+        slotForParameter[(size_t) parameterIndex].store((juce::int16) slot, std::memory_order_release);
+        return true;
+    }
+
+    return false;
+}
+
+void ScopeBank::disable(int parameterIndex)
+{
+    if (!isEnabled(parameterIndex))
+        return;
+
+    const auto slot = slotForParameter[(size_t) parameterIndex].exchange(-1, std::memory_order_acq_rel);
+    slotInUse[(size_t) slot] = false;
+    --numEnabled;
+}
+
+bool ScopeBank::isEnabled(int parameterIndex) const noexcept
+{
+    return juce::isPositiveAndBelow(parameterIndex, numParameters)
+        && slotForParameter[(size_t) parameterIndex].load(std::memory_order_relaxed) >= 0;
+}
+
+const SampleRing* ScopeBank::getRing(int parameterIndex) const noexcept
+{
+    if (!juce::isPositiveAndBelow(parameterIndex, numParameters))
+        return nullptr;
+
+    const int slot = slotForParameter[(size_t) parameterIndex].load(std::memory_order_relaxed);
+    return slot >= 0 ? rings[(size_t) slot].get() : nullptr;
+}
+
+//==============================================================================
+int decimateMinMax(const double* times, const float* values, int numSamples,
+                   double startTime, double endTime,
+                   juce::Range<float>* columns, int numColumns) noexcept
+{
+    if (numColumns <= 0 || !(endTime > startTime))
+        return 0;
+
+    const double columnsPerMs = numColumns / (endTime - startTime);
+    float lastValue = std::numeric_limits<float>::quiet_NaN();
+    int sample = 0;
+    int columnsWithData = 0;
+
+    // Skip samples before the window, but remember the last one so the trace starts connected
+    while (sample < numSamples && times[sample] < startTime)
+        lastValue = values[sample++];
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const double columnEnd = startTime + (column + 1) / columnsPerMs;
+        const int first = sample;
+
+        while (sample < numSamples && times[sample] < columnEnd)
+            ++sample;
+
+        if (sample > first)
+        {
+            columns[column] = juce::FloatVectorOperations::findMinAndMax(values + first, sample - first);
+            lastValue = values[sample - 1];
+            ++columnsWithData;
+        }
+        else
+        {
+            columns[column] = juce::Range<float>(lastValue, lastValue);
+        }
+    }
+
+    return columnsWithData;
+}
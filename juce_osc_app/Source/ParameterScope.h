@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Single-producer, single-consumer ring of timestamped samples of one parameter.
+// The network thread pushes every incoming value; the message thread copies out the most
+// recent samples for drawing. Times and values are stored separately so the values can be
+// scanned with vector operations.
+class SampleRing
+{
+public:
+    explicit SampleRing(int capacityPowerOfTwo = 8192);
+
+    // Producer side (network thread)
+    void push(double timeMs, float value) noexcept;
+
+    // Consumer side: copies up to maxSamples of the newest samples into times/values in
+    // chronological order and returns how many were copied. Samples the producer overwrote
+    // during the copy are discarded.
+    int copyLatest(double* times, float* values, int maxSamples) const noexcept;
+
+    // Consumer side: forget everything pushed so far
+    void clear() noexcept;
+
+    juce::uint64 getNumPushed() const noexcept { return writeCount.load(std::memory_order_acquire); }
+    int getCapacity() const noexcept { return capacity; }
+
+private:
+    const int capacity;
+    const juce::uint64 mask;
+    std::unique_ptr<double[]> sampleTimes;
+    std::unique_ptr<float[]> sampleValues;
+    std::atomic<juce::uint64> writeCount{0};
+    std::atomic<juce::uint64> clearedCount{0};
+
+    JUCE_DECLARE_NON_COPYABLE(SampleRing)
+};
+
+// Fixed pool of sample rings that can be attached to any parameter. The network thread
+// looks up a parameter's ring with one relaxed load, so parameters without a scope pay
+// almost nothing.
+class ScopeBank
+{
+public:
+    explicit ScopeBank(int numParameters, int maxScopes = 64);
+
+    // Message thread
+    bool enable(int parameterIndex);
+    void disable(int parameterIndex);
+    bool isEnabled(int parameterIndex) const noexcept;
+    const SampleRing* getRing(int parameterIndex) const noexcept;
+    int getNumEnabled() const noexcept { return numEnabled; }
+
+    // Network thread: records the value with the current time if the parameter has a scope
+    void push(int parameterIndex, float value) noexcept
+    {
+        const int slot = slotForParameter[(size_t) parameterIndex].load(std::memory_order_acquire);
+
+        if (slot >= 0)
+            rings[(size_t) slot]->push(juce::Time::getMillisecondCounterHiRes(), value);
+    }
+
+private:
+    const int numParameters;
+    std::unique_ptr<std::atomic<juce::int16>[]> slotForParameter;
+    std::vector<std::unique_ptr<SampleRing>> rings;
+    std::vector<bool> slotInUse;
+    int numEnabled = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeBank)
+};
+
+// Reduces samples in [startTime, endTime) to one min/max range per output column, using
+// SIMD min/max over each column's run of contiguous samples. Columns without samples hold
+// an empty range at the previous column's last value (or NaN if there was none yet).
+// times must be ascending. Returns the number of columns that contain data.
+int decimateMinMax(const double* times, const float* values, int numSamples,
+                   double startTime, double endTime,
+                   juce::Range<float>* columns, int numColumns) noexcept;
@@ -0,0 +1,152 @@
+#include "ParameterSmoother.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static constexpr float unlimitedRate = std::numeric_limits<float>::max();
+
+ParameterSmoother::ParameterSmoother(const ParameterSchema& schema)
+    : numParameters(schema.size()),
+      numBlocks((schema.size() + blockSize - 1) / blockSize)
+{
+    const auto padded = (size_t) (numBlocks * blockSize);
+
+    current.assign(padded, 0.0f);
+    target.assign(padded, 0.0f);
+    lagMs.assign(padded, 0.0f);
+    ratePerMs.assign(padded, unlimitedRate);
+    epsilon.assign(padded, 0.0f);
+
+    modes.resize((size_t) numParameters);
+    smoothingMs.resize((size_t) numParameters);
+    lastArrival.assign((size_t) numParameters, 0);
+    blockActive.assign((size_t) numBlocks, false);
+    changed.reserve(padded);
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        const auto& spec = schema[i];
+        current[(size_t) i] = target[(size_t) i] = spec.defaultValue;
+        epsilon[(size_t) i] = (spec.maximum - spec.minimum) * 1.0e-4f;
+        modes[(size_t) i] = spec.type == ParameterSpec::Type::floating ? spec.smoothing : ParameterSpec::Smoothing::none;
+        smoothingMs[(size_t) i] = spec.smoothingMs;
+    }
+}
+
+void ParameterSmoother::setTarget(int index, float value, juce::int64 arrivalTicks) noexcept
+{
+    if (!juce::isPositiveAndBelow(index, numParameters))
+        return;
+
+    const auto i = (size_t) index;
+
+    if (arrivalTicks == 0)
+        arrivalTicks = juce::Time::getHighResolutionTicks();
+
+    const float distance = std::abs(value - current[i]);
+    float rampMs = smoothingMs[i];
+
+    if (modes[i] == ParameterSpec::Smoothing::interpolate && lastArrival[i] != 0)
+    {
+        // Spread the step over the time the source took to send it
+        const auto intervalMs = (float) (juce::Time::highResolutionTicksToSeconds(arrivalTicks - lastArrival[i]) * 1000.0);
+        rampMs = juce::jlimit(1.0f, smoothingMs[i], intervalMs);
+    }
+
+    lastArrival[i] = arrivalTicks;
+    target[i] = value;
+
+    switch (modes[i])
+    {
+        case ParameterSpec::Smoothing::linear:
+        case ParameterSpec::Smoothing::interpolate:
+            lagMs[i] = 0.0f;
+            ratePerMs[i] = distance / rampMs;
+            break;
+
+        case ParameterSpec::Smoothing::onePole:
+            lagMs[i] = smoothingMs[i];
+            ratePerMs[i] = unlimitedRate;
+            break;
+
+        case ParameterSpec::Smoothing::none:
+        default:
+            lagMs[i] = 0.0f;
+            ratePerMs[i] = unlimitedRate;
+            break;
+    }
+
+    activate(index);
+}
+
+void ParameterSmoother::jumpTo(int index, float value) noexcept
+{
+    if (!juce::isPositiveAndBelow(index, numParameters))
+        return;
+
+    current[(size_t) index] = target[(size_t) index] = value;
+}
+
+void ParameterSmoother::activate(int index) noexcept
+{
+    const auto block = (size_t) (index / blockSize);
+
+    if (!blockActive[block])
+    {
+        blockActive[block] = true;
+        ++numActiveBlocks;
+    }
+}
+
+void ParameterSmoother::advance(float elapsedMs) noexcept
+{
+    changed.clear();
+
+    const float dt = elapsedMs;
+
+    if (numActiveBlocks == 0 || !(dt > 0.0f))
+        return;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        if (!blockActive[(size_t) block])
+            continue;
+
+        const auto offset = (size_t) (block * blockSize);
+        float* __restrict out = current.data() + offset;
+        const float* __restrict goal = target.data() + offset;
+        const float* __restrict lag = lagMs.data() + offset;
+        const float* __restrict rate = ratePerMs.data() + offset;
+        const float* __restrict snap = epsilon.data() + offset;
+
+        float before[blockSize];
+        std::copy(out, out + blockSize, before);
+
+        // Branch-free so it vectorises: one-pole step limited by the ramp rate, then snapped
+        // onto the target once within epsilon
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const float delta = goal[i] - out[i];
+            const float maxStep = std::min(rate[i] * dt, unlimitedRate);
+            const float step = std::min(std::max(delta * (dt / (lag[i] + dt)), -maxStep), maxStep);
+            const float next = out[i] + step;
+            out[i] = std::abs(goal[i] - next) <= snap[i] ? goal[i] : next;
+        }
+
+        bool moving = false;
+
+        for (int i = 0; i < blockSize; ++i)
+        {
+            if (out[i] != before[i])
+                changed.push_back(block * blockSize + i);
+
+            moving |= out[i] != goal[i];
+        }
+
+        if (!moving)
+        {
+            blockActive[(size_t) block] = false;
+            --numActiveBlocks;
+        }
+    }
+}
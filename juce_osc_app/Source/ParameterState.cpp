@@ -0,0 +1,50 @@
+#include "ParameterState.h"
+#include <thread>
+
+ParameterState::ParameterState(int numParametersToUse)
+    : numParameters(juce::jmax(1, numParametersToUse)),
+      slots(new Slot[(size_t) numParameters])
+{
+    const auto capacity = (juce::uint32) juce::nextPowerOfTwo(numParameters);
+    queueMask = capacity - 1;
+    queue.reset(new std::atomic<int>[capacity]);
+
+    for (juce::uint32 i = 0; i < capacity; ++i)
+        queue[i].store(-1, std::memory_order_relaxed);
+}
+
+void ParameterState::set(int index, float value) noexcept
+{
+    if (!juce::isPositiveAndBelow(index, numParameters))
+        return;
+
+    auto& slot = slots[(size_t) index];
+    slot.value.store(value, std::memory_order_release);
+
+    if (slot.pending.exchange(true, std::memory_order_acq_rel))
+    {
+        // Already queued; the drain will pick up the newer value
+        numCoalesced.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Published to the drain by the release store of the queue cell below
+    slot.pendingSince.store(juce::Time::getHighResolutionTicks(), std::memory_order_relaxed);
+
+    const auto position = writePosition.fetch_add(1, std::memory_order_relaxed);
+    auto& cell = queue[(size_t) (position & queueMask)];
+
+    // Only reachable if the consumer is a full ring behind, which the pending flag prevents
+    while (cell.load(std::memory_order_acquire) >= 0)
+        std::this_thread::yield();
+
+    cell.store(index, std::memory_order_release);
+}
+
+float ParameterState::get(int index) const noexcept
+{
+    if (!juce::isPositiveAndBelow(index, numParameters))
+        return 0.0f;
+
+    return slots[(size_t) index].value.load(std::memory_order_acquire);
+}
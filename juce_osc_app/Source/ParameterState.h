@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+
+// Latest value of every parameter, written from the OSC network thread and drained
+// by the message thread. A parameter is queued at most once between two drains, so the
+// UI cost per frame depends on how many parameters changed, not on the packet rate.
+class ParameterState
+{
+public:
+    explicit ParameterState(int numParameters);
+
+    int size() const noexcept { return numParameters; }
+
+    // Any thread: store a new value and queue the parameter unless it is already pending.
+    void set(int index, float value) noexcept;
+    float get(int index) const noexcept;
+
+    // Number of changes that replaced a value the message thread had not picked up yet
+    juce::uint64 getNumCoalesced() const noexcept { return numCoalesced.load(std::memory_order_relaxed); }
+
+    // Message thread: calls callback(index, value, pendingSinceTicks) once for every parameter
+    // that changed since the previous drain, with the most recent value and the high-resolution
+    // tick count at which its first undrained change arrived.
+    template <typename Callback>
+    void drainChanges(Callback&& callback)
+    {
+        for (;;)
+        {
+            auto& cell = queue[(size_t) (readPosition & queueMask)];
+            const int index = cell.load(std::memory_order_acquire);
+
+            if (index < 0)
+                break;
+
+            cell.store(-1, std::memory_order_release);
+            ++readPosition;
+
+            auto& slot = slots[(size_t) index];
+            const auto pendingSince = slot.pendingSince.load(std::memory_order_relaxed);
+            slot.pending.store(false, std::memory_order_release);
+            callback(index, slot.value.load(std::memory_order_acquire), pendingSince);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<float> value{0.0f};
+        std::atomic<bool> pending{false};
+        std::atomic<juce::int64> pendingSince{0};
+    };
+
+    const int numParameters;
+    std::unique_ptr<Slot[]> slots;
+
+    // Multi-producer, single-consumer ring of pending parameter indices (-1 = empty cell).
+    // Its capacity covers every parameter, so producers never wait in practice.
+    std::unique_ptr<std::atomic<int>[]> queue;
+    juce::uint32 queueMask = 0;
+    std::atomic<juce::uint32> writePosition{0};
+    juce::uint32 readPosition = 0;
+
+    std::atomic<juce::uint64> numCoalesced{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterState)
+};
@@ -0,0 +1,81 @@
+#include "PerformancePanel.h"
+
+PerformancePanel::PerformancePanel(const OSCEngine& engineToWatch)
+    : engine(engineToWatch)
+{
+    setOpaque(true);
+    previous = readCounters();
+    lines.add("Collecting statistics...");
+    startTimer(refreshIntervalMs);
+}
+
+void PerformancePanel::recordFrame(double workMs) noexcept
+{
+    frameWork.record(workMs);
+
+    const auto now = juce::Time::getHighResolutionTicks();
+
+    if (lastFrameTicks != 0)
+        maxFrameIntervalMs = juce::jmax(maxFrameIntervalMs, juce::Time::highResolutionTicksToSeconds(now - lastFrameTicks) * 1000.0);
+
+    lastFrameTicks = now;
+}
+
+PerformancePanel::Counters PerformancePanel::readCounters() const
+{
+    Counters counters;
+    counters.received = engine.getNumMessagesReceived();
+    counters.sent = engine.getNumMessagesSent();
+    counters.datagrams = engine.getNumDatagramsSent();
+    counters.coalesced = engine.getNumCoalesced();
+    counters.echoes = engine.getNumEchoesSuppressed();
+    counters.malformed = engine.getNumMalformed();
+    counters.sendDropped = engine.getNumSendDropped();
+    counters.recordDropped = engine.getRecorder().getNumDropped();
+    counters.latency = engine.getUpdateLatency().getSnapshot();
+    counters.frameWork = frameWork.getSnapshot();
+    counters.timeSeconds = juce::Time::getMillisecondCounterHiRes() / 1000.0;
+    return counters;
+}
+
+void PerformancePanel::timerCallback()
+{
+    const auto current = readCounters();
+    const auto elapsed = juce::jmax(0.001, current.timeSeconds - previous.timeSeconds);
+    const auto latency = current.latency - previous.latency;
+    const auto work = current.frameWork - previous.frameWork;
+
+    auto rate = [elapsed](juce::uint64 now, juce::uint64 before) { return juce::String((double) (now - before) / elapsed, 0); };
+    auto ms = [](double value) { return juce::String(value, 2) + " ms"; };
+
+    lines.clearQuick();
+    lines.add("In " + rate(current.received, previous.received) + " msg/s   Out "
+              + rate(current.sent, previous.sent) + " msg/s (" + rate(current.datagrams, previous.datagrams)
+              + " datagrams/s)   Send queue " + juce::String(engine.getNumSendQueued()));
+    lines.add("Coalesced " + juce::String((juce::int64) current.coalesced)
+              + "   Echoes suppressed " + juce::String((juce::int64) current.echoes)
+              + "   Dropped: send " + juce::String((juce::int64) current.sendDropped)
+              + ", recording " + juce::String((juce::int64) current.recordDropped)
+              + "   Malformed " + juce::String((juce::int64) current.malformed));
+    lines.add("Receive-to-UI p50 " + ms(latency.getPercentileMs(0.5)) + "  p99 " + ms(latency.getPercentileMs(0.99))
+              + "  max " + ms(latency.getPercentileMs(1.0))
+              + "   Frame p50 " + ms(work.getPercentileMs(0.5)) + "  p99 " + ms(work.getPercentileMs(0.99))
+              + "  longest gap " + ms(maxFrameIntervalMs));
+
+    previous = current;
+    maxFrameIntervalMs = 0.0;
+    repaint();
+}
+
+void PerformancePanel::paint(juce::Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId).darker(0.2f));
+    g.setColour(juce::Colours::lightgrey);
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+
+    auto bounds = getLocalBounds().reduced(10, 4);
+    const int lineHeight = bounds.getHeight() / juce::jmax(1, lines.size());
+
+    for (const auto& line : lines)
+        g.drawText(line, bounds.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+}
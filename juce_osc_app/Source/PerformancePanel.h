@@ -0,0 +1,43 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "OSCEngine.h"
+#include "LatencyHistogram.h"
+
+// Live view of the engine's counters. Everything it shows is read from relaxed atomics and
+// lock-free histograms, so the network and sender threads never wait on the panel.
+// Rates and percentiles cover the interval since the previous refresh.
+class PerformancePanel : public juce::Component,
+                         private juce::Timer
+{
+public:
+    explicit PerformancePanel(const OSCEngine& engineToWatch);
+
+    // Message thread, once per UI frame: workMs is how long the frame's update took
+    void recordFrame(double workMs) noexcept;
+
+    void paint(juce::Graphics&) override;
+
+    static constexpr int refreshIntervalMs = 500;
+
+private:
+    struct Counters
+    {
+        juce::uint64 received = 0, sent = 0, datagrams = 0, coalesced = 0, echoes = 0, malformed = 0, sendDropped = 0, recordDropped = 0;
+        LatencyHistogram::Snapshot latency, frameWork;
+        double timeSeconds = 0.0;
+    };
+
+    void timerCallback() override;
+    Counters readCounters() const;
+
+    const OSCEngine& engine;
+    LatencyHistogram frameWork;
+    juce::int64 lastFrameTicks = 0;
+    double maxFrameIntervalMs = 0.0;
+
+    Counters previous;
+    juce::StringArray lines;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformancePanel)
+};
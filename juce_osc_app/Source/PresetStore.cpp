@@ -0,0 +1,194 @@
+#include "PresetStore.h"
+#include <atomic>
+#include <cstring>
+
+#if JUCE_MSVC
+ #include <intrin.h>
+#endif
+
+struct PresetStore::FileHeader
+{
+    char magic[4];
+    juce::uint32 version;
+    juce::uint32 numParameters;
+    juce::uint32 numSlots;
+    juce::uint64 schemaFingerprint;
+    char reserved[40];
+};
+
+struct PresetStore::SlotHeader
+{
+    juce::uint32 used;
+    juce::uint32 reserved;
+    char name[maxNameLength + 1];
+    // followed by numParameters floats
+};
+
+static constexpr char presetMagic[4] = { 'O', 'S', 'C', 'P' };
+static constexpr juce::uint32 presetVersion = 1;
+
+// The used flag publishes a slot's name and values: it is stored with release and loaded with
+// acquire semantics, so whoever sees it set also sees what it covers
+static juce::uint32 loadUsed(const juce::uint32* used) noexcept
+{
+   #if JUCE_MSVC
+    return (juce::uint32) _InterlockedOr(reinterpret_cast<volatile long*>(const_cast<juce::uint32*>(used)), 0);
+   #else
+    return __atomic_load_n(used, __ATOMIC_ACQUIRE);
+   #endif
+}
+
+static void storeUsed(juce::uint32* used, juce::uint32 value) noexcept
+{
+   #if JUCE_MSVC
+    _InterlockedExchange(reinterpret_cast<volatile long*>(used), (long) value);
+   #else
+    __atomic_store_n(used, value, __ATOMIC_RELEASE);
+   #endif
+}
+
+juce::Result PresetStore::open(const juce::File& file, int numParametersToUse, juce::uint64 schemaFingerprint,
+                               int numSlotsToUse)
+{
+    static_assert(sizeof(FileHeader) == 64 && sizeof(SlotHeader) == 64, "preset file layout changed");
+
+    mappedFile.reset();
+
+    // Slots start on cache-line boundaries
+    const size_t stride = ((sizeof(SlotHeader) + (size_t) numParametersToUse * sizeof(float)) + 63) & ~(size_t) 63;
+
+    if (!file.existsAsFile())
+    {
+        FileHeader header{};
+        std::memcpy(header.magic, presetMagic, sizeof(presetMagic));
+        header.version = presetVersion;
+        header.numParameters = (juce::uint32) numParametersToUse;
+        header.numSlots = (juce::uint32) numSlotsToUse;
+        header.schemaFingerprint = schemaFingerprint;
+
+        file.getParentDirectory().createDirectory();
+        juce::FileOutputStream out(file);
+
+        if (out.failedToOpen()
+            || !out.write(&header, sizeof(header))
+            || !out.writeRepeatedByte(0, stride * (size_t) numSlotsToUse))
+        {
+            file.deleteFile();
+            return juce::Result::fail("Could not create preset file " + file.getFullPathName());
+        }
+    }
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite);
+
+    if (mapped->getData() == nullptr || mapped->getSize() < sizeof(FileHeader))
+        return juce::Result::fail("Could not map preset file " + file.getFullPathName());
+
+    const auto& header = *static_cast<const FileHeader*>(mapped->getData());
+
+    if (std::memcmp(header.magic, presetMagic, sizeof(presetMagic)) != 0 || header.version != presetVersion)
+        return juce::Result::fail(file.getFullPathName() + " is not a preset file");
+
+    if (header.numParameters != (juce::uint32) numParametersToUse || header.schemaFingerprint != schemaFingerprint)
+        return juce::Result::fail(file.getFullPathName() + " was created for a different parameter schema");
+
+    if (mapped->getSize() < sizeof(FileHeader) + stride * header.numSlots)
+        return juce::Result::fail(file.getFullPathName() + " is truncated");
+
+    mappedFile = std::move(mapped);
+    numParameters = numParametersToUse;
+    numSlots = (int) header.numSlots;
+    slotStride = stride;
+    return juce::Result::ok();
+}
+
+PresetStore::SlotHeader* PresetStore::getSlot(int slot) const noexcept
+{
+    if (mappedFile == nullptr || !juce::isPositiveAndBelow(slot, numSlots))
+        return nullptr;
+
+    auto* base = static_cast<char*>(mappedFile->getData()) + sizeof(FileHeader);
+    return reinterpret_cast<SlotHeader*>(base + slotStride * (size_t) slot);
+}
+
+bool PresetStore::isUsed(int slot) const noexcept
+{
+    const auto* header = getSlot(slot);
+    return header != nullptr && loadUsed(&header->used) != 0;
+}
+
+juce::String PresetStore::getName(int slot) const
+{
+    const auto* header = getSlot(slot);
+
+    if (header == nullptr || loadUsed(&header->used) == 0)
+        return {};
+
+    return juce::String::fromUTF8(header->name, (int) strnlen(header->name, sizeof(header->name)));
+}
+
+const float* PresetStore::getValues(int slot) const noexcept
+{
+    const auto* header = getSlot(slot);
+
+    if (header == nullptr || loadUsed(&header->used) == 0)
+        return nullptr;
+
+    return reinterpret_cast<const float*>(header + 1);
+}
+
+bool PresetStore::store(int slot, const juce::String& name, const float* values) noexcept
+{
+    auto* header = getSlot(slot);
+
+    if (header == nullptr)
+        return false;
+
+    // Mark the slot empty while it is rewritten, so if the process dies part way through, the
+    // slot reads as empty rather than half-written. The mapping is never flushed explicitly:
+    // the system writes the pages back in its own time and order, so this does not protect
+    // against losing power.
+    storeUsed(&header->used, 0);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(header + 1, values, (size_t) numParameters * sizeof(float));
+
+    std::memset(header->name, 0, sizeof(header->name));
+    name.copyToUTF8(header->name, sizeof(header->name));
+
+    storeUsed(&header->used, 1);
+    return true;
+}
+
+void PresetStore::erase(int slot) noexcept
+{
+    if (auto* header = getSlot(slot))
+        storeUsed(&header->used, 0);
+}
+
+int PresetStore::findChanges(const float* current, const float* target, int numValues, int* changedIndices) noexcept
+{
+    constexpr int blockSize = 16;
+    int numChanged = 0;
+    int i = 0;
+
+    for (; i + blockSize <= numValues; i += blockSize)
+    {
+        // Most of a recall is usually unchanged; skip equal blocks with one compare
+        if (std::memcmp(current + i, target + i, blockSize * sizeof(float)) == 0)
+            continue;
+
+        for (int j = i; j < i + blockSize; ++j)
+        {
+            changedIndices[numChanged] = j;
+            numChanged += current[j] != target[j] ? 1 : 0;
+        }
+    }
+
+    for (; i < numValues; ++i)
+    {
+        changedIndices[numChanged] = i;
+        numChanged += current[i] != target[i] ? 1 : 0;
+    }
+
+    return numChanged;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+
+// Fixed number of preset slots kept in one memory-mapped file. Each slot holds a name and
+// a snapshot of every parameter value as a flat float array, so storing a preset is one
+// memcpy and recalling it needs no parsing. Values are stored in native byte order.
+//
+// The file is tied to a schema by the fingerprint of its addresses; a store opened for a
+// different schema is rejected rather than recalled into the wrong parameters.
+class PresetStore
+{
+public:
+    static constexpr int defaultNumSlots = 128;
+    static constexpr int maxNameLength = 55;
+
+    PresetStore() = default;
+
+    // Opens the store, creating it with numSlots empty slots if the file doesn't exist
+    juce::Result open(const juce::File& file, int numParameters, juce::uint64 schemaFingerprint,
+                      int numSlots = defaultNumSlots);
+
+    bool isOpen() const noexcept { return mappedFile != nullptr; }
+    int getNumSlots() const noexcept { return numSlots; }
+    int getNumParameters() const noexcept { return numParameters; }
+
+    bool isUsed(int slot) const noexcept;
+    juce::String getName(int slot) const;
+
+    // Returns nullptr for empty slots
+    const float* getValues(int slot) const noexcept;
+
+    bool store(int slot, const juce::String& name, const float* values) noexcept;
+    void erase(int slot) noexcept;
+
+    // Writes the indices at which current and target differ to changedIndices, which must have
+    // room for numValues entries, and returns how many there are. Unchanged runs are skipped
+    // a block at a time.
+    static int findChanges(const float* current, const float* target, int numValues, int* changedIndices) noexcept;
+
+private:
+    struct FileHeader;
+    struct SlotHeader;
+
+    SlotHeader* getSlot(int slot) const noexcept;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    int numParameters = 0;
+    int numSlots = 0;
+    size_t slotStride = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetStore)
+};
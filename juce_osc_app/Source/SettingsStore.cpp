@@ -0,0 +1,197 @@
+#include "SettingsStore.h"
+#include <iostream>
+
+SettingsStore::SettingsStore(const juce::File& fileToUse, int debounceMilliseconds)
+    : juce::Thread("Settings writer"),
+      file(fileToUse),
+      debounceMs(debounceMilliseconds)
+{
+    startThread();
+}
+
+SettingsStore::~SettingsStore()
+{
+    *alive = false;
+    signalThreadShouldExit();
+    notify();
+    stopThread(5000);
+
+    // Covers changes made after the thread's final write, and a thread that never got going
+    flush();
+}
+
+void SettingsStore::whenLoaded(std::function<void()> callback)
+{
+    if (isLoaded())
+        callback();
+    else
+        loadedCallbacks.push_back(std::move(callback));
+}
+
+juce::String SettingsStore::getValue(const juce::String& key, const juce::String& defaultValue) const
+{
+    loaded.wait();
+
+    const juce::ScopedLock sl(valueLock);
+    return values.containsKey(key) ? values[key] : defaultValue;
+}
+
+int SettingsStore::getIntValue(const juce::String& key, int defaultValue) const
+{
+    loaded.wait();
+
+    const juce::ScopedLock sl(valueLock);
+    return values.containsKey(key) ? values[key].getIntValue() : defaultValue;
+}
+
+void SettingsStore::setValue(const juce::String& key, const juce::var& value)
+{
+    loaded.wait();
+
+    {
+        const juce::ScopedLock sl(valueLock);
+        const auto text = value.toString();
+
+        if (values.containsKey(key) && values[key] == text)
+            return;
+
+        values.set(key, text);
+        ++changeCount;
+
+        // Every change pushes the write back, so a burst of edits costs one write
+        saveDueTime = juce::Time::getMillisecondCounter() + (juce::uint32) debounceMs;
+    }
+
+    notify();
+}
+
+bool SettingsStore::flush()
+{
+    loaded.wait();
+    return writeSnapshot();
+}
+
+void SettingsStore::run()
+{
+    load();
+
+    juce::MessageManager::callAsync([this, isAlive = alive] {
+        if (!*isAlive)
+            return;
+
+        auto callbacks = std::move(loadedCallbacks);
+        loadedCallbacks.clear();
+
+        for (auto& callback : callbacks)
+            callback();
+    });
+
+    while (!threadShouldExit())
+    {
+        int waitMs = -1;
+        bool writeNow = false;
+
+        {
+            const juce::ScopedLock sl(valueLock);
+
+            if (changeCount != savedCount)
+            {
+                const auto remaining = (int) (saveDueTime - juce::Time::getMillisecondCounter());
+                writeNow = remaining <= 0;
+                waitMs = juce::jmax(1, remaining);
+            }
+        }
+
+        if (writeNow && !writeSnapshot())
+        {
+            // Keep the changes and try again later, e.g. once the disk has space again
+            std::cerr << "ERROR: Could not save settings to " << file.getFullPathName() << std::endl;
+
+            const juce::ScopedLock sl(valueLock);
+            saveDueTime = juce::Time::getMillisecondCounter() + 5000;
+        }
+
+        wait(waitMs);
+    }
+}
+
+void SettingsStore::load()
+{
+    juce::StringPairArray loadedValues;
+
+    if (auto xml = juce::parseXMLIfTagMatches(file, "PROPERTIES"))
+    {
+        for (auto* element : xml->getChildWithTagNameIterator("VALUE"))
+        {
+            const auto key = element->getStringAttribute("name");
+
+            if (key.isEmpty())
+                continue;
+
+            // PropertiesFile stores XML values as a child element instead of an attribute
+            if (auto* child = element->getFirstChildElement())
+                loadedValues.set(key, child->toString(juce::XmlElement::TextFormat().singleLine().withoutHeader()));
+            else
+                loadedValues.set(key, element->getStringAttribute("val"));
+        }
+    }
+
+    {
+        const juce::ScopedLock sl(valueLock);
+        values = loadedValues;
+    }
+
+    loaded.signal();
+}
+
+bool SettingsStore::writeSnapshot()
+{
+    const juce::ScopedLock wl(writeLock);
+
+    juce::StringPairArray snapshot;
+    juce::uint64 snapshotCount;
+
+    {
+        const juce::ScopedLock sl(valueLock);
+
+        if (changeCount == savedCount)
+            return true;
+
+        snapshot = values;
+        snapshotCount = changeCount;
+    }
+
+    juce::XmlElement root("PROPERTIES");
+
+    for (int i = 0; i < snapshot.size(); ++i)
+    {
+        auto* element = root.createNewChildElement("VALUE");
+        element->setAttribute("name", snapshot.getAllKeys()[i]);
+        element->setAttribute("val", snapshot.getAllValues()[i]);
+    }
+
+    file.getParentDirectory().createDirectory();
+
+    // Written and synced under a temporary name, then renamed over the original in one step
+    juce::TemporaryFile temporary(file);
+
+    {
+        juce::FileOutputStream out(temporary.getFile());
+
+        if (out.failedToOpen())
+            return false;
+
+        root.writeTo(out);
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    if (!temporary.overwriteTargetFileWithTemporary())
+        return false;
+
+    const juce::ScopedLock sl(valueLock);
+    savedCount = juce::jmax(savedCount, snapshotCount);
+    return true;
+}
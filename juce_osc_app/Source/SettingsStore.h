@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Key/value settings stored in the same XML format as juce::PropertiesFile, without ever
+// touching the disk on the caller's thread.
+//
+// The file is read on a background thread as soon as the store is created, so opening a
+// window never waits for it. Changes only update the in-memory copy; once no change has
+// been made for the debounce interval, the same thread writes a snapshot to a temporary
+// file, syncs it and renames it over the original, so a crash leaves either the old or the
+// new settings but never a truncated file.
+class SettingsStore : private juce::Thread
+{
+public:
+    explicit SettingsStore(const juce::File& fileToUse, int debounceMilliseconds = 500);
+
+    // Writes any pending change before returning
+    ~SettingsStore() override;
+
+    const juce::File& getFile() const noexcept { return file; }
+
+    // Message thread: calls callback once the file has been read (right away if it already has)
+    void whenLoaded(std::function<void()> callback);
+    bool isLoaded() const { return loaded.wait(0); }
+
+    // Any thread. Getters wait for the initial read if it hasn't finished yet.
+    juce::String getValue(const juce::String& key, const juce::String& defaultValue = {}) const;
+    int getIntValue(const juce::String& key, int defaultValue = 0) const;
+    void setValue(const juce::String& key, const juce::var& value);
+
+    // Writes every change made so far immediately; returns false if the write failed
+    bool flush();
+
+private:
+    void run() override;
+    void load();
+    bool writeSnapshot();
+
+    const juce::File file;
+    const int debounceMs;
+
+    juce::WaitableEvent loaded{true};
+    std::vector<std::function<void()>> loadedCallbacks; // message thread only
+
+    juce::CriticalSection valueLock;
+    juce::StringPairArray values;
+    juce::uint64 changeCount = 0;
+    juce::uint64 savedCount = 0;
+    juce::uint32 saveDueTime = 0;
+
+    juce::CriticalSection writeLock;
+
+    // Cleared on destruction so pending notifications on the message thread become no-ops
+    std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsStore)
+};
@@ -0,0 +1,547 @@
+#include "HostBenchmarks.h"
+#include <juce_core/juce_core.h>
+#include "OscPacketReader.h"
+#include "OscPacketValidator.h"
+#include "OscPacketWriter.h"
+#include "PriorityDispatcher.h"
+#include "SourceRateLimiter.h"
+#include "UringUdpReceiver.h"
+#include "XdpUdpReceiver.h"
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int numSenders = 2;
+
+    // CPU time used by the calling thread, so the senders are left out
+    double getThreadCpuSeconds()
+    {
+        timespec now{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return (double) now.tv_sec + (double) now.tv_nsec * 1.0e-9;
+    }
+
+    struct ReceiveResult
+    {
+        std::atomic<juce::uint64> messages{0};
+        juce::uint64 systemCalls = 0;
+        double cpuSeconds = 0.0;
+        std::string error;
+    };
+
+    // Decodes like OSCHost does before dispatch, so each backend does the same work per packet
+    void countMessages(const char* data, size_t size, ReceiveResult& result)
+    {
+        OscPacketReader::forEachMessage(data, size, [&result](const OscMessageView&, uint64_t) {
+            result.messages.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    void receiveByPolling(juce::DatagramSocket& socket, const std::atomic<bool>& receiving, ReceiveResult& result)
+    {
+        std::vector<char> buffer(65536);
+
+        while (receiving.load(std::memory_order_relaxed))
+        {
+            const int ready = socket.waitUntilReady(true, 100);
+            ++result.systemCalls;
+
+            if (ready < 0)
+                break;
+
+            if (ready == 0)
+                continue;
+
+            const int bytesRead = socket.read(buffer.data(), (int) buffer.size(), false);
+            ++result.systemCalls;
+
+            if (bytesRead > 0)
+                countMessages(buffer.data(), (size_t) bytesRead, result);
+        }
+    }
+
+    void receiveWithUring(juce::DatagramSocket& socket, const std::atomic<bool>& receiving, ReceiveResult& result)
+    {
+        UringUdpReceiver receiver;
+
+        if (!receiver.open((int) socket.getRawSocketHandle(), "127.0.0.1", 7771))
+        {
+            result.error = receiver.getError();
+            return;
+        }
+
+        const bool finished = receiver.run([&receiving] { return !receiving.load(std::memory_order_relaxed); },
+                                           [&result](const char* data, size_t size, uint32_t, uint16_t, OscReplyChannel&) {
+                                               countMessages(data, size, result);
+                                           });
+
+        if (!finished)
+            result.error = receiver.getError();
+
+        result.systemCalls = receiver.getNumWaits();
+    }
+
+    // Generic mode on lo: shows the cost of the user-space side, not what a native driver gains
+    void receiveWithXdp(juce::DatagramSocket& socket, const std::atomic<bool>& receiving, ReceiveResult& result)
+    {
+        XdpUdpReceiver receiver;
+
+        if (!receiver.open("lo", 0, socket.getBoundPort(), XdpUdpReceiver::Mode::generic))
+        {
+            result.error = receiver.getError();
+            return;
+        }
+
+        if (!receiver.run([&receiving] { return !receiving.load(std::memory_order_relaxed); },
+                          [&result](const char* data, size_t size, uint32_t, uint16_t) { countMessages(data, size, result); }))
+            result.error = receiver.getError();
+
+        result.systemCalls = receiver.getNumWaits();
+    }
+}
+
+void HostBenchmarks::runUdpBackends(double secondsPerRun)
+{
+    std::cout << "UDP receive backend benchmark, " << secondsPerRun << " s per run, "
+              << numSenders << " loopback senders" << std::endl;
+
+    OscPacketWriter writer;
+    writer.beginMessage("/sensor/1/level", "f");
+    writer.addFloat32(0.5f);
+    writer.endMessage();
+
+    using ReceiveFunction = void (*)(juce::DatagramSocket&, const std::atomic<bool>&, ReceiveResult&);
+    const std::pair<const char*, ReceiveFunction> backends[] { { "poll", receiveByPolling },
+                                                               { "io_uring", receiveWithUring },
+                                                               { "AF_XDP", receiveWithXdp } };
+
+    for (const auto& backend : backends)
+    {
+        juce::DatagramSocket socket(false);
+
+        if (!socket.bindToPort(0, "127.0.0.1"))
+        {
+            std::cerr << "ERROR: Could not bind loopback UDP socket" << std::endl;
+            return;
+        }
+
+        ReceiveResult result;
+        std::atomic<bool> receiving { true }, sending { true };
+        std::atomic<juce::uint64> sent { 0 };
+
+        std::thread receiver([&] {
+            const double startCpu = getThreadCpuSeconds();
+
+            backend.second(socket, receiving, result);
+            result.cpuSeconds = getThreadCpuSeconds() - startCpu;
+        });
+
+        std::vector<std::thread> senders;
+
+        for (int i = 0; i < numSenders; ++i)
+        {
+            senders.emplace_back([&] {
+                juce::DatagramSocket sender(false);
+                juce::uint64 count = 0;
+
+                while (sending.load(std::memory_order_relaxed))
+                    if (sender.write("127.0.0.1", socket.getBoundPort(), writer.data(), (int) writer.size()) > 0)
+                        ++count;
+
+                sent.fetch_add(count);
+            });
+        }
+
+        juce::Thread::sleep((int) (secondsPerRun * 1000.0));
+        const juce::uint64 receivedInTime = result.messages.load();
+        sending = false;
+
+        for (auto& sender : senders)
+            sender.join();
+
+        juce::Thread::sleep(100); // let the receiver drain what is still queued
+        receiving = false;
+        receiver.join();
+
+        if (!result.error.empty())
+        {
+            std::cout << "  " << juce::String(backend.first).paddedRight(' ', 8) << ": unavailable ("
+                      << result.error << ")" << std::endl;
+            continue;
+        }
+
+        const double received = (double) juce::jmax((juce::uint64) 1, result.messages.load());
+
+        std::cout << "  " << juce::String(backend.first).paddedRight(' ', 8) << ": "
+                  << juce::String((double) sent.load() / secondsPerRun, 0) << " msg/s sent, "
+                  << juce::String((double) receivedInTime / secondsPerRun, 0) << " msg/s received, "
+                  << juce::String(result.cpuSeconds * 1.0e9 / received, 0) << " ns receiver CPU per message, "
+                  << juce::String((double) result.systemCalls / received, 3) << " system calls per message"
+                  << std::endl;
+    }
+}
+
+void HostBenchmarks::runPriorityClasses(double secondsPerRun)
+{
+    constexpr double dispatchCostMs = 0.005;
+
+    std::cout << "Priority class benchmark, " << secondsPerRun << " s per run, "
+              << dispatchCostMs * 1000.0 << " us dispatch per packet, sensor flood plus /ping every 1 ms" << std::endl;
+
+    PriorityDispatcher::PriorityClass health, sensors;
+    PriorityDispatcher::PriorityClass::parse("health:/ping:8:256", health);
+    PriorityDispatcher::PriorityClass::parse("sensors:/sensor:1:4096", sensors);
+
+    const std::pair<const char*, std::vector<PriorityDispatcher::PriorityClass>> setups[] {
+        { "single FIFO", {} },
+        { "classes", { health, sensors } }
+    };
+
+    for (const auto& setup : setups)
+    {
+        LatencyHistogram pingLatency;
+        std::atomic<juce::uint64> pingsReceived { 0 };
+
+        // Pings carry their send time; everything else just costs dispatch time
+        PriorityDispatcher dispatcher([&](const char* data, size_t size) {
+            const double start = juce::Time::getMillisecondCounterHiRes();
+
+            OscPacketReader::forEachMessage(data, size, [&](const OscMessageView& message, uint64_t) {
+                if (message.getAddress() == "/ping" && message.size() == 1)
+                {
+                    pingLatency.record(start - (*message.begin()).getFloat64());
+                    pingsReceived.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+
+            while (juce::Time::getMillisecondCounterHiRes() - start < dispatchCostMs) {}
+        });
+
+        dispatcher.start(setup.second);
+
+        std::atomic<bool> running { true };
+        juce::uint64 pingsSent = 0;
+
+        std::thread flood([&] {
+            OscPacketWriter writer;
+            writer.beginMessage("/sensor/7/level", "f");
+            writer.addFloat32(0.5f);
+            writer.endMessage();
+
+            while (running.load(std::memory_order_relaxed))
+                dispatcher.enqueue(writer.data(), writer.size());
+        });
+
+        const double endMs = juce::Time::getMillisecondCounterHiRes() + secondsPerRun * 1000.0;
+        OscPacketWriter ping;
+
+        while (juce::Time::getMillisecondCounterHiRes() < endMs)
+        {
+            ping.clear();
+            ping.beginMessage("/ping", "d");
+            ping.addFloat64(juce::Time::getMillisecondCounterHiRes());
+            ping.endMessage();
+            dispatcher.enqueue(ping.data(), ping.size());
+            ++pingsSent;
+
+            juce::Thread::sleep(1);
+        }
+
+        running = false;
+        flood.join();
+        dispatcher.stop();
+
+        const auto latency = pingLatency.getSnapshot();
+        juce::uint64 sensorMessages = 0, sensorDrops = 0;
+
+        for (const auto& stats : dispatcher.getStats())
+        {
+            sensorMessages += stats.numDispatched;
+            sensorDrops += stats.numDropped;
+        }
+
+        sensorMessages -= pingsReceived.load();
+
+        std::cout << "  " << juce::String(setup.first).paddedRight(' ', 11) << ": ping p50 "
+                  << juce::String(latency.getPercentileMs(0.5), 3) << " ms, p99 "
+                  << juce::String(latency.getPercentileMs(0.99), 3) << " ms, max "
+                  << juce::String(latency.getPercentileMs(1.0), 3) << " ms, "
+                  << pingsReceived.load() << " of " << pingsSent << " pings answered; "
+                  << juce::String((double) sensorMessages / secondsPerRun, 0) << " sensor msg/s dispatched, "
+                  << sensorDrops << " packets dropped" << std::endl;
+    }
+}
+
+void HostBenchmarks::runCoalescing(double secondsPerRun)
+{
+    constexpr double dispatchCostMs = 0.005;
+    constexpr int numFaders = 1000;
+    constexpr int fadersPerMs = 2000; // 10 times what the dispatcher can take
+
+    std::cout << "Coalescing benchmark, " << secondsPerRun << " s per run, "
+              << dispatchCostMs * 1000.0 << " us dispatch per packet, " << fadersPerMs
+              << " fader messages over " << numFaders << " addresses plus one /cue/go per ms" << std::endl;
+
+    PriorityDispatcher::PriorityClass events, fifo, latest;
+    PriorityDispatcher::PriorityClass::parse("events:/cue:8:256", events);
+    PriorityDispatcher::PriorityClass::parse("faders:/fader:1:4096", fifo);
+    PriorityDispatcher::PriorityClass::parse("faders:/fader:1:4096:latest", latest);
+
+    const std::pair<const char*, std::vector<PriorityDispatcher::PriorityClass>> setups[] {
+        { "FIFO", { events, fifo } },
+        { "latest only", { events, latest } }
+    };
+
+    std::vector<std::string> faderAddresses;
+
+    for (int i = 0; i < numFaders; ++i)
+        faderAddresses.push_back("/fader/" + std::to_string(i));
+
+    for (const auto& setup : setups)
+    {
+        // Every message carries its send time, so fader latency is the age of the value applied
+        LatencyHistogram faderAge, cueLatency;
+
+        PriorityDispatcher dispatcher([&](const char* data, size_t size) {
+            const double start = juce::Time::getMillisecondCounterHiRes();
+
+            OscPacketReader::forEachMessage(data, size, [&](const OscMessageView& message, uint64_t) {
+                if (message.size() == 1)
+                    (message.getAddress() == "/cue/go" ? cueLatency : faderAge).record(start - (*message.begin()).getFloat64());
+            });
+
+            while (juce::Time::getMillisecondCounterHiRes() - start < dispatchCostMs) {}
+        });
+
+        dispatcher.start(setup.second);
+
+        const double startMs = juce::Time::getMillisecondCounterHiRes();
+        juce::uint64 fadersSent = 0;
+        size_t peakPending = 0;
+        OscPacketWriter writer;
+
+        for (double nowMs = startMs; nowMs < startMs + secondsPerRun * 1000.0; nowMs = juce::Time::getMillisecondCounterHiRes())
+        {
+            // Catch up with the schedule after oversleeping
+            for (const auto due = (juce::uint64) ((nowMs - startMs) * fadersPerMs); fadersSent < due; ++fadersSent)
+            {
+                writer.clear();
+                writer.beginMessage(faderAddresses[fadersSent % numFaders], "d");
+                writer.addFloat64(juce::Time::getMillisecondCounterHiRes());
+                writer.endMessage();
+                dispatcher.enqueue(writer.data(), writer.size());
+            }
+
+            writer.clear();
+            writer.beginMessage("/cue/go", "d");
+            writer.addFloat64(juce::Time::getMillisecondCounterHiRes());
+            writer.endMessage();
+            dispatcher.enqueue(writer.data(), writer.size());
+
+            size_t pending = 0;
+
+            for (const auto& stats : dispatcher.getStats())
+                pending += stats.numPending;
+
+            peakPending = std::max(peakPending, pending);
+            juce::Thread::sleep(1);
+        }
+
+        dispatcher.stop();
+
+        const auto stats = dispatcher.getStats();
+        const auto ages = faderAge.getSnapshot();
+        const auto cues = cueLatency.getSnapshot();
+
+        std::cout << "  " << juce::String(setup.first).paddedRight(' ', 11) << ": fader age p50 "
+                  << juce::String(ages.getPercentileMs(0.5), 3) << " ms, p99 "
+                  << juce::String(ages.getPercentileMs(0.99), 3) << " ms; cue p99 "
+                  << juce::String(cues.getPercentileMs(0.99), 3) << " ms, max "
+                  << juce::String(cues.getPercentileMs(1.0), 3) << " ms; "
+                  << fadersSent << " fader messages, " << stats[1].numDispatched << " applied, "
+                  << stats[1].numCoalesced << " coalesced, " << stats[1].numDropped << " dropped; "
+                  << stats[0].numDropped << " cues dropped; peak " << peakPending << " packets pending" << std::endl;
+    }
+}
+
+void HostBenchmarks::runRateLimiting()
+{
+    SourceRateLimiter::Settings settings;
+    settings.packetsPerSecond = 1000.0;
+    settings.burst = 100.0;
+
+    SourceRateLimiter limiter;
+    std::cout << "Rate limiter benchmark, " << settings.packetsPerSecond << " datagrams/s per source, burst "
+              << settings.burst << ", room for " << settings.maxSources << " sources" << std::endl;
+
+    // Time stands still during the timings, so no bucket refills: the hot source is rejected
+    // after its burst, as under a flood, while each of the many sources stays within its burst
+    constexpr int numAdmits = 1 << 22;
+    std::vector<uint32_t> addresses(numAdmits);
+    juce::Random random(1);
+
+    for (auto& address : addresses)
+        address = 0x0a000000 + (uint32_t) random.nextInt((int) settings.maxSources);
+
+    for (const bool manySources : { false, true })
+    {
+        limiter.configure(settings);
+        const double nowMs = juce::Time::getMillisecondCounterHiRes();
+        const double startMs = juce::Time::getMillisecondCounterHiRes();
+        int admitted = 0;
+
+        for (int i = 0; i < numAdmits; ++i)
+            admitted += limiter.admit(manySources ? addresses[(size_t) i] : 0x0a000001, 9000, nowMs) ? 1 : 0;
+
+        const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+        std::cout << "  " << (manySources ? "100k sources" : "one source  ") << ": "
+                  << juce::String(elapsedMs * 1.0e6 / numAdmits, 1) << " ns per datagram, "
+                  << admitted << " of " << numAdmits << " admitted, " << limiter.getNumSources() << " sources tracked" << std::endl;
+    }
+
+    // One simulated second: the flooder sends 1000 datagrams per millisecond, everyone else 50
+    // per second, spread evenly
+    limiter.configure(settings);
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+    constexpr uint32_t flooder = 0xc0a80063;
+    juce::uint64 others = 0, othersRejected = 0, flooderAdmitted = 0;
+
+    for (int ms = 0; ms < 1000; ++ms)
+    {
+        for (int i = 0; i < 1000; ++i)
+            flooderAdmitted += limiter.admit(flooder, 4000, startMs + ms) ? 1 : 0;
+
+        for (uint32_t source = (uint32_t) ms % 20; source < 1000; source += 20, ++others)
+            othersRejected += limiter.admit(0xc0a80100 + source, 4000, startMs + ms) ? 0 : 1;
+    }
+
+    std::cout << "  flood: " << flooderAdmitted << " of 1000000 flood datagrams admitted, "
+              << othersRejected << " of " << others << " datagrams from other sources rejected" << std::endl;
+
+    for (const auto& source : limiter.getTopOffenders(3))
+        std::cout << "    " << SourceRateLimiter::formatSource(source.address, source.port) << ": "
+                  << source.numRejected << " rejected, " << source.numAdmitted << " admitted" << std::endl;
+}
+
+bool HostBenchmarks::runValidation()
+{
+    using Result = OscPacketValidator::Result;
+
+    std::cout << "Packet validation benchmark, ns per packet" << std::endl;
+
+    struct Fixture
+    {
+        const char* name;
+        Result expected;
+        std::vector<char> data;
+    };
+
+    std::vector<Fixture> packets;
+    OscPacketWriter writer;
+
+    const auto add = [&](const char* name) {
+        packets.push_back({ name, Result::valid, std::vector<char>(writer.data(), writer.data() + writer.size()) });
+        writer.clear();
+    };
+
+    writer.beginMessage("/mixer/channel/12/fader", "f");
+    writer.addFloat32(0.5f);
+    writer.endMessage();
+    add("fader message");
+
+    writer.beginMessage("/scene/recall", "sihT");
+    writer.addString("Act two, scene one: the garden at night");
+    writer.addInt32(42);
+    writer.addInt64(1234567890123);
+    writer.endMessage();
+    add("mixed arguments");
+
+    writer.beginBundle();
+
+    for (int i = 0; i < 16; ++i)
+    {
+        writer.beginMessage("/sensor/" + std::to_string(i) + "/level", "f");
+        writer.addFloat32(0.25f);
+        writer.endMessage();
+    }
+
+    writer.endBundle();
+    add("bundle of 16");
+
+    writer.beginMessage("/log/line", "s");
+    writer.addString(std::string(1000, 'x'));
+    writer.endMessage();
+    add("1 KB string");
+
+    // Garbage that still looks like OSC at first glance, then plain noise
+    auto truncated = packets[1].data;
+    truncated.resize(truncated.size() - 8);
+    packets.push_back({ "truncated", Result::argumentOverrun, truncated });
+
+    auto badPadding = packets[0].data;
+    badPadding[27] = 'x'; // after the type tags' terminator
+    packets.push_back({ "bad padding", Result::badPadding, badPadding });
+
+    std::vector<char> noise(256);
+    juce::Random random(1);
+
+    for (auto& byte : noise)
+        byte = (char) random.nextInt(256);
+
+    noise[0] = '/';
+    packets.push_back({ "random bytes", Result::badAddress, noise });
+
+    constexpr int iterations = 200000;
+    bool passed = true;
+
+    for (const auto& [name, expected, packet] : packets)
+    {
+        auto result = Result::valid;
+        int decoded = 0;
+        double startMs = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < iterations; ++i)
+            result = OscPacketValidator::validate(packet.data(), packet.size());
+
+        const double validateNs = (juce::Time::getMillisecondCounterHiRes() - startMs) * 1.0e6 / iterations;
+        startMs = juce::Time::getMillisecondCounterHiRes();
+
+        // Decoding has to look at every argument to be comparable
+        for (int i = 0; i < iterations; ++i)
+            decoded += OscPacketReader::forEachMessage(packet.data(), packet.size(), [](const OscMessageView& message, uint64_t) {
+                for (const auto argument : message)
+                    (void) argument;
+            }) ? 1 : 0;
+
+        const double decodeNs = (juce::Time::getMillisecondCounterHiRes() - startMs) * 1.0e6 / iterations;
+
+        std::cout << "  " << juce::String(name).paddedRight(' ', 15) << ": validate "
+                  << juce::String(validateNs, 1).paddedLeft(' ', 6) << ", decode "
+                  << juce::String(decodeNs, 1).paddedLeft(' ', 6) << "  ("
+                  << OscPacketValidator::getName(result)
+                  << (decoded == iterations ? ", decodes" : ", fails to decode") << ")" << std::endl;
+
+        // Doubles as a regression check: every fixture has a known verdict, and anything the
+        // validator accepts the reader must be able to decode
+        if (result != expected)
+        {
+            std::cerr << "  FAILED: " << name << " validated as " << OscPacketValidator::getName(result)
+                      << ", expected " << OscPacketValidator::getName(expected) << std::endl;
+            passed = false;
+        }
+
+        if (result == Result::valid && decoded != iterations)
+        {
+            std::cerr << "  FAILED: " << name << " passes validation but OscPacketReader rejects it" << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
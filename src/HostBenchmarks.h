@@ -0,0 +1,33 @@
+#pragma once
+
+// Receive-path benchmarks for osc_host, run from the command line; results are printed to stdout
+namespace HostBenchmarks
+{
+    // Floods a loopback UDP socket from two sender threads and reads it with each receive
+    // backend: the readiness loop OSCHost falls back to (one poll and one read per datagram),
+    // io_uring, and AF_XDP in generic mode on lo (which needs root). Reports messages
+    // received per second, receiver CPU per message and system calls per message.
+    void runUdpBackends(double secondsPerRun);
+
+    // Overloads a dispatcher that takes 5 µs per packet with a flood of sensor messages while
+    // sending /ping every millisecond, once through a single FIFO and once with /ping in its
+    // own priority class, and reports ping latency percentiles and losses
+    void runPriorityClasses(double secondsPerRun);
+
+    // Sends fader values for 1000 addresses at ten times the rate a 5 µs-per-packet dispatcher
+    // can take, plus one discrete cue per millisecond, once with the faders in a FIFO class
+    // and once in a latest-only class. Reports the age of the fader values applied, cue
+    // latency, drops and the peak number of packets waiting.
+    void runCoalescing(double secondsPerRun);
+
+    // Times SourceRateLimiter::admit() for one hot source and for 100k sources, then replays a
+    // second of one source flooding at a million datagrams per second among 1000 sources
+    // sending 50 per second each, with a limit of 1000 per second, and reports who got through
+    void runRateLimiting();
+
+    // Times OscPacketValidator::validate() against decoding with OscPacketReader for typical
+    // messages, a bundle, long strings and several kinds of invalid packet. Returns false, after
+    // saying why on stderr, if a packet gets a different verdict than expected or the reader
+    // cannot decode one the validator accepts.
+    bool runValidation();
+}
@@ -0,0 +1,695 @@
+#include "OSCHost.h"
+#include "OscMulticast.h"
+#include "OscPacketWriter.h"
+#include "OscUdpOffload.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if JUCE_WINDOWS
+ #include <winsock2.h>
+#else
+ #include <arpa/inet.h>
+ #include <netinet/in.h>
+ #include <sys/socket.h>
+#endif
+
+// Receives datagrams on an AF_UNIX socket and passes them to the same dispatch as UDP
+class OSCHost::LocalReceiver : public juce::Thread
+{
+public:
+    LocalReceiver(OSCHost& ownerToUse, OscLocalSocket socketToUse)
+        : juce::Thread("OSC host local receiver"),
+          owner(ownerToUse),
+          socket(std::move(socketToUse)),
+          buffer(65536)
+    {
+        startThread();
+    }
+
+    ~LocalReceiver() override
+    {
+        signalThreadShouldExit();
+        socket.shutdown();
+        stopThread(4000);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            const int bytesRead = socket.read(buffer.data(), buffer.size(), 100);
+
+            if (bytesRead < 0)
+                break;
+
+            if (bytesRead > 0)
+                owner.receiveDatagram(buffer.data(), (size_t) bytesRead);
+        }
+    }
+
+private:
+    OSCHost& owner;
+    OscLocalSocket socket;
+    std::vector<char> buffer;
+};
+
+// Drains a shared-memory ring, sleeping on its futex only while it is empty
+class OSCHost::RingReceiver : public juce::Thread
+{
+public:
+    RingReceiver(OSCHost& ownerToUse, std::unique_ptr<OscSharedRing> ringToUse)
+        : juce::Thread("OSC host ring receiver"),
+          owner(ownerToUse),
+          ring(std::move(ringToUse)),
+          packet(ring->getMaxPacketSize())
+    {
+        startThread();
+    }
+
+    ~RingReceiver() override
+    {
+        signalThreadShouldExit();
+        ring->wakeConsumer();
+        stopThread(4000);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            // Producers can still write to a packet in the segment, so it is validated and
+            // decoded from a copy of its own
+            const size_t numPackets = ring->drain([this](const char* data, size_t size) {
+                std::memcpy(packet.data(), data, size);
+                owner.receiveDatagram(packet.data(), size);
+            });
+
+            if (ring->getNumCorrupt() != numCorrupt)
+            {
+                numCorrupt = ring->getNumCorrupt();
+                std::cerr << "Shared-memory ring held a malformed record; "
+                          << (ring->isOpen() ? "recreated it" : "failed to recreate it") << std::endl;
+
+                if (!ring->isOpen())
+                    return;
+            }
+
+            if (numPackets == 0)
+                ring->waitForData(100);
+        }
+    }
+
+    juce::uint64 getNumDropped() const noexcept { return ring->getNumDropped(); }
+
+private:
+    OSCHost& owner;
+    std::unique_ptr<OscSharedRing> ring;
+    std::vector<char> packet;
+    juce::uint64 numCorrupt = 0;
+};
+
+// Reads frames the XDP program redirected to an AF_XDP socket
+class OSCHost::XdpReceiver : public juce::Thread
+{
+public:
+    XdpReceiver(OSCHost& ownerToUse, std::unique_ptr<XdpUdpReceiver> receiverToUse)
+        : juce::Thread("OSC host AF_XDP receiver"),
+          owner(ownerToUse),
+          receiver(std::move(receiverToUse))
+    {
+        startThread();
+    }
+
+    ~XdpReceiver() override
+    {
+        stopThread(4000);
+    }
+
+    void run() override
+    {
+        const bool finished = receiver->run([this] { return threadShouldExit(); },
+                                            [this](const char* data, size_t size, uint32_t sourceAddress, uint16_t sourcePort) {
+                                                owner.receiveUdpDatagram(data, size, sourceAddress, sourcePort,
+                                                                         juce::Time::getMillisecondCounterHiRes());
+                                            });
+
+        if (!finished)
+            std::cerr << "AF_XDP receive failed: " << receiver->getError() << std::endl;
+    }
+
+    const XdpUdpReceiver& getReceiver() const noexcept { return *receiver; }
+
+private:
+    OSCHost& owner;
+    std::unique_ptr<XdpUdpReceiver> receiver;
+};
+
+OSCHost::OSCHost()
+    : juce::Thread("OSC host receiver"),
+      buffer(65536),
+      tcpServer([this](const char* data, size_t size, OscReplyChannel& reply) {
+          if (validatePacket(data, size))
+              handlePacket(data, size, &reply);
+      }),
+      localStreamServer([this](const char* data, size_t size, OscReplyChannel& reply) {
+          if (validatePacket(data, size))
+              handlePacket(data, size, &reply);
+      }),
+      priorityDispatcher([this](const char* data, size_t size) { handlePacket(data, size); })
+{
+}
+
+OSCHost::~OSCHost()
+{
+    stop();
+}
+
+bool OSCHost::start(int port, bool sharePort)
+{
+    socket = std::make_unique<juce::DatagramSocket>(false);
+
+    if (sharePort)
+        socket->setEnablePortReuse(true);
+
+    if (!socket->bindToPort(port))
+    {
+        std::cerr << "Failed to connect to port " << port << std::endl;
+        socket.reset();
+        return false;
+    }
+
+   #if JUCE_LINUX
+    // Senders using segmentation offload then arrive as one buffer per burst
+    receiveCoalescing = OscUdpOffload::enableReceiveCoalescing(socket->getRawSocketHandle());
+
+    if (receiveCoalescing)
+        std::cout << "UDP receive coalescing (GRO) enabled" << std::endl;
+   #endif
+
+    udpPort = port;
+    startThread();
+
+    // The ring has to be set up on the receive thread, which reports back here
+    if (udpBackend != UdpBackend::poll)
+    {
+        backendChosen.wait(-1);
+
+        if (udpBackend == UdpBackend::ioUring && !usingUring)
+        {
+            std::cerr << "io_uring is unavailable: " << uringReceiver.getError() << std::endl;
+            stop();
+            return false;
+        }
+    }
+
+    std::cout << "Server started successfully!" << std::endl;
+    return true;
+}
+
+bool OSCHost::startPriorityClasses(std::vector<PriorityDispatcher::PriorityClass> classes)
+{
+    if (!priorityDispatcher.start(std::move(classes)))
+        return false;
+
+    lastPriorityStats = priorityDispatcher.getStats();
+    std::cout << "Dispatching datagrams by priority class:" << std::endl;
+
+    for (const auto& stats : lastPriorityStats)
+        std::cout << "  " << stats.name << (stats.latestOnly ? " (latest value per address)" : "") << std::endl;
+
+    return true;
+}
+
+void OSCHost::setSourceRateLimit(const SourceRateLimiter::Settings& settings)
+{
+    rateLimiter.configure(settings);
+    lastNumRejected = 0;
+
+    std::cout << "Limiting each UDP source to " << settings.packetsPerSecond << " datagrams/s (burst "
+              << (settings.burst > 0.0 ? settings.burst : settings.packetsPerSecond) << ", "
+              << settings.maxSources << " sources, forgotten after " << settings.expirySeconds << " s idle)" << std::endl;
+}
+
+void OSCHost::reportRateLimitStats()
+{
+    if (!rateLimiter.isEnabled())
+        return;
+
+    const auto numRejected = rateLimiter.getNumRejected();
+    std::cout << "Rate limiting: " << numRejected - lastNumRejected << " datagrams rejected since the last report, "
+              << rateLimiter.getNumSources() << " sources tracked, " << rateLimiter.getNumUntracked()
+              << " datagrams from sources that did not fit" << std::endl;
+
+    for (const auto& source : rateLimiter.getTopOffenders(5))
+        std::cout << "  " << SourceRateLimiter::formatSource(source.address, source.port) << ": "
+                  << source.numRejected << " rejected, " << source.numAdmitted << " admitted" << std::endl;
+
+    lastNumRejected = numRejected;
+}
+
+void OSCHost::reportInvalidPackets()
+{
+    std::string reasons;
+
+    for (size_t i = 1; i < numInvalid.size(); ++i)
+    {
+        const auto count = numInvalid[i].load(std::memory_order_relaxed);
+
+        if (count != lastNumInvalid[i])
+            reasons += std::string(reasons.empty() ? "" : ", ") + std::to_string(count - lastNumInvalid[i]) + " "
+                     + OscPacketValidator::getName((OscPacketValidator::Result) i);
+
+        lastNumInvalid[i] = count;
+    }
+
+    if (!reasons.empty())
+        std::cout << "Invalid packets dropped since the last report: " << reasons << std::endl;
+}
+
+void OSCHost::reportPriorityStats()
+{
+    if (!priorityDispatcher.isRunning())
+        return;
+
+    auto stats = priorityDispatcher.getStats();
+    std::cout << "Priority classes since the last report:" << std::endl;
+
+    for (size_t i = 0; i < stats.size() && i < lastPriorityStats.size(); ++i)
+    {
+        const auto latency = stats[i].latency - lastPriorityStats[i].latency;
+
+        std::printf("  %-12s %10llu dispatched %8llu dropped %10llu coalesced   latency p50 %.3f ms  p99 %.3f ms  p99.9 %.3f ms  max %.3f ms\n",
+                    stats[i].name.c_str(),
+                    (unsigned long long) (stats[i].numDispatched - lastPriorityStats[i].numDispatched),
+                    (unsigned long long) (stats[i].numDropped - lastPriorityStats[i].numDropped),
+                    (unsigned long long) (stats[i].numCoalesced - lastPriorityStats[i].numCoalesced),
+                    latency.getPercentileMs(0.5), latency.getPercentileMs(0.99),
+                    latency.getPercentileMs(0.999), latency.getPercentileMs(1.0));
+    }
+
+    std::fflush(stdout);
+    lastPriorityStats = std::move(stats);
+}
+
+bool OSCHost::joinMulticast(const std::string& group, const std::string& interfaceName)
+{
+    if (socket == nullptr || !OscMulticast::joinGroup(socket->getRawSocketHandle(), group, interfaceName))
+    {
+        std::cerr << "Failed to join multicast group " << group
+                  << (interfaceName.empty() ? std::string() : " on " + interfaceName) << std::endl;
+        return false;
+    }
+
+    std::cout << "Joined multicast group " << group
+              << (interfaceName.empty() ? std::string() : " on " + interfaceName) << std::endl;
+    return true;
+}
+
+bool OSCHost::startTcp(int port, TcpServer::Framing framing)
+{
+    if (!tcpServer.start(port, framing))
+        return false;
+
+    std::cout << "Accepting OSC over TCP on port " << port << std::endl;
+    return true;
+}
+
+bool OSCHost::startLocalDatagram(const std::string& path)
+{
+    OscLocalSocket socket;
+
+    if (!socket.bind(path, OscLocalSocket::Type::datagram))
+    {
+        std::cerr << "Failed to bind local datagram socket " << path << std::endl;
+        return false;
+    }
+
+    localReceiver = std::make_unique<LocalReceiver>(*this, std::move(socket));
+    std::cout << "Accepting OSC datagrams on local socket " << path << std::endl;
+    return true;
+}
+
+bool OSCHost::startLocalStream(const std::string& path, TcpServer::Framing framing)
+{
+    if (!localStreamServer.startLocal(path, framing))
+        return false;
+
+    std::cout << "Accepting OSC streams on local socket " << path << std::endl;
+    return true;
+}
+
+bool OSCHost::startSharedRing(const std::string& name, size_t capacity)
+{
+    auto ring = std::make_unique<OscSharedRing>();
+
+    if (!ring->create(name, capacity))
+    {
+        std::cerr << "Failed to create shared-memory ring " << name << std::endl;
+        return false;
+    }
+
+    std::cout << "Draining OSC packets from shared-memory ring " << name << " ("
+              << ring->getCapacity() / 1024 << " KiB)" << std::endl;
+
+    ringReceiver = std::make_unique<RingReceiver>(*this, std::move(ring));
+    return true;
+}
+
+bool OSCHost::startXdp(const std::string& interfaceName, int queue, XdpUdpReceiver::Mode mode)
+{
+    auto receiver = std::make_unique<XdpUdpReceiver>();
+
+    if (socket == nullptr || !receiver->open(interfaceName, queue, udpPort, mode))
+    {
+        std::cerr << "Failed to attach AF_XDP to " << interfaceName << " queue " << queue
+                  << (socket == nullptr ? std::string() : ": " + receiver->getError()) << std::endl;
+        return false;
+    }
+
+    std::cout << "Receiving UDP port " << udpPort << " through AF_XDP on " << interfaceName << " queue " << queue
+              << (mode == XdpUdpReceiver::Mode::generic ? " (generic mode)" : " (native mode)") << std::endl;
+
+    xdpReceiver = std::make_unique<XdpReceiver>(*this, std::move(receiver));
+    return true;
+}
+
+void OSCHost::stop()
+{
+    tcpServer.stop();
+    localStreamServer.stop();
+    localReceiver.reset();
+
+    if (ringReceiver != nullptr)
+    {
+        std::cout << "Shared-memory ring dropped " << ringReceiver->getNumDropped()
+                  << " packets while full" << std::endl;
+        ringReceiver.reset();
+    }
+
+    if (xdpReceiver != nullptr)
+    {
+        xdpReceiver->stopThread(4000);
+        const auto& receiver = xdpReceiver->getReceiver();
+        std::cout << "AF_XDP received " << receiver.getNumPackets() << " datagrams, skipped "
+                  << receiver.getNumMalformed() << " malformed frames, kernel dropped "
+                  << receiver.getNumDropped() << std::endl;
+        xdpReceiver.reset();
+    }
+
+    if (socket != nullptr)
+    {
+        signalThreadShouldExit();
+        socket->shutdown();
+        stopThread(4000);
+        socket.reset();
+    }
+
+    if (usingUring)
+    {
+        std::cout << "io_uring received " << uringReceiver.getNumPackets() << " datagrams in "
+                  << uringReceiver.getNumWaits() << " waits" << std::endl;
+        usingUring = false;
+    }
+
+    if (rateLimiter.isEnabled())
+        reportRateLimitStats();
+
+    reportInvalidPackets();
+
+    // Last, once nothing can queue more datagrams
+    if (priorityDispatcher.isRunning())
+    {
+        reportPriorityStats();
+        priorityDispatcher.stop();
+    }
+}
+
+void OSCHost::run()
+{
+    if (udpBackend != UdpBackend::poll && runUring())
+        return;
+
+   #if JUCE_LINUX
+    // recvmsg() also tells the rate limiter who sent the datagram
+    if (receiveCoalescing || rateLimiter.isEnabled())
+    {
+        while (!threadShouldExit())
+        {
+            size_t segmentSize = 0;
+            uint32_t sourceAddress = 0;
+            uint16_t sourcePort = 0;
+            const int bytesRead = OscUdpOffload::receive(socket->getRawSocketHandle(), buffer.data(), buffer.size(), 100,
+                                                         segmentSize, &sourceAddress, &sourcePort);
+
+            if (bytesRead < 0)
+                break;
+
+            // A coalesced buffer always comes from one source
+            const double nowMs = juce::Time::getMillisecondCounterHiRes();
+
+            OscUdpOffload::forEachSegment(buffer.data(), (size_t) bytesRead, segmentSize, [&](const char* data, size_t size) {
+                receiveUdpDatagram(data, size, sourceAddress, sourcePort, nowMs);
+            });
+        }
+
+        return;
+    }
+   #endif
+
+    while (!threadShouldExit())
+    {
+        const int ready = socket->waitUntilReady(true, 100);
+
+        if (ready < 0)
+            break;
+
+        if (ready == 0)
+            continue;
+
+        if (!rateLimiter.isEnabled())
+        {
+            const int bytesRead = socket->read(buffer.data(), (int) buffer.size(), false);
+
+            if (bytesRead > 0)
+                receiveDatagram(buffer.data(), (size_t) bytesRead);
+
+            continue;
+        }
+
+        // recvfrom() on the raw handle gives the sender as numbers, where DatagramSocket::read()
+        // would format it as a string for every packet
+        sockaddr_in from {};
+       #if JUCE_WINDOWS
+        int fromLength = (int) sizeof(from);
+        const int bytesRead = ::recvfrom((SOCKET) socket->getRawSocketHandle(), buffer.data(), (int) buffer.size(), 0,
+                                         reinterpret_cast<sockaddr*>(&from), &fromLength);
+       #else
+        socklen_t fromLength = sizeof(from);
+        const auto bytesRead = (int) ::recvfrom(socket->getRawSocketHandle(), buffer.data(), buffer.size(), 0,
+                                                reinterpret_cast<sockaddr*>(&from), &fromLength);
+       #endif
+
+        if (bytesRead > 0)
+        {
+            // The socket is bound to IPv4, so any other family would be a surprise; such
+            // datagrams still get through, sharing one bucket
+            const bool isIPv4 = from.sin_family == AF_INET;
+
+            receiveUdpDatagram(buffer.data(), (size_t) bytesRead,
+                               isIPv4 ? (uint32_t) ntohl(from.sin_addr.s_addr) : 0,
+                               isIPv4 ? (uint16_t) ntohs(from.sin_port) : (uint16_t) 0,
+                               juce::Time::getMillisecondCounterHiRes());
+        }
+    }
+}
+
+// Returns false if the socket should be read by run() instead
+bool OSCHost::runUring()
+{
+    // Replies go to the same default address sendPong() uses
+    const bool opened = uringReceiver.open((int) socket->getRawSocketHandle(), "127.0.0.1", 7771);
+    usingUring = opened;
+    backendChosen.signal();
+
+    if (!opened)
+    {
+        if (udpBackend == UdpBackend::ioUring)
+            return true; // start() fails and stops this thread
+
+        std::cout << "io_uring unavailable (" << uringReceiver.getError() << "), polling the UDP socket" << std::endl;
+        return false;
+    }
+
+    std::cout << "Receiving UDP through io_uring" << std::endl;
+
+    const bool finished = uringReceiver.run([this] { return threadShouldExit(); },
+                                            [this](const char* data, size_t size, uint32_t sourceAddress, uint16_t sourcePort,
+                                                   OscReplyChannel& reply) {
+                                                receiveUdpDatagram(data, size, sourceAddress, sourcePort,
+                                                                   juce::Time::getMillisecondCounterHiRes(), &reply);
+                                            });
+    uringReceiver.close();
+
+    if (finished)
+        return true;
+
+    std::cerr << "io_uring receive failed (" << uringReceiver.getError() << "), polling the UDP socket" << std::endl;
+    return false;
+}
+
+bool OSCHost::validatePacket(const char* data, size_t size) noexcept
+{
+    const auto result = OscPacketValidator::validate(data, size, maxPacketSize.load(std::memory_order_relaxed));
+
+    if (result == OscPacketValidator::Result::valid)
+        return true;
+
+    // Counted rather than logged, since a flood of garbage would otherwise flood the log too
+    numInvalid[(size_t) result].fetch_add(1, std::memory_order_relaxed);
+    numMalformed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void OSCHost::receiveDatagram(const char* data, size_t size, OscReplyChannel* reply)
+{
+    if (!validatePacket(data, size))
+        return;
+
+    // Queued datagrams are dispatched later on another thread, where the reply channel can no
+    // longer be used; UDP replies go to the same default address without it
+    if (priorityDispatcher.isRunning())
+        priorityDispatcher.enqueue(data, size);
+    else
+        handlePacket(data, size, reply);
+}
+
+void OSCHost::receiveUdpDatagram(const char* data, size_t size, uint32_t sourceAddress, uint16_t sourcePort,
+                                 double nowMs, OscReplyChannel* reply)
+{
+    // Before anything looks at the contents
+    if (rateLimiter.admit(sourceAddress, sourcePort, nowMs))
+        receiveDatagram(data, size, reply);
+}
+
+void OSCHost::handlePacket(const char* data, size_t size, OscReplyChannel* reply)
+{
+    const bool wellFormed = OscPacketReader::forEachMessage(data, size, [this, reply](const OscMessageView& message, uint64_t timeTag) {
+        dispatch(message, timeTag, reply);
+    });
+
+    if (!wellFormed)
+    {
+        numMalformed.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Dropped malformed packet (" << size << " bytes)" << std::endl;
+    }
+}
+
+void OSCHost::dispatch(const OscMessageView& message, uint64_t timeTag, OscReplyChannel* reply)
+{
+    numMessages.fetch_add(1, std::memory_order_relaxed);
+
+    const auto address = message.getAddress();
+
+    if (address == "/ping")
+    {
+        std::cout << "Received ping" << std::endl;
+
+        if (reply != nullptr)
+        {
+            thread_local OscPacketWriter writer;
+            writer.clear();
+            writer.beginMessage("/pong", "s");
+            writer.addString("pong");
+            writer.endMessage();
+
+            if (reply->sendReply(writer.data(), writer.size()))
+                std::cout << "Sent pong response over the receiving transport" << std::endl;
+            else
+                std::cerr << "Error: Reply queue full, pong dropped" << std::endl;
+
+            return;
+        }
+
+        // Note: the datagram's source port is the client's ephemeral sending port, not the port it
+        // listens on. For a production application, clients should include their return address
+        // in the message. For this demo, we send pong responses to a default loopback address.
+        sendPong("127.0.0.1", 7771);
+        return;
+    }
+
+    // Generic handler for unmatched messages
+    std::cout << "Received unhandled message:" << std::endl;
+    std::cout << "  Path: " << address << std::endl;
+    std::cout << "  Arguments: " << message.size() << std::endl;
+
+    for (const auto argument : message)
+        std::cout << "    " << describeArgument(argument) << std::endl;
+
+    if (timeTag != 1)
+        std::cout << "  Time tag: " << timeTag << std::endl;
+}
+
+std::string OSCHost::describeArgument(const OscArgument& argument)
+{
+    const char type = argument.getType();
+    std::string text(1, type);
+    text += ':';
+
+    char number[64];
+
+    switch (type)
+    {
+        case 'i': text += std::to_string(argument.getInt32()); break;
+        case 'h': text += std::to_string(argument.getInt64()); break;
+        case 'f': std::snprintf(number, sizeof(number), "%g", (double) argument.getFloat32()); text += number; break;
+        case 'd': std::snprintf(number, sizeof(number), "%.17g", argument.getFloat64()); text += number; break;
+        case 't': text += std::to_string(argument.getTimeTag()); break;
+        case 's': case 'S': text += '"'; text += argument.getString(); text += '"'; break;
+        case 'b': text += "[" + std::to_string(argument.getBlob().size) + " bytes]"; break;
+        case 'c': text += (char) argument.getCharacter(); break;
+        case 'r': std::snprintf(number, sizeof(number), "#%08x", argument.getColour()); text += number; break;
+
+        case 'm':
+        {
+            const auto midi = argument.getMidi();
+            std::snprintf(number, sizeof(number), "port %u %02x %02x %02x", midi.port, midi.status, midi.data1, midi.data2);
+            text += number;
+            break;
+        }
+
+        case 'T': text += "true"; break;
+        case 'F': text += "false"; break;
+        case 'N': text += "nil"; break;
+        case 'I': text += "infinitum"; break;
+        default:  break; // array brackets
+    }
+
+    return text;
+}
+
+void OSCHost::sendPong(const juce::String& host, int port)
+{
+    // Several transport threads can reply at once
+    const juce::ScopedLock lock(senderLock);
+
+    if (!sender.connect(host, port))
+    {
+        std::cerr << "Error: Could not create reply address" << std::endl;
+        return;
+    }
+
+    juce::OSCMessage pongMessage("/pong");
+    pongMessage.addString("pong");
+
+    if (!sender.send(pongMessage))
+    {
+        std::cerr << "Error: Failed to send pong response" << std::endl;
+    }
+    else
+    {
+        std::cout << "Sent pong response to " << host << ":" << port << std::endl;
+    }
+
+    sender.disconnect();
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_osc/juce_osc.h>
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "OscPacketReader.h"
+#include "OscPacketValidator.h"
+#include "OscSharedRing.h"
+#include "PriorityDispatcher.h"
+#include "SourceRateLimiter.h"
+#include "TcpServer.h"
+#include "UringUdpReceiver.h"
+#include "XdpUdpReceiver.h"
+
+// The host's OSC server: receives datagrams on its own thread, decodes them in place with
+// OscPacketReader and dispatches each message, including those inside bundles. Every OSC 1.1
+// argument type is understood. Packets from every transport first pass OscPacketValidator,
+// so malformed or oversized ones are dropped, and counted by reason, before they are copied
+// or decoded.
+// startTcp() additionally serves OSC over TCP; replies to those clients go back over
+// their own connection. startLocalDatagram() and startLocalStream() accept the same
+// traffic on AF_UNIX sockets from clients on this machine, and startSharedRing() drains
+// packets that local producers write into shared memory. joinMulticast() subscribes the UDP
+// socket to multicast groups, so one datagram from a sender reaches every host in the group.
+// On Linux the UDP socket accepts coalesced (GRO) buffers, which are split back into
+// datagrams before dispatch, and is read through io_uring where the kernel allows it.
+// startXdp() takes the port's datagrams off one interface queue through AF_XDP before the
+// kernel's UDP stack sees them. With startPriorityClasses(), datagrams from every transport
+// are queued per priority class and dispatched by weight on a separate thread instead of on
+// the thread that received them; TCP and AF_UNIX stream packets are still dispatched
+// directly, since their replies go back over the connection from the server thread.
+// setSourceRateLimit() puts a token bucket per sender in front of every UDP receive path,
+// checked before a datagram is parsed or copied.
+class OSCHost : private juce::Thread
+{
+public:
+    // How the UDP socket is read. automatic uses io_uring and falls back to polling the
+    // socket when the kernel refuses it; ioUring makes start() fail instead.
+    enum class UdpBackend
+    {
+        automatic,
+        ioUring,
+        poll
+    };
+
+    OSCHost();
+    ~OSCHost() override;
+
+    // Takes effect at the next start()
+    void setUdpBackend(UdpBackend backend) noexcept { udpBackend = backend; }
+
+    // sharePort lets other processes on this machine bind the same port, which every
+    // subscriber to a multicast group on that port needs
+    bool start(int port, bool sharePort = false);
+
+    // Call before start(). Replies to queued datagrams go to the default UDP reply address.
+    bool startPriorityClasses(std::vector<PriorityDispatcher::PriorityClass> classes);
+
+    // Call before start(). Limits the datagrams each UDP source address and port may send over
+    // the socket, io_uring or AF_XDP; local transports are not limited.
+    void setSourceRateLimit(const SourceRateLimiter::Settings& settings);
+
+    // Takes effect immediately; larger packets are rejected as oversized
+    void setMaxPacketSize(size_t numBytes) noexcept { maxPacketSize = numBytes; }
+
+    // Prints the packets rejected as invalid since the previous report, by reason
+    void reportInvalidPackets();
+
+    // Prints the datagrams rejected since the previous report and the worst offenders so far
+    void reportRateLimitStats();
+
+    // Prints each priority class's dispatch count, drops, coalesced values and latency percentiles
+    // since the previous report
+    void reportPriorityStats();
+
+    bool joinMulticast(const std::string& group, const std::string& interfaceName = {});
+    bool startTcp(int port, TcpServer::Framing framing = TcpServer::Framing::detect);
+    bool startLocalDatagram(const std::string& path);
+    bool startLocalStream(const std::string& path, TcpServer::Framing framing = TcpServer::Framing::detect);
+    bool startSharedRing(const std::string& name, size_t capacity = OscSharedRing::defaultCapacity);
+
+    // Call after start(): receives the UDP port's datagrams on queue of interfaceName through
+    // AF_XDP. Datagrams the XDP program passes on still reach the UDP socket.
+    bool startXdp(const std::string& interfaceName, int queue = 0,
+                  XdpUdpReceiver::Mode mode = XdpUdpReceiver::Mode::generic);
+    void stop();
+
+    // Any thread: decodes one packet from any transport and dispatches its messages. Replies
+    // go to reply if given, otherwise to the default UDP reply address. Does not validate the
+    // packet first.
+    void handlePacket(const char* data, size_t size, OscReplyChannel* reply = nullptr);
+
+    juce::uint64 getNumMessages() const noexcept { return numMessages.load(std::memory_order_relaxed); }
+    juce::uint64 getNumMalformed() const noexcept { return numMalformed.load(std::memory_order_relaxed); }
+    juce::uint64 getNumInvalid(OscPacketValidator::Result reason) const noexcept
+    {
+        return numInvalid[(size_t) reason].load(std::memory_order_relaxed);
+    }
+
+    // Human-readable form of one argument, e.g. "h:1099511627776" or "b:[5 bytes]"
+    static std::string describeArgument(const OscArgument& argument);
+
+private:
+    class LocalReceiver;
+    class RingReceiver;
+    class XdpReceiver;
+
+    void run() override;
+    bool runUring();
+    bool validatePacket(const char* data, size_t size) noexcept;
+    void receiveDatagram(const char* data, size_t size, OscReplyChannel* reply = nullptr);
+    void receiveUdpDatagram(const char* data, size_t size, uint32_t sourceAddress, uint16_t sourcePort,
+                            double nowMs, OscReplyChannel* reply = nullptr);
+    void dispatch(const OscMessageView& message, uint64_t timeTag, OscReplyChannel* reply);
+    void sendPong(const juce::String& host, int port);
+
+    std::unique_ptr<juce::DatagramSocket> socket;
+    std::vector<char> buffer;
+    juce::OSCSender sender;
+    juce::CriticalSection senderLock;
+    TcpServer tcpServer;
+    TcpServer localStreamServer;
+    std::unique_ptr<LocalReceiver> localReceiver;
+    std::unique_ptr<RingReceiver> ringReceiver;
+    std::unique_ptr<XdpReceiver> xdpReceiver;
+    int udpPort = 0;
+    PriorityDispatcher priorityDispatcher;
+    std::vector<PriorityDispatcher::ClassStats> lastPriorityStats;
+    SourceRateLimiter rateLimiter;
+    juce::uint64 lastNumRejected = 0;
+    bool receiveCoalescing = false;
+    UdpBackend udpBackend = UdpBackend::automatic;
+    UringUdpReceiver uringReceiver;
+    juce::WaitableEvent backendChosen;
+    std::atomic<bool> usingUring{false};
+
+    std::atomic<juce::uint64> numMessages{0};
+    std::atomic<juce::uint64> numMalformed{0};
+    std::atomic<size_t> maxPacketSize{TcpServer::maxPacketSize};
+    std::array<std::atomic<juce::uint64>, (size_t) OscPacketValidator::Result::numResults> numInvalid{};
+    std::array<juce::uint64, (size_t) OscPacketValidator::Result::numResults> lastNumInvalid{};
+};
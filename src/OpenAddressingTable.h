@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A hash table of a fixed number of slots, a power of two, holding Items inline. Collisions
+// are resolved by linear probing, and erase() shifts later items back instead of leaving
+// tombstones, so probe sequences stay as short after hours of churn as when the table was
+// new. It never grows: callers keep it well below full (under half, say), which also
+// guarantees every probe sequence ends at an empty slot.
+//
+// Traits tells the table which items are empty and where each one's probe sequence starts:
+//
+//     struct Traits
+//     {
+//         static bool isEmpty(const Item& item) noexcept;
+//         static uint64_t getHash(const Item& item) noexcept; // well mixed in the low bits
+//     };
+//
+// A default-constructed Item must be empty. Not thread-safe.
+template <typename Item, typename Traits>
+class OpenAddressingTable
+{
+public:
+    OpenAddressingTable() = default;
+
+    // Empties the table and gives it numSlots slots, which must be a power of two or 0
+    void reset(size_t numSlots)
+    {
+        items.assign(numSlots, Item());
+        mask = numSlots > 0 ? numSlots - 1 : 0;
+        size = 0;
+    }
+
+    size_t getNumSlots() const noexcept { return items.size(); }
+    size_t getSize() const noexcept { return size; }
+
+    // The slot holding the item with this hash for which matches(item) is true, or else the
+    // empty slot where such an item would go
+    template <typename Matches>
+    size_t find(uint64_t hash, Matches&& matches) const noexcept
+    {
+        size_t position = (size_t) hash & mask;
+
+        while (!Traits::isEmpty(items[position]) && !matches(items[position]))
+            position = (position + 1) & mask;
+
+        return position;
+    }
+
+    Item& operator[](size_t position) noexcept { return items[position]; }
+    const Item& operator[](size_t position) const noexcept { return items[position]; }
+
+    // position must be an empty slot returned by find() for the item's hash
+    void insert(size_t position, const Item& item) noexcept
+    {
+        items[position] = item;
+        ++size;
+    }
+
+    // Empties the slot at position. A later item may move into it, so a caller walking the
+    // table should look at position again.
+    void erase(size_t position) noexcept
+    {
+        for (size_t next = (position + 1) & mask; !Traits::isEmpty(items[next]); next = (next + 1) & mask)
+        {
+            const size_t home = (size_t) Traits::getHash(items[next]) & mask;
+
+            // The item at next may fill the gap unless its home lies after the gap
+            if (((next - home) & mask) >= ((next - position) & mask))
+            {
+                items[position] = items[next];
+                position = next;
+            }
+        }
+
+        items[position] = Item();
+        --size;
+    }
+
+private:
+    std::vector<Item> items;
+    size_t mask = 0, size = 0;
+};
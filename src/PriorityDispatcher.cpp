@@ -0,0 +1,409 @@
+#include "PriorityDispatcher.h"
+#include "OpenAddressingTable.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    uint64_t hashAddress(std::string_view address) noexcept
+    {
+        uint64_t hash = 14695981039346656037ull; // FNV-1a
+
+        for (const char c : address)
+            hash = (hash ^ (unsigned char) c) * 1099511628211ull;
+
+        return hash;
+    }
+}
+
+// Packet copies waiting for dispatch. Slots keep their buffers, and a popped buffer is swapped
+// with the dispatcher's, so no allocation happens once every slot has held a large packet.
+struct PriorityDispatcher::Queue
+{
+    struct Entry
+    {
+        std::vector<char> data;
+        double receivedMs = 0.0;
+    };
+
+    // The pending single messages of a latest-only class, at most one per address. A newer
+    // value overwrites the pending one in place and keeps its turn and receipt time, so every
+    // address is dispatched at most once per pass over the pending addresses, however fast
+    // it changes.
+    struct LatestValues
+    {
+        explicit LatestValues(size_t capacity)
+            : slots(capacity),
+              hashes(capacity),
+              order(capacity)
+        {
+            size_t numIndexSlots = 16;
+
+            while (numIndexSlots < capacity * 2)
+                numIndexSlots <<= 1;
+
+            index.reset(numIndexSlots);
+
+            for (size_t slot = capacity; slot > 0; --slot)
+                freeSlots.push_back((uint32_t) slot - 1);
+        }
+
+        // False if every slot holds another address
+        bool put(std::string_view address, const char* data, size_t size, double receivedMs, bool& replaced)
+        {
+            const uint64_t hash = hashAddress(address);
+            const size_t position = index.find(hash, [&](const IndexEntry& entry) {
+                return entry.hash == hash
+                    && getFirstAddress(slots[entry.slot].data.data(), slots[entry.slot].data.size()) == address;
+            });
+
+            if (!IndexTraits::isEmpty(index[position]))
+            {
+                slots[index[position].slot].data.assign(data, data + size);
+                replaced = true;
+                return true;
+            }
+
+            replaced = false;
+
+            if (freeSlots.empty())
+                return false;
+
+            const uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+
+            slots[slot].data.assign(data, data + size);
+            slots[slot].receivedMs = receivedMs;
+            hashes[slot] = hash;
+            index.insert(position, { hash, slot });
+            order[(orderHead + count) % order.size()] = slot;
+            ++count;
+            return true;
+        }
+
+        bool pop(std::vector<char>& data, double& receivedMs)
+        {
+            if (count == 0)
+                return false;
+
+            const uint32_t slot = order[orderHead];
+            orderHead = (orderHead + 1) % order.size();
+            --count;
+
+            index.erase(index.find(hashes[slot], [slot](const IndexEntry& entry) { return entry.slot == slot; }));
+            data.swap(slots[slot].data);
+            receivedMs = slots[slot].receivedMs;
+            freeSlots.push_back(slot);
+            return true;
+        }
+
+        double getOldestMs() const noexcept { return slots[order[orderHead]].receivedMs; }
+
+        static constexpr uint32_t empty = ~(uint32_t) 0;
+
+        struct IndexEntry
+        {
+            uint64_t hash = 0;
+            uint32_t slot = empty;
+        };
+
+        struct IndexTraits
+        {
+            static bool isEmpty(const IndexEntry& entry) noexcept { return entry.slot == empty; }
+            static uint64_t getHash(const IndexEntry& entry) noexcept { return entry.hash; }
+        };
+
+        std::vector<Entry> slots;
+        std::vector<uint64_t> hashes;
+        OpenAddressingTable<IndexEntry, IndexTraits> index; // slot numbers by address
+        std::vector<uint32_t> order;   // pending slots in order of arrival
+        std::vector<uint32_t> freeSlots;
+        size_t orderHead = 0, count = 0;
+    };
+
+    explicit Queue(PriorityClass configToUse)
+        : config(std::move(configToUse)),
+          entries(config.capacity)
+    {
+        if (config.latestOnly)
+            latestValues = std::make_unique<LatestValues>(config.capacity);
+    }
+
+    enum class PushResult
+    {
+        queued,
+        replaced, // overwrote a pending value, so nothing more is queued
+        dropped
+    };
+
+    PushResult push(const char* data, size_t size, double receivedMs)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+
+        // Bundles may hold several addresses, so only single messages are coalesced
+        if (latestValues != nullptr && size > 0 && data[0] == '/')
+        {
+            bool replaced = false;
+
+            if (!latestValues->put(getFirstAddress(data, size), data, size, receivedMs, replaced))
+                return PushResult::dropped;
+
+            return replaced ? PushResult::replaced : PushResult::queued;
+        }
+
+        if (count == entries.size())
+            return PushResult::dropped;
+
+        auto& entry = entries[(head + count) % entries.size()];
+        entry.data.assign(data, data + size);
+        entry.receivedMs = receivedMs;
+        ++count;
+        return PushResult::queued;
+    }
+
+    bool pop(std::vector<char>& data, double& receivedMs)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+
+        // Oldest first across both kinds
+        if (latestValues != nullptr && latestValues->count > 0
+            && (count == 0 || latestValues->getOldestMs() <= entries[head].receivedMs))
+            return latestValues->pop(data, receivedMs);
+
+        if (count == 0)
+            return false;
+
+        auto& entry = entries[head];
+        data.swap(entry.data);
+        receivedMs = entry.receivedMs;
+        head = (head + 1) % entries.size();
+        --count;
+        return true;
+    }
+
+    size_t getNumPending()
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return count + (latestValues != nullptr ? latestValues->count : 0);
+    }
+
+    const PriorityClass config;
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    size_t head = 0, count = 0;
+    std::unique_ptr<LatestValues> latestValues;
+
+    std::atomic<juce::uint64> numDispatched{0};
+    std::atomic<juce::uint64> numDropped{0};
+    std::atomic<juce::uint64> numCoalesced{0};
+    LatencyHistogram latency;
+};
+
+bool PriorityDispatcher::PriorityClass::parse(const std::string& spec, PriorityClass& result)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+
+    for (size_t colon; (colon = spec.find(':', start)) != std::string::npos; start = colon + 1)
+        fields.push_back(spec.substr(start, colon - start));
+
+    fields.push_back(spec.substr(start));
+
+    if (fields.size() < 3 || fields.size() > 5 || fields[0].empty())
+        return false;
+
+    result = {};
+    result.name = fields[0];
+
+    for (size_t begin = 0; begin <= fields[1].size();)
+    {
+        const size_t comma = std::min(fields[1].find(',', begin), fields[1].size());
+        const auto prefix = fields[1].substr(begin, comma - begin);
+
+        if (prefix.empty() || prefix[0] != '/')
+            return false;
+
+        // "/sensor/" and "/sensor" mean the same
+        result.prefixes.push_back(prefix.size() > 1 && prefix.back() == '/' ? prefix.substr(0, prefix.size() - 1) : prefix);
+        begin = comma + 1;
+    }
+
+    result.weight = std::atoi(fields[2].c_str());
+
+    if (fields.size() >= 4)
+        result.capacity = (size_t) std::atoll(fields[3].c_str());
+
+    if (fields.size() == 5)
+    {
+        if (fields[4] != "latest")
+            return false;
+
+        result.latestOnly = true;
+    }
+
+    return result.weight > 0 && result.capacity > 0;
+}
+
+PriorityDispatcher::PriorityDispatcher(Handler handlerToUse)
+    : juce::Thread("OSC host priority dispatcher"),
+      handler(std::move(handlerToUse))
+{
+}
+
+PriorityDispatcher::~PriorityDispatcher()
+{
+    stop();
+}
+
+bool PriorityDispatcher::start(std::vector<PriorityClass> classes)
+{
+    stop();
+
+    if (classes.empty() || classes.back().name != "default")
+        classes.push_back({ "default", {}, 1, 4096, false });
+
+    queues.clear();
+    prefixes.clear();
+
+    for (auto& priorityClass : classes)
+    {
+        for (const auto& prefix : priorityClass.prefixes)
+            prefixes.emplace_back(prefix, queues.size());
+
+        queues.push_back(std::make_unique<Queue>(std::move(priorityClass)));
+    }
+
+    std::stable_sort(prefixes.begin(), prefixes.end(), [](const auto& a, const auto& b) {
+        return a.first.size() > b.first.size();
+    });
+
+    numQueued = 0;
+    startThread();
+    return true;
+}
+
+void PriorityDispatcher::stop()
+{
+    if (!isThreadRunning())
+        return;
+
+    signalThreadShouldExit();
+    wakeUp.signal();
+    stopThread(4000);
+}
+
+bool PriorityDispatcher::enqueue(const char* data, size_t size)
+{
+    auto& queue = *queues[classify(data, size)];
+    const auto result = queue.push(data, size, juce::Time::getMillisecondCounterHiRes());
+
+    if (result == Queue::PushResult::dropped)
+    {
+        queue.numDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (result == Queue::PushResult::replaced)
+    {
+        queue.numCoalesced.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Pairs with run(): either the dispatcher sees the new packet before it sleeps or we see
+    // that it is sleeping
+    numQueued.fetch_add(1);
+
+    if (sleeping.load() && sleeping.exchange(false))
+        wakeUp.signal();
+
+    return true;
+}
+
+std::vector<PriorityDispatcher::ClassStats> PriorityDispatcher::getStats() const
+{
+    std::vector<ClassStats> stats;
+
+    for (const auto& queue : queues)
+        stats.push_back({ queue->config.name,
+                          queue->config.latestOnly,
+                          queue->numDispatched.load(std::memory_order_relaxed),
+                          queue->numDropped.load(std::memory_order_relaxed),
+                          queue->numCoalesced.load(std::memory_order_relaxed),
+                          queue->getNumPending(),
+                          queue->latency.getSnapshot() });
+
+    return stats;
+}
+
+std::string_view PriorityDispatcher::getFirstAddress(const char* data, size_t size) noexcept
+{
+    // "#bundle\0", an 8-byte time tag, then each element's 4-byte size and contents
+    while (size >= 20 && std::memcmp(data, "#bundle", 8) == 0)
+    {
+        const auto* sizeBytes = reinterpret_cast<const unsigned char*>(data + 16);
+        const size_t elementSize = ((size_t) sizeBytes[0] << 24) | ((size_t) sizeBytes[1] << 16)
+                                 | ((size_t) sizeBytes[2] << 8) | (size_t) sizeBytes[3];
+        data += 20;
+        size = std::min(size - 20, elementSize);
+    }
+
+    if (size == 0 || data[0] != '/')
+        return {};
+
+    const auto* end = static_cast<const char*>(std::memchr(data, 0, size));
+    return end != nullptr ? std::string_view(data, (size_t) (end - data)) : std::string_view();
+}
+
+size_t PriorityDispatcher::classify(const char* data, size_t size) const noexcept
+{
+    const auto address = getFirstAddress(data, size);
+
+    for (const auto& [prefix, index] : prefixes)
+    {
+        if (prefix == "/" && !address.empty())
+            return index;
+
+        if (address.size() >= prefix.size() && address.compare(0, prefix.size(), prefix) == 0
+            && (address.size() == prefix.size() || address[prefix.size()] == '/'))
+            return index;
+    }
+
+    return queues.size() - 1;
+}
+
+void PriorityDispatcher::run()
+{
+    std::vector<char> packet;
+
+    while (!threadShouldExit())
+    {
+        bool dispatchedAny = false;
+
+        // One weighted round
+        for (auto& queue : queues)
+        {
+            double receivedMs = 0.0;
+
+            for (int i = 0; i < queue->config.weight && queue->pop(packet, receivedMs); ++i)
+            {
+                numQueued.fetch_sub(1, std::memory_order_relaxed);
+                handler(packet.data(), packet.size());
+
+                queue->latency.record(juce::Time::getMillisecondCounterHiRes() - receivedMs);
+                queue->numDispatched.fetch_add(1, std::memory_order_relaxed);
+                dispatchedAny = true;
+            }
+        }
+
+        if (dispatchedAny)
+            continue;
+
+        sleeping = true;
+
+        if (numQueued.load() == 0)
+            wakeUp.wait(100);
+
+        sleeping = false;
+    }
+}
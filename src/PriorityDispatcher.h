@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LatencyHistogram.h"
+
+// Sorts incoming packets into priority classes by address prefix and dispatches them on one
+// thread, so a flood of one kind of message cannot delay another. Each class has its own
+// bounded queue and a weight: every round the dispatcher takes up to weight packets from each
+// class in turn, so under overload a class gets a share of dispatch time proportional to its
+// weight, and a packet never waits longer than one round once it is at the head of its queue.
+// A full queue drops new packets for that class only.
+//
+// A latest-only class is meant for continuous values such as faders and sensor levels, where
+// only the newest value matters: a message for an address that is still waiting replaces the
+// waiting one instead of queueing behind it. Its memory and queueing delay are then bounded by
+// the number of distinct addresses rather than by the arrival rate. Bundles keep FIFO order.
+//
+// A packet belongs to the class with the longest prefix matching the address of its first
+// message (for bundles, the first message inside). Prefixes match whole path segments:
+// "/ping" matches "/ping" and "/ping/now" but not "/pings". Packets matching no prefix, or
+// without a readable address, go to the last class.
+class PriorityDispatcher : private juce::Thread
+{
+public:
+    struct PriorityClass
+    {
+        std::string name;
+        std::vector<std::string> prefixes;
+        int weight = 1;
+        size_t capacity = 4096; // packets; for latest-only classes also distinct addresses
+        bool latestOnly = false;
+
+        // Parses "name:prefix[,prefix...]:weight[:capacity[:latest]]",
+        // e.g. "health:/ping,/status:8:256" or "faders:/fader:1:1024:latest"
+        static bool parse(const std::string& spec, PriorityClass& result);
+    };
+
+    struct ClassStats
+    {
+        std::string name;
+        bool latestOnly = false;
+        juce::uint64 numDispatched = 0;
+        juce::uint64 numDropped = 0;
+        juce::uint64 numCoalesced = 0; // values overwritten by a newer one before dispatch
+        size_t numPending = 0;
+        LatencyHistogram::Snapshot latency; // from receipt until the handler returned
+    };
+
+    // Called on the dispatch thread for every packet
+    using Handler = std::function<void(const char* data, size_t size)>;
+
+    explicit PriorityDispatcher(Handler handlerToUse);
+    ~PriorityDispatcher() override;
+
+    // Appends a catch-all "default" class (weight 1) unless the last class is named "default"
+    bool start(std::vector<PriorityClass> classes);
+    void stop();
+    bool isRunning() const noexcept { return isThreadRunning(); }
+
+    // Any thread: copies the packet into its class's queue, or over the pending value for the
+    // same address in a latest-only class; false if the queue was full
+    bool enqueue(const char* data, size_t size);
+
+    // In class order; subtract an earlier result's snapshots to get a time window
+    std::vector<ClassStats> getStats() const;
+
+    // The address of the first message in a packet, or an empty view
+    static std::string_view getFirstAddress(const char* data, size_t size) noexcept;
+
+private:
+    struct Queue;
+
+    void run() override;
+    size_t classify(const char* data, size_t size) const noexcept;
+
+    Handler handler;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::pair<std::string, size_t>> prefixes; // longest first
+
+    std::atomic<juce::uint64> numQueued{0};
+    std::atomic<bool> sleeping{false};
+    juce::WaitableEvent wakeUp;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PriorityDispatcher)
+};
@@ -0,0 +1,336 @@
+#include "SourceRateLimiter.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    // Two slots per packet on average, so sweeping never adds noticeable latency. A shard is
+    // swept in runs on every 16th packet it sees, which keeps the walk sequential in memory.
+    constexpr uint32_t packetsPerSweep = 16;
+    constexpr size_t slotsSweptPerRun = 32;
+    constexpr size_t slotsSweptWhenFull = 64;
+}
+
+bool SourceRateLimiter::Settings::parse(const std::string& spec, Settings& result)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+
+    for (size_t colon; (colon = spec.find(':', start)) != std::string::npos; start = colon + 1)
+        fields.push_back(spec.substr(start, colon - start));
+
+    fields.push_back(spec.substr(start));
+
+    if (fields.size() > 3)
+        return false;
+
+    result = {};
+    result.packetsPerSecond = std::atof(fields[0].c_str());
+
+    if (fields.size() >= 2)
+        result.burst = std::atof(fields[1].c_str());
+
+    if (fields.size() == 3)
+        result.expirySeconds = std::atof(fields[2].c_str());
+
+    return result.packetsPerSecond > 0.0 && result.burst >= 0.0 && result.expirySeconds > 0.0;
+}
+
+void SourceRateLimiter::configure(const Settings& settingsToUse)
+{
+    settings = settingsToUse;
+    enabled = settings.packetsPerSecond > 0.0 && settings.maxSources > 0;
+    tokensPerMs = (float) (settings.packetsPerSecond / 1000.0);
+    burst = (float) std::max(1.0, settings.burst > 0.0 ? settings.burst : settings.packetsPerSecond);
+    expiryMs = (uint32_t) std::min(settings.expirySeconds * 1000.0, 86400000.0);
+    originMs = juce::Time::getMillisecondCounterHiRes();
+    // Sources rarely spread evenly, so a shard may take half as many again as its share
+    // before maxSources is reached. Tables are at most 40% full with an even spread, and at
+    // most 60% full in the worst case, which keeps probe sequences short with linear probing.
+    const size_t share = (settings.maxSources + numShards - 1) / numShards;
+    maxSourcesPerShard = share + share / 2;
+    size_t numSlots = 16;
+
+    while (enabled && numSlots * 2 < share * 5)
+        numSlots <<= 1;
+
+    numSources = 0;
+
+    for (auto& shard : shards)
+    {
+        const std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.entries.reset(enabled ? numSlots : 0);
+        shard.sweepPosition = 0;
+        shard.packetsUntilSweep = packetsPerSweep;
+        shard.lastNowMs = 0;
+        shard.numUntracked = shard.numAdmitted = shard.numRejected = 0;
+        shard.numOffenders = 0;
+    }
+
+    const std::lock_guard<std::mutex> lock(overflowMutex);
+    overflow = { 1, burst, 0, 0, 0 };
+    overflowLastNowMs = 0;
+}
+
+bool SourceRateLimiter::admit(uint32_t address, uint16_t port, double nowMs) noexcept
+{
+    if (!enabled)
+        return true;
+
+    const auto time = (uint32_t) (juce::int64) (nowMs - originMs);
+    const uint64_t key = makeKey(address, port);
+    const uint64_t hash = hashKey(key);
+
+    // The top bits pick the shard and the bottom bits the slot within it
+    auto& shard = shards[(size_t) (hash >> (64 - shardBits))];
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+
+    const uint32_t now = advanceClock(shard.lastNowMs, time);
+
+    if (--shard.packetsUntilSweep == 0)
+    {
+        shard.packetsUntilSweep = packetsPerSweep;
+        sweep(shard, slotsSweptPerRun, now);
+    }
+
+    size_t position = find(shard, key, hash);
+    bool admitted;
+
+    if (shard.entries[position].key != 0)
+    {
+        admitted = take(shard.entries[position], now);
+
+        if (!admitted)
+            noteRejection(shard, shard.entries[position]);
+    }
+    else
+    {
+        const auto isFull = [&] {
+            return shard.entries.getSize() >= maxSourcesPerShard
+                || numSources.load(std::memory_order_relaxed) >= settings.maxSources;
+        };
+
+        if (isFull())
+        {
+            sweep(shard, slotsSweptWhenFull, now);
+            sweepAnotherShard(shard, time);
+            position = find(shard, key, hash);
+        }
+
+        // Shards may race each other past maxSources by a source or two, which is harmless
+        if (!isFull())
+        {
+            shard.entries.insert(position, { key, burst, now, 0, 0 });
+            numSources.fetch_add(1, std::memory_order_relaxed);
+            admitted = take(shard.entries[position], now);
+        }
+        else
+        {
+            const std::lock_guard<std::mutex> overflowLock(overflowMutex);
+
+            ++shard.numUntracked;
+            admitted = take(overflow, advanceClock(overflowLastNowMs, time));
+        }
+    }
+
+    ++(admitted ? shard.numAdmitted : shard.numRejected);
+    return admitted;
+}
+
+uint32_t SourceRateLimiter::advanceClock(uint32_t& lastNowMs, uint32_t nowMs) noexcept
+{
+    // Each receive thread reads its clock before taking a lock, so an older time may arrive
+    // after a newer one; time never runs backwards for the buckets behind that lock
+    if ((int32_t) (nowMs - lastNowMs) < 0)
+        return lastNowMs;
+
+    lastNowMs = nowMs;
+    return nowMs;
+}
+
+bool SourceRateLimiter::take(Entry& entry, uint32_t nowMs) noexcept
+{
+    // Whole milliseconds only, so the remainder carries over to the next refill. A time
+    // before the last one refills nothing, rather than wrapping round to 49 days' worth.
+    const auto elapsedMs = (int32_t) (nowMs - entry.lastSeenMs);
+
+    if (elapsedMs > 0)
+        entry.tokens = std::min(burst, entry.tokens + (float) elapsedMs * tokensPerMs);
+
+    entry.lastSeenMs = nowMs;
+
+    if (entry.tokens >= 1.0f)
+    {
+        entry.tokens -= 1.0f;
+        ++entry.numAdmitted;
+        return true;
+    }
+
+    ++entry.numRejected;
+    return false;
+}
+
+void SourceRateLimiter::noteRejection(Shard& shard, const Entry& entry) noexcept
+{
+    const SourceStats stats { (uint32_t) (entry.key >> 16), (uint16_t) entry.key, entry.numAdmitted, entry.numRejected };
+    size_t fewest = 0;
+
+    for (size_t i = 0; i < shard.numOffenders; ++i)
+    {
+        auto& offender = shard.offenders[i];
+
+        if (offender.address == stats.address && offender.port == stats.port)
+        {
+            offender = stats;
+            return;
+        }
+
+        if (offender.numRejected < shard.offenders[fewest].numRejected)
+            fewest = i;
+    }
+
+    if (shard.numOffenders < shard.offenders.size())
+        shard.offenders[shard.numOffenders++] = stats;
+    else if (stats.numRejected > shard.offenders[fewest].numRejected)
+        shard.offenders[fewest] = stats;
+}
+
+uint64_t SourceRateLimiter::makeKey(uint32_t address, uint16_t port) noexcept
+{
+    // The top bit keeps 0 free to mark empty slots
+    return (1ull << 63) | ((uint64_t) address << 16) | port;
+}
+
+uint64_t SourceRateLimiter::hashKey(uint64_t key) noexcept
+{
+    // Mixes the bits so that neighbouring addresses and ports land far apart
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return key;
+}
+
+size_t SourceRateLimiter::find(const Shard& shard, uint64_t key, uint64_t hash) noexcept
+{
+    return shard.entries.find(hash, [key](const Entry& entry) { return entry.key == key; });
+}
+
+void SourceRateLimiter::sweep(Shard& shard, size_t numSlots, uint32_t nowMs) noexcept
+{
+    auto& entries = shard.entries;
+
+    for (size_t i = 0; i < numSlots; ++i)
+    {
+        const auto& entry = entries[shard.sweepPosition];
+
+        // erase() may shift another entry into this slot, which is then looked at next
+        if (entry.key != 0 && (int32_t) (nowMs - entry.lastSeenMs) > (int32_t) expiryMs)
+        {
+            entries.erase(shard.sweepPosition);
+            numSources.fetch_sub(1, std::memory_order_relaxed);
+        }
+        else
+            shard.sweepPosition = (shard.sweepPosition + 1) & (entries.getNumSlots() - 1);
+    }
+}
+
+void SourceRateLimiter::sweepAnotherShard(Shard& shard, uint32_t time) noexcept
+{
+    // Idle sources in shards that no packets reach would otherwise fill the tables for good.
+    // Another thread busy with that shard sweeps it anyway, so it is skipped rather than
+    // waited for; locking it only if free also keeps two full shards from deadlocking.
+    const size_t index = (size_t) (&shard - shards.data());
+    auto& other = shards[(index + 1 + shard.nextShardToSweep++ % (numShards - 1)) % numShards];
+    const std::unique_lock<std::mutex> lock(other.mutex, std::try_to_lock);
+
+    if (lock.owns_lock())
+        sweep(other, slotsSweptWhenFull, advanceClock(other.lastNowMs, time));
+}
+
+juce::uint64 SourceRateLimiter::getNumAdmitted() const noexcept
+{
+    juce::uint64 total = 0;
+
+    for (const auto& shard : shards)
+    {
+        const std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.numAdmitted;
+    }
+
+    return total;
+}
+
+juce::uint64 SourceRateLimiter::getNumRejected() const noexcept
+{
+    juce::uint64 total = 0;
+
+    for (const auto& shard : shards)
+    {
+        const std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.numRejected;
+    }
+
+    return total;
+}
+
+juce::uint64 SourceRateLimiter::getNumUntracked() const noexcept
+{
+    juce::uint64 total = 0;
+
+    for (const auto& shard : shards)
+    {
+        const std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.numUntracked;
+    }
+
+    return total;
+}
+
+size_t SourceRateLimiter::getNumSources() const noexcept
+{
+    return numSources.load(std::memory_order_relaxed);
+}
+
+bool SourceRateLimiter::getSourceStats(uint32_t address, uint16_t port, SourceStats& result) const
+{
+    if (!enabled)
+        return false;
+
+    const uint64_t key = makeKey(address, port);
+    const uint64_t hash = hashKey(key);
+    const auto& shard = shards[(size_t) (hash >> (64 - shardBits))];
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+
+    const auto& entry = shard.entries[find(shard, key, hash)];
+
+    if (entry.key == 0)
+        return false;
+
+    result = { address, port, entry.numAdmitted, entry.numRejected };
+    return true;
+}
+
+std::vector<SourceRateLimiter::SourceStats> SourceRateLimiter::getTopOffenders(size_t count) const
+{
+    std::vector<SourceStats> offenders;
+
+    // Every source in the overall top maxTopOffenders is in its own shard's top as well
+    for (const auto& shard : shards)
+    {
+        const std::lock_guard<std::mutex> lock(shard.mutex);
+        offenders.insert(offenders.end(), shard.offenders.begin(), shard.offenders.begin() + (std::ptrdiff_t) shard.numOffenders);
+    }
+
+    const auto byRejections = [](const SourceStats& a, const SourceStats& b) { return a.numRejected > b.numRejected; };
+    const auto end = offenders.begin() + (std::ptrdiff_t) std::min({ count, maxTopOffenders, offenders.size() });
+    std::partial_sort(offenders.begin(), end, offenders.end(), byRejections);
+    offenders.erase(end, offenders.end());
+    return offenders;
+}
+
+std::string SourceRateLimiter::formatSource(uint32_t address, uint16_t port)
+{
+    return std::to_string(address >> 24) + "." + std::to_string((address >> 16) & 0xff) + "."
+         + std::to_string((address >> 8) & 0xff) + "." + std::to_string(address & 0xff) + ":" + std::to_string(port);
+}
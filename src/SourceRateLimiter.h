@@ -0,0 +1,137 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "OpenAddressingTable.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Admission control at the front of the UDP receive path: a token bucket per source address
+// and port, so one client flooding the host only loses its own packets. Every source may send
+// packetsPerSecond on average and burst packets at once. Admitting a packet is a hash lookup
+// and a little arithmetic, without parsing or allocating, so rejected packets cost almost
+// nothing.
+//
+// Buckets live in fixed open-addressing tables (linear probing, backward-shift deletion)
+// with room for maxSources at under 40% load. The tables are split into shards by source,
+// each behind its own lock, so the UDP, io_uring and AF_XDP receive threads rarely contend.
+// Sources idle for expirySeconds are swept out a few slots at a time as packets for their
+// shard arrive, and from other shards too once the tables are full. When they are full,
+// packets from sources that do not fit share one overflow bucket, so a flood of spoofed
+// addresses cannot lock out new clients entirely nor get past the limit.
+class SourceRateLimiter
+{
+public:
+    struct Settings
+    {
+        double packetsPerSecond = 0.0; // 0 disables limiting
+        double burst = 0.0;            // bucket size in packets; 0 means one second's worth
+        double expirySeconds = 30.0;
+        size_t maxSources = 100000;
+
+        // Parses "<packets/s>[:<burst>[:<expiry seconds>]]", e.g. "2000:500"
+        static bool parse(const std::string& spec, Settings& result);
+    };
+
+    struct SourceStats
+    {
+        uint32_t address = 0; // IPv4, host byte order
+        uint16_t port = 0;
+        juce::uint64 numAdmitted = 0;
+        juce::uint64 numRejected = 0;
+    };
+
+    SourceRateLimiter() = default;
+
+    // Not while packets are being admitted
+    void configure(const Settings& settingsToUse);
+    bool isEnabled() const noexcept { return enabled; }
+    const Settings& getSettings() const noexcept { return settings; }
+
+    // Any thread: takes a token from the source's bucket; false if the packet should be dropped
+    bool admit(uint32_t address, uint16_t port, double nowMs) noexcept;
+
+    juce::uint64 getNumAdmitted() const noexcept;
+    juce::uint64 getNumRejected() const noexcept;
+    juce::uint64 getNumUntracked() const noexcept; // packets that went to the overflow bucket
+    size_t getNumSources() const noexcept;
+
+    // Counters of a source since it was last seen after being idle for expirySeconds
+    bool getSourceStats(uint32_t address, uint16_t port, SourceStats& result) const;
+
+    // Up to maxTopOffenders sources with the most rejected packets, most first, with their
+    // counters as of their latest rejection; sources without any are left out
+    std::vector<SourceStats> getTopOffenders(size_t count) const;
+
+    static constexpr size_t maxTopOffenders = 8;
+
+    static std::string formatSource(uint32_t address, uint16_t port);
+
+private:
+    struct Entry
+    {
+        uint64_t key = 0; // 0 when empty
+        float tokens = 0.0f;
+        uint32_t lastSeenMs = 0; // since configure(); only signed differences are used, so it may wrap
+        juce::uint64 numAdmitted = 0;
+        juce::uint64 numRejected = 0;
+    };
+
+    struct EntryTraits
+    {
+        static bool isEmpty(const Entry& entry) noexcept { return entry.key == 0; }
+        static uint64_t getHash(const Entry& entry) noexcept { return hashKey(entry.key); }
+    };
+
+    // Sources are spread over shards by the top bits of their hash, each with its own lock,
+    // table and counters, so receive threads only wait for each other when they see sources
+    // in the same shard at the same moment
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        OpenAddressingTable<Entry, EntryTraits> entries;
+        size_t sweepPosition = 0;
+        uint32_t packetsUntilSweep = 0;
+        size_t nextShardToSweep = 0; // when the tables are full; see sweepAnotherShard()
+        uint32_t lastNowMs = 0; // latest time seen, in the same units as Entry::lastSeenMs
+        juce::uint64 numUntracked = 0;
+        juce::uint64 numAdmitted = 0, numRejected = 0;
+
+        // The shard's sources with the most rejections, kept up to date as packets are
+        // rejected so reports never have to walk the table
+        std::array<SourceStats, maxTopOffenders> offenders;
+        size_t numOffenders = 0;
+    };
+
+    static constexpr int shardBits = 4;
+    static constexpr size_t numShards = (size_t) 1 << shardBits;
+
+    static uint64_t makeKey(uint32_t address, uint16_t port) noexcept;
+    static uint64_t hashKey(uint64_t key) noexcept;
+    static size_t find(const Shard& shard, uint64_t key, uint64_t hash) noexcept;
+    static uint32_t advanceClock(uint32_t& lastNowMs, uint32_t nowMs) noexcept;
+    bool take(Entry& entry, uint32_t nowMs) noexcept;
+    static void noteRejection(Shard& shard, const Entry& entry) noexcept;
+    void sweep(Shard& shard, size_t numSlots, uint32_t nowMs) noexcept;
+    void sweepAnotherShard(Shard& shard, uint32_t time) noexcept;
+
+    Settings settings;
+    bool enabled = false;
+    float tokensPerMs = 0.0f, burst = 0.0f;
+    uint32_t expiryMs = 0;
+    double originMs = 0.0;
+    size_t maxSourcesPerShard = 0;
+
+    std::array<Shard, numShards> shards;
+    std::atomic<size_t> numSources { 0 }; // across all shards, to enforce maxSources
+
+    // Shared by sources that find their shard full; taken while holding that shard's lock
+    std::mutex overflowMutex;
+    Entry overflow;
+    uint32_t overflowLastNowMs = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SourceRateLimiter)
+};
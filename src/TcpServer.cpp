@@ -0,0 +1,410 @@
+#include "TcpServer.h"
+#include <iostream>
+#include <optional>
+
+#if JUCE_LINUX
+ #include <cerrno>
+ #include <cstring>
+ #include <fcntl.h>
+ #include <netinet/in.h>
+ #include <netinet/tcp.h>
+ #include <sys/epoll.h>
+ #include <sys/eventfd.h>
+ #include <sys/resource.h>
+ #include <sys/socket.h>
+ #include <unistd.h>
+#endif
+
+struct TcpServer::Connection : public OscReplyChannel
+{
+    explicit Connection(int socketToUse) : socket(socketToUse) {}
+
+    bool sendReply(const char* data, size_t size) override
+    {
+        if (overflowed)
+            return false;
+
+        // Before the client has sent anything its framing is unknown; length prefixes are the
+        // OSC 1.0 default
+        appendFramedPacket(decoder ? decoder->getFraming() : OscFraming::lengthPrefix, data, size, writeBuffer);
+
+        if (writeBuffer.size() - writeOffset > maxWriteBufferSize)
+        {
+            overflowed = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    int socket;
+    std::optional<OscStreamDecoder> decoder;
+    std::vector<char> writeBuffer;
+    size_t writeOffset = 0;
+    bool overflowed = false;
+};
+
+TcpServer::TcpServer(PacketCallback callbackToUse)
+    : juce::Thread("OSC TCP server"),
+      callback(std::move(callbackToUse))
+{
+}
+
+TcpServer::~TcpServer()
+{
+    stop();
+}
+
+#if JUCE_LINUX
+
+bool TcpServer::start(int port, Framing framingToUse)
+{
+    if (isRunning())
+        return false;
+
+    listenSocket = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (listenSocket < 0)
+        return false;
+
+    const int one = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t) port);
+
+    if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(listenSocket, SOMAXCONN) != 0)
+    {
+        std::cerr << "Failed to listen for TCP on port " << port << std::endl;
+        stop();
+        return false;
+    }
+
+    isTcp = true;
+    return startServing(framingToUse);
+}
+
+bool TcpServer::startLocal(const std::string& path, Framing framingToUse)
+{
+    if (isRunning())
+        return false;
+
+    if (!localListener.bind(path, OscLocalSocket::Type::stream))
+    {
+        std::cerr << "Failed to listen on local socket " << path << std::endl;
+        return false;
+    }
+
+    listenSocket = localListener.getHandle();
+    fcntl(listenSocket, F_SETFL, fcntl(listenSocket, F_GETFL) | O_NONBLOCK);
+
+    isTcp = false;
+    return startServing(framingToUse);
+}
+
+bool TcpServer::startServing(Framing framingToUse)
+{
+    framing = framingToUse;
+
+    // Thousands of connections need more descriptors than the usual soft limit of 1024
+    rlimit limit;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    spareFd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        stop();
+        return false;
+    }
+
+    // The listening socket and wake-up eventfd are told apart from connections by pointer
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = &listenSocket;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenSocket, &event);
+
+    event.events = EPOLLIN;
+    event.data.ptr = &wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    readBuffer.resize(65536);
+    startThread();
+    return true;
+}
+
+void TcpServer::stop()
+{
+    if (isThreadRunning())
+    {
+        signalThreadShouldExit();
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(wakeFd, &one, sizeof(one));
+        stopThread(4000);
+    }
+
+    for (auto& entry : connections)
+        ::close(entry.first);
+
+    connections.clear();
+    numOpen.store(0, std::memory_order_relaxed);
+
+    // Also removes the socket file
+    if (localListener.isOpen())
+    {
+        localListener.close();
+        listenSocket = -1;
+    }
+
+    for (int* fd : { &listenSocket, &epollFd, &wakeFd, &spareFd })
+    {
+        if (*fd >= 0)
+            ::close(*fd);
+
+        *fd = -1;
+    }
+}
+
+void TcpServer::run()
+{
+    std::vector<epoll_event> events(256);
+
+    while (!threadShouldExit())
+    {
+        const int numEvents = epoll_wait(epollFd, events.data(), (int) events.size(), -1);
+
+        if (numEvents < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const auto& event = events[(size_t) i];
+
+            if (event.data.ptr == &wakeFd)
+                return;
+
+            if (event.data.ptr == &listenSocket)
+            {
+                acceptConnections();
+                continue;
+            }
+
+            auto& connection = *static_cast<Connection*>(event.data.ptr);
+
+            if ((event.events & EPOLLOUT) != 0)
+                flush(connection);
+
+            // EPOLLRDHUP and EPOLLHUP still come with readable data to drain first; read()
+            // then returns 0 and the connection is closed there
+            if ((event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0)
+                readFrom(connection);
+        }
+    }
+}
+
+void TcpServer::acceptConnections()
+{
+    // Edge-triggered: take every pending connection, or no further notification comes
+    for (;;)
+    {
+        const int socket = accept4(listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (socket < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            if ((errno == EMFILE || errno == ENFILE) && spareFd >= 0)
+            {
+                // Accept the client and hang up on it, rather than leave it queued forever
+                ::close(spareFd);
+                const int rejected = accept(listenSocket, nullptr, nullptr);
+
+                if (rejected >= 0)
+                    ::close(rejected);
+
+                spareFd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+                std::cerr << "Out of file descriptors; rejected a TCP client" << std::endl;
+                continue;
+            }
+
+            break; // EAGAIN: nothing more pending
+        }
+
+        if ((int) connections.size() >= maxConnections)
+        {
+            ::close(socket);
+            continue;
+        }
+
+        if (isTcp)
+        {
+            const int one = 1;
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        auto connection = std::make_unique<Connection>(socket);
+
+        if (framing == Framing::lengthPrefix)
+            connection->decoder.emplace(OscFraming::lengthPrefix, maxPacketSize);
+        else if (framing == Framing::slip)
+            connection->decoder.emplace(OscFraming::slip, maxPacketSize);
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.ptr = connection.get();
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, socket, &event) != 0)
+        {
+            ::close(socket);
+            continue;
+        }
+
+        connections.emplace(socket, std::move(connection));
+        numAccepted.fetch_add(1, std::memory_order_relaxed);
+        numOpen.store(connections.size(), std::memory_order_relaxed);
+    }
+}
+
+void TcpServer::readFrom(Connection& connection)
+{
+    bool corrupt = false;
+    bool closed = false;
+
+    // Edge-triggered: drain the socket completely
+    for (;;)
+    {
+        const ssize_t bytesRead = ::read(connection.socket, readBuffer.data(), readBuffer.size());
+
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            closed = errno != EAGAIN && errno != EWOULDBLOCK;
+            break;
+        }
+
+        if (bytesRead == 0)
+        {
+            closed = true;
+            break;
+        }
+
+        if (!connection.decoder)
+        {
+            const bool isSlip = (uint8_t) readBuffer[0] == OscStreamDecoder::slipEnd;
+            connection.decoder.emplace(isSlip ? OscFraming::slip : OscFraming::lengthPrefix, maxPacketSize);
+        }
+
+        corrupt = !connection.decoder->feed(readBuffer.data(), (size_t) bytesRead, [this, &connection](const char* packet, size_t size) {
+            callback(packet, size, connection);
+        });
+
+        if (corrupt || connection.overflowed)
+            break;
+    }
+
+    if (corrupt)
+    {
+        numCorrupt.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Closing TCP client with corrupt framing" << std::endl;
+    }
+
+    // Replies queued while dispatching go out in as few writes as possible
+    if (!corrupt && !connection.overflowed)
+        flush(connection);
+
+    if (corrupt || closed || connection.overflowed)
+        close(connection);
+}
+
+void TcpServer::flush(Connection& connection)
+{
+    while (connection.writeOffset < connection.writeBuffer.size())
+    {
+        const ssize_t written = ::send(connection.socket,
+                                       connection.writeBuffer.data() + connection.writeOffset,
+                                       connection.writeBuffer.size() - connection.writeOffset,
+                                       MSG_NOSIGNAL);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // EAGAIN: EPOLLOUT reports when there is room again. Other errors surface as
+            // EPOLLERR and close the connection from readFrom().
+            break;
+        }
+
+        connection.writeOffset += (size_t) written;
+    }
+
+    if (connection.writeOffset == connection.writeBuffer.size())
+    {
+        connection.writeBuffer.clear();
+        connection.writeOffset = 0;
+    }
+    else if (connection.writeOffset > connection.writeBuffer.size() / 2)
+    {
+        connection.writeBuffer.erase(connection.writeBuffer.begin(),
+                                     connection.writeBuffer.begin() + (std::ptrdiff_t) connection.writeOffset);
+        connection.writeOffset = 0;
+    }
+}
+
+void TcpServer::close(Connection& connection)
+{
+    if (connection.overflowed)
+    {
+        numOverflowed.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Closing TCP client that is not reading its replies" << std::endl;
+    }
+
+    // Closing the descriptor removes it from the epoll set
+    const int socket = connection.socket;
+    ::close(socket);
+    connections.erase(socket);
+    numOpen.store(connections.size(), std::memory_order_relaxed);
+}
+
+#else
+
+bool TcpServer::start(int, Framing)
+{
+    std::cerr << "OSC over TCP is only available on Linux" << std::endl;
+    return false;
+}
+
+bool TcpServer::startLocal(const std::string&, Framing)
+{
+    std::cerr << "OSC over local stream sockets is only available on Linux" << std::endl;
+    return false;
+}
+
+bool TcpServer::startServing(Framing) { return false; }
+void TcpServer::stop() {}
+void TcpServer::run() {}
+void TcpServer::acceptConnections() {}
+void TcpServer::readFrom(Connection&) {}
+void TcpServer::flush(Connection&) {}
+void TcpServer::close(Connection&) {}
+
+#endif
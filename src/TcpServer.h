@@ -0,0 +1,95 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "OscLocalSocket.h"
+#include "OscStreamFraming.h"
+
+// Where replies to a packet go when it arrived on a connection rather than as a datagram
+class OscReplyChannel
+{
+public:
+    virtual ~OscReplyChannel() = default;
+
+    // Frames and queues one packet; false if it was dropped
+    virtual bool sendReply(const char* data, size_t size) = 0;
+};
+
+// OSC over TCP: one thread serves every connection from an edge-triggered epoll loop.
+// Each connection uses either OSC 1.0 length-prefix or OSC 1.1 SLIP framing; by default
+// the framing is detected from the first byte a client sends (SLIP packets start with END,
+// length prefixes of any sane packet with 0). Sockets get TCP_NODELAY so small control
+// messages are not held back by Nagle's algorithm.
+//
+// Replies are queued in a per-connection write buffer of at most maxWriteBufferSize bytes;
+// a client that stops reading is disconnected instead of growing it without bound.
+//
+// startLocal() serves the same protocol on an AF_UNIX stream socket instead, for clients on
+// the same machine.
+//
+// Linux only; start() and startLocal() fail on other platforms.
+class TcpServer : private juce::Thread
+{
+public:
+    enum class Framing
+    {
+        detect,
+        lengthPrefix,
+        slip
+    };
+
+    // Called on the server thread for each complete packet
+    using PacketCallback = std::function<void(const char* data, size_t size, OscReplyChannel& reply)>;
+
+    explicit TcpServer(PacketCallback callbackToUse);
+    ~TcpServer() override;
+
+    bool start(int port, Framing framingToUse = Framing::detect);
+    bool startLocal(const std::string& path, Framing framingToUse = Framing::detect);
+    void stop();
+    bool isRunning() const noexcept { return listenSocket >= 0; }
+
+    juce::uint64 getNumAccepted() const noexcept { return numAccepted.load(std::memory_order_relaxed); }
+    juce::uint64 getNumOpen() const noexcept { return numOpen.load(std::memory_order_relaxed); }
+    juce::uint64 getNumCorrupt() const noexcept { return numCorrupt.load(std::memory_order_relaxed); }
+    juce::uint64 getNumOverflowed() const noexcept { return numOverflowed.load(std::memory_order_relaxed); }
+
+    static constexpr size_t maxPacketSize = 1 << 20;
+    static constexpr size_t maxWriteBufferSize = 256 * 1024;
+    static constexpr int maxConnections = 16384;
+
+private:
+    struct Connection;
+
+    bool startServing(Framing framingToUse);
+    void run() override;
+    void acceptConnections();
+    void readFrom(Connection& connection);
+    void flush(Connection& connection);
+    void close(Connection& connection);
+
+    PacketCallback callback;
+    Framing framing = Framing::detect;
+    bool isTcp = true;
+    OscLocalSocket localListener;
+
+    int listenSocket = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    int spareFd = -1; // released to accept and drop a client when out of descriptors
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::vector<char> readBuffer;
+
+    std::atomic<juce::uint64> numAccepted{0};
+    std::atomic<juce::uint64> numOpen{0};
+    std::atomic<juce::uint64> numCorrupt{0};
+    std::atomic<juce::uint64> numOverflowed{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TcpServer)
+};
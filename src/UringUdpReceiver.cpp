@@ -0,0 +1,453 @@
+#include "UringUdpReceiver.h"
+#include "OscUdpOffload.h"
+
+#if JUCE_LINUX && __has_include(<linux/io_uring.h>)
+ #include <linux/io_uring.h>
+ #ifdef IORING_RECV_MULTISHOT
+  #define OSC_IO_URING 1
+ #endif
+#endif
+
+#if OSC_IO_URING
+ #include <algorithm>
+ #include <arpa/inet.h>
+ #include <cerrno>
+ #include <csignal>
+ #include <cstring>
+ #include <linux/time_types.h>
+ #include <netinet/in.h>
+ #include <sys/mman.h>
+ #include <sys/socket.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+
+namespace
+{
+    constexpr unsigned queueDepth = 256;
+    constexpr uint16_t bufferGroup = 0;
+    constexpr uint64_t receiveTag = 0;
+    constexpr uint64_t firstSendTag = 1; // firstSendTag + slot
+
+    std::string describeError(const char* call, int errorNumber)
+    {
+        return std::string(call) + ": " + std::strerror(errorNumber);
+    }
+}
+
+struct UringUdpReceiver::Ring : public OscReplyChannel
+{
+    ~Ring() override
+    {
+        if (fd >= 0)
+            ::close(fd);
+
+        if (queueMemory != MAP_FAILED)
+            munmap(queueMemory, queueMemorySize);
+
+        if (completionMemory != MAP_FAILED && completionMemory != queueMemory)
+            munmap(completionMemory, completionMemorySize);
+
+        if (entries != MAP_FAILED)
+            munmap(entries, entriesSize);
+
+        if (bufferRing != MAP_FAILED)
+            munmap(bufferRing, bufferRingSize);
+
+        if (buffers != MAP_FAILED)
+            munmap(buffers, (size_t) numBuffers * bufferSize);
+    }
+
+    bool setUp(int socketToUse, std::string& error)
+    {
+        socket = socketToUse;
+
+        // Completions are only posted while we wait for them, which batches the work and
+        // keeps it on this thread; older kernels get a plain ring
+        io_uring_params params{};
+        params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        fd = (int) syscall(__NR_io_uring_setup, queueDepth, &params);
+
+        if (fd < 0 && errno == EINVAL)
+        {
+            params = {};
+            fd = (int) syscall(__NR_io_uring_setup, queueDepth, &params);
+        }
+
+        if (fd < 0)
+        {
+            error = describeError("io_uring_setup", errno);
+            return false;
+        }
+
+        if ((params.features & IORING_FEAT_EXT_ARG) == 0 || (params.features & IORING_FEAT_NODROP) == 0)
+        {
+            error = "io_uring lacks timed waits or overflow protection (kernel too old)";
+            return false;
+        }
+
+        // Submission and completion queues share one mapping on every kernel with EXT_ARG
+        queueMemorySize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        completionMemorySize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+            queueMemorySize = completionMemorySize = std::max(queueMemorySize, completionMemorySize);
+
+        queueMemory = mmap(nullptr, queueMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        completionMemory = (params.features & IORING_FEAT_SINGLE_MMAP) != 0
+                         ? queueMemory
+                         : mmap(nullptr, completionMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        entriesSize = params.sq_entries * sizeof(io_uring_sqe);
+        entries = mmap(nullptr, entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+        if (queueMemory == MAP_FAILED || completionMemory == MAP_FAILED || entries == MAP_FAILED)
+        {
+            error = describeError("mmap", errno);
+            return false;
+        }
+
+        auto* queueBytes = static_cast<char*>(queueMemory);
+        submissionHead = reinterpret_cast<unsigned*>(queueBytes + params.sq_off.head);
+        submissionTail = reinterpret_cast<unsigned*>(queueBytes + params.sq_off.tail);
+        submissionMask = *reinterpret_cast<unsigned*>(queueBytes + params.sq_off.ring_mask);
+        submissionArray = reinterpret_cast<unsigned*>(queueBytes + params.sq_off.array);
+        submissionEntries = params.sq_entries;
+        localTail = *submissionTail;
+
+        auto* completionBytes = static_cast<char*>(completionMemory);
+        completionHead = reinterpret_cast<unsigned*>(completionBytes + params.cq_off.head);
+        completionTail = reinterpret_cast<unsigned*>(completionBytes + params.cq_off.tail);
+        completionMask = *reinterpret_cast<unsigned*>(completionBytes + params.cq_off.ring_mask);
+        completions = reinterpret_cast<io_uring_cqe*>(completionBytes + params.cq_off.cqes);
+
+        return setUpBuffers(error);
+    }
+
+    // The kernel picks a free buffer from this ring for each datagram; run() hands buffers
+    // back by appending them and advancing the tail
+    bool setUpBuffers(std::string& error)
+    {
+        bufferRingSize = numBuffers * sizeof(io_uring_buf);
+        bufferRing = static_cast<io_uring_buf*>(mmap(nullptr, bufferRingSize, PROT_READ | PROT_WRITE,
+                                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        buffers = static_cast<char*>(mmap(nullptr, (size_t) numBuffers * bufferSize, PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+        if (bufferRing == MAP_FAILED || buffers == MAP_FAILED)
+        {
+            error = describeError("mmap", errno);
+            return false;
+        }
+
+        io_uring_buf_reg registration{};
+        registration.ring_addr = reinterpret_cast<uint64_t>(bufferRing);
+        registration.ring_entries = numBuffers;
+        registration.bgid = bufferGroup;
+
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PBUF_RING, &registration, 1) != 0)
+        {
+            error = describeError("io_uring_register(PBUF_RING)", errno);
+            return false;
+        }
+
+        for (unsigned id = 0; id < numBuffers; ++id)
+            recycle((uint16_t) id);
+
+        publishBuffers();
+
+        // The kernel writes an io_uring_recvmsg_out header, the source address and the
+        // control data (where UDP_GRO reports the segment size) in front of each payload
+        receiveHeader.msg_namelen = sizeof(sockaddr_in);
+        receiveHeader.msg_controllen = OscUdpOffload::receiveControlSpace;
+        return true;
+    }
+
+    bool setReplyAddress(const std::string& host, int port)
+    {
+        replyAddress.sin_family = AF_INET;
+        replyAddress.sin_port = htons((uint16_t) port);
+        return inet_pton(AF_INET, host.c_str(), &replyAddress.sin_addr) == 1;
+    }
+
+    io_uring_sqe* getEntry()
+    {
+        if (localTail - __atomic_load_n(submissionHead, __ATOMIC_ACQUIRE) >= submissionEntries)
+        {
+            // Queue full: hand what we have to the kernel first
+            submitAndWait(0, 0);
+
+            if (localTail - __atomic_load_n(submissionHead, __ATOMIC_ACQUIRE) >= submissionEntries)
+                return nullptr;
+        }
+
+        const unsigned index = localTail & submissionMask;
+        auto* entry = static_cast<io_uring_sqe*>(entries) + index;
+        std::memset(entry, 0, sizeof(*entry));
+        submissionArray[index] = index;
+        ++localTail;
+        ++pendingSubmissions;
+        return entry;
+    }
+
+    bool armReceive()
+    {
+        auto* entry = getEntry();
+
+        if (entry == nullptr)
+            return false;
+
+        entry->opcode = IORING_OP_RECVMSG;
+        entry->fd = socket;
+        entry->addr = reinterpret_cast<uint64_t>(&receiveHeader);
+        entry->len = 1;
+        entry->ioprio = IORING_RECV_MULTISHOT;
+        entry->flags = IOSQE_BUFFER_SELECT;
+        entry->buf_group = bufferGroup;
+        entry->user_data = receiveTag;
+        return true;
+    }
+
+    // Copies the reply into a free slot and queues a sendmsg; it is submitted together with
+    // the next wait
+    bool sendReply(const char* data, size_t size) override
+    {
+        for (unsigned slot = 0; slot < numSendSlots; ++slot)
+        {
+            auto& send = sendSlots[slot];
+
+            if (send.busy)
+                continue;
+
+            auto* entry = getEntry();
+
+            if (entry == nullptr)
+                return false;
+
+            send.data.assign(data, data + size);
+            send.payload = { send.data.data(), size };
+            send.header = {};
+            send.header.msg_name = &replyAddress;
+            send.header.msg_namelen = sizeof(replyAddress);
+            send.header.msg_iov = &send.payload;
+            send.header.msg_iovlen = 1;
+            send.busy = true;
+
+            entry->opcode = IORING_OP_SENDMSG;
+            entry->fd = socket;
+            entry->addr = reinterpret_cast<uint64_t>(&send.header);
+            entry->len = 1;
+            entry->user_data = firstSendTag + slot;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Returns false on a ring error other than a timeout or interruption
+    bool submitAndWait(unsigned minComplete, int timeoutMs)
+    {
+        __atomic_store_n(submissionTail, localTail, __ATOMIC_RELEASE);
+
+        __kernel_timespec timeout { timeoutMs / 1000, (long long) (timeoutMs % 1000) * 1000000 };
+        io_uring_getevents_arg wait{};
+        wait.sigmask_sz = _NSIG / 8;
+        wait.ts = reinterpret_cast<uint64_t>(&timeout);
+
+        const long result = syscall(__NR_io_uring_enter, fd, pendingSubmissions, minComplete,
+                                    IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &wait, sizeof(wait));
+
+        if (result >= 0)
+            pendingSubmissions -= juce::jmin(pendingSubmissions, (unsigned) result);
+
+        return result >= 0 || errno == ETIME || errno == EINTR || errno == EBUSY;
+    }
+
+    void recycle(uint16_t id)
+    {
+        auto& entry = bufferRing[bufferTail & (numBuffers - 1)];
+        entry.addr = reinterpret_cast<uint64_t>(buffers + (size_t) id * bufferSize);
+        entry.len = (uint32_t) bufferSize;
+        entry.bid = id;
+        ++bufferTail;
+    }
+
+    void publishBuffers()
+    {
+        // The tail shares the first entry's reserved field
+        __atomic_store_n(&bufferRing[0].resv, bufferTail, __ATOMIC_RELEASE);
+    }
+
+    int fd = -1;
+    int socket = -1;
+
+    void* queueMemory = MAP_FAILED;
+    void* completionMemory = MAP_FAILED;
+    void* entries = MAP_FAILED;
+    size_t queueMemorySize = 0, completionMemorySize = 0, entriesSize = 0;
+
+    unsigned* submissionHead = nullptr;
+    unsigned* submissionTail = nullptr;
+    unsigned* submissionArray = nullptr;
+    unsigned submissionMask = 0, submissionEntries = 0;
+    unsigned localTail = 0;
+    unsigned pendingSubmissions = 0;
+
+    unsigned* completionHead = nullptr;
+    unsigned* completionTail = nullptr;
+    unsigned completionMask = 0;
+    io_uring_cqe* completions = nullptr;
+
+    // Addressed as plain entries: in C++ the header's io_uring_buf_ring puts bufs[] 8 bytes
+    // past where the kernel expects it
+    io_uring_buf* bufferRing = static_cast<io_uring_buf*>(MAP_FAILED);
+    size_t bufferRingSize = 0;
+    char* buffers = static_cast<char*>(MAP_FAILED);
+    uint16_t bufferTail = 0;
+
+    msghdr receiveHeader{};
+    sockaddr_in replyAddress{};
+
+    struct SendSlot
+    {
+        std::vector<char> data;
+        iovec payload{};
+        msghdr header{};
+        bool busy = false;
+    };
+
+    SendSlot sendSlots[numSendSlots];
+};
+
+UringUdpReceiver::UringUdpReceiver() = default;
+
+UringUdpReceiver::~UringUdpReceiver()
+{
+    close();
+}
+
+bool UringUdpReceiver::open(int socket, const std::string& replyHost, int replyPort)
+{
+    close();
+
+    auto newRing = std::make_unique<Ring>();
+
+    if (!newRing->setReplyAddress(replyHost, replyPort))
+    {
+        error = "invalid reply address " + replyHost;
+        return false;
+    }
+
+    if (!newRing->setUp(socket, error))
+        return false;
+
+    ring = std::move(newRing);
+    error.clear();
+    return true;
+}
+
+void UringUdpReceiver::close()
+{
+    ring.reset();
+}
+
+bool UringUdpReceiver::run(const std::function<bool()>& shouldExit, const PacketCallback& callback)
+{
+    if (ring == nullptr || !ring->armReceive())
+        return false;
+
+    auto& r = *ring;
+
+    while (!shouldExit())
+    {
+        numWaits.fetch_add(1, std::memory_order_relaxed);
+
+        if (!r.submitAndWait(1, 100))
+        {
+            error = describeError("io_uring_enter", errno);
+            return false;
+        }
+
+        unsigned head = *r.completionHead;
+        const unsigned tail = __atomic_load_n(r.completionTail, __ATOMIC_ACQUIRE);
+        bool rearm = false;
+
+        for (; head != tail; ++head)
+        {
+            const auto& completion = r.completions[head & r.completionMask];
+
+            if (completion.user_data != receiveTag)
+            {
+                r.sendSlots[completion.user_data - firstSendTag].busy = false;
+                continue;
+            }
+
+            // A multishot receive ends when it runs out of buffers and is simply re-armed;
+            // any other error (e.g. a kernel without multishot recvmsg) is fatal
+            if ((completion.flags & IORING_CQE_F_MORE) == 0)
+                rearm = true;
+
+            if (completion.res < 0 && completion.res != -ENOBUFS)
+            {
+                error = describeError("recvmsg", -completion.res);
+                return false;
+            }
+
+            if (completion.res < 0 || (completion.flags & IORING_CQE_F_BUFFER) == 0)
+                continue;
+
+            const auto id = (uint16_t) (completion.flags >> IORING_CQE_BUFFER_SHIFT);
+            const char* buffer = r.buffers + (size_t) id * bufferSize;
+            io_uring_recvmsg_out header;
+            std::memcpy(&header, buffer, sizeof(header));
+
+            const char* control = buffer + sizeof(header) + r.receiveHeader.msg_namelen;
+            const char* payload = control + r.receiveHeader.msg_controllen;
+
+            sockaddr_in source{};
+            std::memcpy(&source, buffer + sizeof(header), std::min((size_t) header.namelen, sizeof(source)));
+            const uint32_t sourceAddress = ntohl(source.sin_addr.s_addr);
+            const uint16_t sourcePort = ntohs(source.sin_port);
+
+            if ((header.flags & MSG_TRUNC) != 0)
+            {
+                numTruncated.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                const size_t segmentSize = OscUdpOffload::getSegmentSize(control, header.controllen, header.payloadlen);
+
+                OscUdpOffload::forEachSegment(payload, header.payloadlen, segmentSize, [&](const char* data, size_t size) {
+                    numPackets.fetch_add(1, std::memory_order_relaxed);
+                    callback(data, size, sourceAddress, sourcePort, r);
+                });
+            }
+
+            r.recycle(id);
+        }
+
+        __atomic_store_n(r.completionHead, head, __ATOMIC_RELEASE);
+        r.publishBuffers();
+
+        if (rearm && !r.armReceive())
+            return false;
+    }
+
+    return true;
+}
+
+#else
+
+struct UringUdpReceiver::Ring {};
+
+UringUdpReceiver::UringUdpReceiver() = default;
+UringUdpReceiver::~UringUdpReceiver() = default;
+
+bool UringUdpReceiver::open(int, const std::string&, int)
+{
+    error = "io_uring is not available on this platform";
+    return false;
+}
+
+void UringUdpReceiver::close() {}
+bool UringUdpReceiver::run(const std::function<bool()>&, const PacketCallback&) { return false; }
+
+#endif
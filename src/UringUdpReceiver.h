@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include "TcpServer.h"
+
+// Receives UDP datagrams through io_uring. One multishot recvmsg stays armed on the socket
+// and the kernel takes a buffer for each datagram from a ring of provided buffers, which is
+// refilled from user space without a system call. Replies are submitted as sendmsg
+// operations on the same ring. Waiting for completions takes one io_uring_enter() for
+// however many datagrams arrived in the meantime, and submissions ride along with it, so a
+// busy socket costs no system call per packet.
+//
+// Datagrams the kernel coalesced with UDP_GRO are split up again before the callback.
+//
+// Talks to the kernel directly (no liburing) and needs Linux 6.0 for multishot recvmsg
+// with provided buffer rings; open() fails on older kernels, where io_uring is disabled,
+// and on other platforms, and the caller should then read the socket itself.
+class UringUdpReceiver
+{
+public:
+    // Called on the thread that calls run(); replies may only be sent from inside it. The
+    // source is an IPv4 address and port in host byte order.
+    using PacketCallback = std::function<void(const char* data, size_t size, uint32_t sourceAddress, uint16_t sourcePort, OscReplyChannel& reply)>;
+
+    UringUdpReceiver();
+    ~UringUdpReceiver();
+
+    // Sets up the ring for socket. Must be called on the thread that will call run(). Replies
+    // are sent to replyHost:replyPort.
+    bool open(int socket, const std::string& replyHost, int replyPort);
+    void close();
+    bool isOpen() const noexcept { return ring != nullptr; }
+
+    // Dispatches datagrams until shouldExit() returns true, which is checked at least every
+    // 100 ms. Returns false if the ring failed and the caller should fall back.
+    bool run(const std::function<bool()>& shouldExit, const PacketCallback& callback);
+
+    // Why the last open() failed, e.g. "io_uring_setup: Operation not permitted"
+    const std::string& getError() const noexcept { return error; }
+
+    juce::uint64 getNumPackets() const noexcept { return numPackets.load(std::memory_order_relaxed); }
+    juce::uint64 getNumWaits() const noexcept { return numWaits.load(std::memory_order_relaxed); }
+    juce::uint64 getNumTruncated() const noexcept { return numTruncated.load(std::memory_order_relaxed); }
+
+    // Big enough for a full 64 KiB GRO buffer plus the headers io_uring puts in front of it
+    static constexpr size_t bufferSize = 68 * 1024;
+    static constexpr unsigned numBuffers = 128;
+    static constexpr unsigned numSendSlots = 64;
+
+private:
+    struct Ring;
+
+    std::unique_ptr<Ring> ring;
+    std::string error;
+
+    std::atomic<juce::uint64> numPackets{0};
+    std::atomic<juce::uint64> numWaits{0};     // io_uring_enter() calls while running
+    std::atomic<juce::uint64> numTruncated{0}; // datagrams larger than a buffer
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UringUdpReceiver)
+};
@@ -0,0 +1,505 @@
+#include "XdpUdpReceiver.h"
+#include <cstring>
+
+#if JUCE_LINUX && __has_include(<linux/if_xdp.h>) && __has_include(<linux/bpf.h>)
+ #include <linux/bpf.h>
+ #include <linux/if_xdp.h>
+ #ifdef XDP_USE_NEED_WAKEUP
+  #define OSC_AF_XDP 1
+ #endif
+#endif
+
+#if OSC_AF_XDP
+ #include <arpa/inet.h>
+ #include <cerrno>
+ #include <linux/if_link.h>
+ #include <net/if.h>
+ #include <poll.h>
+ #include <sys/mman.h>
+ #include <sys/socket.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #include <vector>
+
+ #ifndef AF_XDP
+  #define AF_XDP 44
+ #endif
+
+ #ifndef SOL_XDP
+  #define SOL_XDP 283
+ #endif
+#endif
+
+namespace
+{
+    constexpr size_t ethernetHeaderSize = 14;
+    constexpr size_t udpHeaderSize = 8;
+
+    uint16_t readBigEndian16(const uint8_t* data) noexcept
+    {
+        return (uint16_t) ((data[0] << 8) | data[1]);
+    }
+}
+
+bool XdpUdpReceiver::parseFrame(const uint8_t* frame, size_t size, int port, const char*& payload, size_t& payloadSize,
+                                uint32_t& sourceAddress, uint16_t& sourcePort) noexcept
+{
+    if (size < ethernetHeaderSize + 20 + udpHeaderSize || readBigEndian16(frame + 12) != 0x0800)
+        return false;
+
+    const uint8_t* ip = frame + ethernetHeaderSize;
+    const size_t ipHeaderSize = (size_t) (ip[0] & 0x0f) * 4;
+    const size_t ipLength = readBigEndian16(ip + 2);
+
+    if ((ip[0] >> 4) != 4 || ipHeaderSize < 20 || ip[9] != 17 // UDP
+        || (readBigEndian16(ip + 6) & 0x3fff) != 0             // fragment
+        || ipLength < ipHeaderSize + udpHeaderSize || ethernetHeaderSize + ipLength > size)
+        return false;
+
+    const uint8_t* udp = ip + ipHeaderSize;
+    const size_t udpLength = readBigEndian16(udp + 4);
+
+    if (readBigEndian16(udp + 2) != (uint16_t) port || udpLength < udpHeaderSize || udpLength > ipLength - ipHeaderSize)
+        return false;
+
+    payload = reinterpret_cast<const char*>(udp + udpHeaderSize);
+    payloadSize = udpLength - udpHeaderSize;
+    sourceAddress = ((uint32_t) readBigEndian16(ip + 12) << 16) | readBigEndian16(ip + 14);
+    sourcePort = readBigEndian16(udp);
+    return true;
+}
+
+#if OSC_AF_XDP
+
+namespace
+{
+    std::string describeError(const char* call, int errorNumber)
+    {
+        return std::string(call) + ": " + std::strerror(errorNumber);
+    }
+
+    long bpf(int command, bpf_attr& attributes)
+    {
+        return syscall(__NR_bpf, command, &attributes, sizeof(attributes));
+    }
+
+    // A minimal assembler for the XDP program below
+    bpf_insn instruction(uint8_t code, uint8_t destination, uint8_t source, int16_t offset, int32_t immediate)
+    {
+        bpf_insn result{};
+        result.code = code;
+        result.dst_reg = destination & 0x0f;
+        result.src_reg = source & 0x0f;
+        result.off = offset;
+        result.imm = immediate;
+        return result;
+    }
+
+    // The value a 16-bit load from the packet gives for these bytes in network order
+    int32_t networkOrder16(uint16_t value)
+    {
+        const uint8_t bytes[2] { (uint8_t) (value >> 8), (uint8_t) value };
+        uint16_t loaded;
+        std::memcpy(&loaded, bytes, sizeof(loaded));
+        return loaded;
+    }
+
+    // Redirects unfragmented IPv4/UDP frames for port to the AF_XDP socket registered for the
+    // receive queue in xskMap, and passes everything else (or all frames for queues without a
+    // socket) to the kernel. Frames longer than maxLength are passed too, as they would not
+    // fit into a UMEM frame.
+    std::vector<bpf_insn> assembleProgram(int xskMap, int port, int maxLength)
+    {
+        enum Register : uint8_t { r0, r1, r2, r3, r4, r5, r6 };
+
+        std::vector<bpf_insn> program;
+        std::vector<size_t> jumpsToPass;
+
+        const auto load = [&](uint8_t size, uint8_t destination, uint8_t source, int16_t offset) {
+            program.push_back(instruction(BPF_LDX | BPF_MEM | size, destination, source, offset, 0));
+        };
+        const auto passIf = [&](uint8_t code, uint8_t destination, uint8_t source, int32_t immediate) {
+            jumpsToPass.push_back(program.size());
+            program.push_back(instruction(BPF_JMP | code, destination, source, 0, immediate));
+        };
+        const auto alu = [&](uint8_t code, uint8_t destination, int32_t immediate) {
+            program.push_back(instruction(BPF_ALU64 | code | BPF_K, destination, 0, 0, immediate));
+        };
+        const auto copy = [&](uint8_t destination, uint8_t source) {
+            program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, destination, source, 0, 0));
+        };
+
+        copy(r6, r1);
+        load(BPF_W, r2, r1, offsetof(xdp_md, data));
+        load(BPF_W, r3, r1, offsetof(xdp_md, data_end));
+
+        copy(r4, r2);
+        alu(BPF_ADD, r4, maxLength);
+        passIf(BPF_JLT | BPF_X, r4, r3, 0);                            // too long
+
+        copy(r4, r2);
+        alu(BPF_ADD, r4, (int32_t) (ethernetHeaderSize + 20 + udpHeaderSize));
+        passIf(BPF_JGT | BPF_X, r4, r3, 0);                            // too short
+
+        load(BPF_H, r5, r2, 12);
+        passIf(BPF_JNE | BPF_K, r5, 0, networkOrder16(0x0800));        // not IPv4
+        load(BPF_B, r5, r2, 23);
+        passIf(BPF_JNE | BPF_K, r5, 0, 17);                            // not UDP
+        load(BPF_H, r5, r2, 20);
+        alu(BPF_AND, r5, networkOrder16(0x3fff));
+        passIf(BPF_JNE | BPF_K, r5, 0, 0);                             // fragment
+
+        load(BPF_B, r5, r2, 14);
+        alu(BPF_AND, r5, 0x0f);
+        alu(BPF_LSH, r5, 2);
+        passIf(BPF_JLT | BPF_K, r5, 0, 20);                            // bad header length
+        program.push_back(instruction(BPF_ALU64 | BPF_ADD | BPF_X, r2, r5, 0, 0));
+
+        copy(r4, r2);
+        alu(BPF_ADD, r4, (int32_t) (ethernetHeaderSize + udpHeaderSize));
+        passIf(BPF_JGT | BPF_X, r4, r3, 0);
+        load(BPF_H, r5, r2, ethernetHeaderSize + 2);
+        passIf(BPF_JNE | BPF_K, r5, 0, networkOrder16((uint16_t) port)); // other port
+
+        // return bpf_redirect_map(&xskMap, ctx->rx_queue_index, XDP_PASS)
+        load(BPF_W, r2, r6, offsetof(xdp_md, rx_queue_index));
+        program.push_back(instruction(BPF_LD | BPF_DW | BPF_IMM, r1, BPF_PSEUDO_MAP_FD, 0, xskMap));
+        program.push_back(instruction(0, 0, 0, 0, 0));
+        program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, r3, 0, 0, XDP_PASS));
+        program.push_back(instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map));
+        program.push_back(instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+        const size_t pass = program.size();
+        program.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, r0, 0, 0, XDP_PASS));
+        program.push_back(instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+        for (const auto jump : jumpsToPass)
+            program[jump].off = (int16_t) (pass - jump - 1);
+
+        return program;
+    }
+
+    // A single-producer, single-consumer ring shared with the kernel
+    struct Ring
+    {
+        bool map(int socket, const xdp_ring_offset& offsets, unsigned numEntries, size_t entrySize, off_t pageOffset)
+        {
+            length = offsets.desc + numEntries * entrySize;
+            memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, socket, pageOffset);
+
+            if (memory == MAP_FAILED)
+                return false;
+
+            auto* bytes = static_cast<char*>(memory);
+            producer = reinterpret_cast<uint32_t*>(bytes + offsets.producer);
+            consumer = reinterpret_cast<uint32_t*>(bytes + offsets.consumer);
+            entries = bytes + offsets.desc;
+            mask = numEntries - 1;
+            return true;
+        }
+
+        ~Ring()
+        {
+            if (memory != MAP_FAILED)
+                munmap(memory, length);
+        }
+
+        void* memory = MAP_FAILED;
+        size_t length = 0;
+        uint32_t* producer = nullptr;
+        uint32_t* consumer = nullptr;
+        char* entries = nullptr;
+        uint32_t mask = 0;
+    };
+}
+
+struct XdpUdpReceiver::Socket
+{
+    ~Socket()
+    {
+        // Closing the link detaches the program from the interface
+        for (const int fd : { link, program, map, socket })
+            if (fd >= 0)
+                ::close(fd);
+
+        if (umem != MAP_FAILED)
+            munmap(umem, (size_t) numFrames * frameSize);
+    }
+
+    bool setUp(const std::string& interfaceName, int queueToUse, int portToUse, Mode mode, std::string& error)
+    {
+        port = portToUse;
+        const unsigned interfaceIndex = if_nametoindex(interfaceName.c_str());
+
+        if (interfaceIndex == 0)
+        {
+            error = "unknown interface " + interfaceName;
+            return false;
+        }
+
+        return setUpSocket(interfaceIndex, queueToUse, mode, error)
+            && setUpProgram(interfaceIndex, queueToUse, mode, error);
+    }
+
+    bool setUpSocket(unsigned interfaceIndex, int queue, Mode mode, std::string& error)
+    {
+        socket = ::socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+
+        if (socket < 0)
+        {
+            error = describeError("socket(AF_XDP)", errno);
+            return false;
+        }
+
+        umem = mmap(nullptr, (size_t) numFrames * frameSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+
+        if (umem == MAP_FAILED)
+        {
+            error = describeError("mmap", errno);
+            return false;
+        }
+
+        xdp_umem_reg registration{};
+        registration.addr = reinterpret_cast<uint64_t>(umem);
+        registration.len = (uint64_t) numFrames * frameSize;
+        registration.chunk_size = frameSize;
+
+        // Every frame is either waiting in the fill ring or being read, so both rings hold all
+        // of them; nothing is sent, but the completion ring is still required
+        const int ringSize = (int) numFrames, completionSize = 64;
+
+        if (setsockopt(socket, SOL_XDP, XDP_UMEM_REG, &registration, sizeof(registration)) != 0
+            || setsockopt(socket, SOL_XDP, XDP_UMEM_FILL_RING, &ringSize, sizeof(ringSize)) != 0
+            || setsockopt(socket, SOL_XDP, XDP_UMEM_COMPLETION_RING, &completionSize, sizeof(completionSize)) != 0
+            || setsockopt(socket, SOL_XDP, XDP_RX_RING, &ringSize, sizeof(ringSize)) != 0)
+        {
+            error = describeError("setsockopt(SOL_XDP)", errno);
+            return false;
+        }
+
+        xdp_mmap_offsets offsets{};
+        socklen_t offsetsSize = sizeof(offsets);
+
+        if (getsockopt(socket, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &offsetsSize) != 0
+            || !receiveRing.map(socket, offsets.rx, numFrames, sizeof(xdp_desc), XDP_PGOFF_RX_RING)
+            || !fillRing.map(socket, offsets.fr, numFrames, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING)
+            || !completionRing.map(socket, offsets.cr, completionSize, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING))
+        {
+            error = describeError("mmap(AF_XDP rings)", errno);
+            return false;
+        }
+
+        for (unsigned frame = 0; frame < numFrames; ++frame)
+            fillEntry(fillTail++) = (uint64_t) frame * frameSize;
+
+        __atomic_store_n(fillRing.producer, fillTail, __ATOMIC_RELEASE);
+        receiveHead = *receiveRing.consumer;
+
+        sockaddr_xdp address{};
+        address.sxdp_family = AF_XDP;
+        address.sxdp_ifindex = interfaceIndex;
+        address.sxdp_queue_id = (uint32_t) queue;
+        address.sxdp_flags = XDP_USE_NEED_WAKEUP | (mode == Mode::generic ? XDP_COPY : 0);
+
+        if (bind(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            error = describeError("bind(AF_XDP)", errno);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool setUpProgram(unsigned interfaceIndex, int queue, Mode mode, std::string& error)
+    {
+        bpf_attr attributes{};
+        attributes.map_type = BPF_MAP_TYPE_XSKMAP;
+        attributes.key_size = sizeof(uint32_t);
+        attributes.value_size = sizeof(uint32_t);
+        attributes.max_entries = (uint32_t) queue + 1;
+        map = (int) bpf(BPF_MAP_CREATE, attributes);
+
+        if (map < 0)
+        {
+            error = describeError("bpf(MAP_CREATE)", errno);
+            return false;
+        }
+
+        const uint32_t key = (uint32_t) queue, value = (uint32_t) socket;
+        attributes = {};
+        attributes.map_fd = (uint32_t) map;
+        attributes.key = reinterpret_cast<uint64_t>(&key);
+        attributes.value = reinterpret_cast<uint64_t>(&value);
+
+        if (bpf(BPF_MAP_UPDATE_ELEM, attributes) != 0)
+        {
+            error = describeError("bpf(MAP_UPDATE_ELEM)", errno);
+            return false;
+        }
+
+        const auto instructions = assembleProgram(map, port, (int) (frameSize - XDP_PACKET_HEADROOM));
+        static const char license[] = "Dual BSD/GPL";
+
+        attributes = {};
+        attributes.prog_type = BPF_PROG_TYPE_XDP;
+        attributes.expected_attach_type = BPF_XDP;
+        attributes.insns = reinterpret_cast<uint64_t>(instructions.data());
+        attributes.insn_cnt = (uint32_t) instructions.size();
+        attributes.license = reinterpret_cast<uint64_t>(license);
+        std::memcpy(attributes.prog_name, "osc_udp_port", sizeof("osc_udp_port"));
+        program = (int) bpf(BPF_PROG_LOAD, attributes);
+
+        if (program < 0)
+        {
+            error = describeError("bpf(PROG_LOAD)", errno);
+            return false;
+        }
+
+        attributes = {};
+        attributes.link_create.prog_fd = (uint32_t) program;
+        attributes.link_create.target_ifindex = interfaceIndex;
+        attributes.link_create.attach_type = BPF_XDP;
+        attributes.link_create.flags = mode == Mode::generic ? XDP_FLAGS_SKB_MODE : XDP_FLAGS_DRV_MODE;
+        link = (int) bpf(BPF_LINK_CREATE, attributes);
+
+        if (link < 0)
+        {
+            error = describeError("bpf(LINK_CREATE)", errno);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint64_t& fillEntry(uint32_t index) noexcept
+    {
+        return reinterpret_cast<uint64_t*>(fillRing.entries)[index & fillRing.mask];
+    }
+
+    const xdp_desc& receiveEntry(uint32_t index) const noexcept
+    {
+        return reinterpret_cast<const xdp_desc*>(receiveRing.entries)[index & receiveRing.mask];
+    }
+
+    int socket = -1;
+    int map = -1;
+    int program = -1;
+    int link = -1;
+    int port = 0;
+
+    void* umem = MAP_FAILED;
+    Ring receiveRing, fillRing, completionRing;
+    uint32_t receiveHead = 0, fillTail = 0;
+};
+
+XdpUdpReceiver::XdpUdpReceiver() = default;
+
+XdpUdpReceiver::~XdpUdpReceiver()
+{
+    close();
+}
+
+bool XdpUdpReceiver::open(const std::string& interfaceName, int queue, int port, Mode mode)
+{
+    close();
+
+    auto newSocket = std::make_unique<Socket>();
+
+    if (!newSocket->setUp(interfaceName, queue, port, mode, error))
+        return false;
+
+    socket = std::move(newSocket);
+    error.clear();
+    return true;
+}
+
+void XdpUdpReceiver::close()
+{
+    socket.reset();
+}
+
+juce::uint64 XdpUdpReceiver::getNumDropped() const
+{
+    xdp_statistics statistics{};
+    socklen_t size = sizeof(statistics);
+
+    if (socket == nullptr || getsockopt(socket->socket, SOL_XDP, XDP_STATISTICS, &statistics, &size) != 0)
+        return 0;
+
+    return statistics.rx_dropped + statistics.rx_ring_full + statistics.rx_fill_ring_empty_descs;
+}
+
+bool XdpUdpReceiver::run(const std::function<bool()>& shouldExit, const PacketCallback& callback)
+{
+    if (socket == nullptr)
+        return false;
+
+    auto& s = *socket;
+    auto* umem = static_cast<const uint8_t*>(s.umem);
+
+    while (!shouldExit())
+    {
+        const uint32_t received = __atomic_load_n(s.receiveRing.producer, __ATOMIC_ACQUIRE) - s.receiveHead;
+
+        if (received == 0)
+        {
+            // Also kicks the driver if it asked for a wake-up to refill from the fill ring
+            pollfd readable { s.socket, POLLIN, 0 };
+            numWaits.fetch_add(1, std::memory_order_relaxed);
+
+            if (poll(&readable, 1, 100) < 0 && errno != EINTR)
+            {
+                error = describeError("poll", errno);
+                return false;
+            }
+
+            continue;
+        }
+
+        for (uint32_t i = 0; i < received; ++i)
+        {
+            const auto& descriptor = s.receiveEntry(s.receiveHead++);
+            const char* payload = nullptr;
+            size_t payloadSize = 0;
+            uint32_t sourceAddress = 0;
+            uint16_t sourcePort = 0;
+
+            if (parseFrame(umem + descriptor.addr, descriptor.len, s.port, payload, payloadSize, sourceAddress, sourcePort))
+            {
+                numPackets.fetch_add(1, std::memory_order_relaxed);
+                callback(payload, payloadSize, sourceAddress, sourcePort);
+            }
+            else
+            {
+                numMalformed.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // Hand the frame straight back to the kernel
+            s.fillEntry(s.fillTail++) = descriptor.addr & ~(uint64_t) (frameSize - 1);
+        }
+
+        __atomic_store_n(s.receiveRing.consumer, s.receiveHead, __ATOMIC_RELEASE);
+        __atomic_store_n(s.fillRing.producer, s.fillTail, __ATOMIC_RELEASE);
+    }
+
+    return true;
+}
+
+#else
+
+struct XdpUdpReceiver::Socket {};
+
+XdpUdpReceiver::XdpUdpReceiver() = default;
+XdpUdpReceiver::~XdpUdpReceiver() = default;
+
+bool XdpUdpReceiver::open(const std::string&, int, int, Mode)
+{
+    error = "AF_XDP is not available on this platform";
+    return false;
+}
+
+void XdpUdpReceiver::close() {}
+juce::uint64 XdpUdpReceiver::getNumDropped() const { return 0; }
+bool XdpUdpReceiver::run(const std::function<bool()>&, const PacketCallback&) { return false; }
+
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+// Receives UDP datagrams for one port through an AF_XDP socket, bypassing the kernel's UDP
+// stack. A small XDP program attached to the interface redirects IPv4/UDP frames for the port
+// arriving on one receive queue into a ring of frames shared with user space (the UMEM),
+// where the Ethernet, IPv4 and UDP headers are parsed directly. Everything else, including
+// fragments and frames too large for a UMEM frame, is passed on to the kernel as usual, so a
+// socket bound to the port still receives those.
+//
+// Generic (SKB) mode works on any interface, including lo and veth pairs, and is what to use
+// for development; native mode needs driver support and gives the real speed-up. Needs
+// Linux 5.9 and CAP_NET_ADMIN plus CAP_BPF (or root); open() reports why it failed otherwise.
+class XdpUdpReceiver
+{
+public:
+    // The source is an IPv4 address and port in host byte order
+    using PacketCallback = std::function<void(const char* data, size_t size, uint32_t sourceAddress, uint16_t sourcePort)>;
+
+    enum class Mode
+    {
+        generic, // XDP in the network stack after the driver, copies into the UMEM
+        native   // XDP in the driver, zero-copy where the driver supports it
+    };
+
+    XdpUdpReceiver();
+    ~XdpUdpReceiver();
+
+    // Attaches to queue of interfaceName and redirects datagrams for port. Only one program
+    // can be attached to an interface, so this fails while another one is.
+    bool open(const std::string& interfaceName, int queue, int port, Mode mode);
+    void close();
+    bool isOpen() const noexcept { return socket != nullptr; }
+
+    // Dispatches the payloads of received datagrams until shouldExit() returns true, which is
+    // checked at least every 100 ms. Returns false if the socket failed.
+    bool run(const std::function<bool()>& shouldExit, const PacketCallback& callback);
+
+    // Why the last open() or run() failed, e.g. "bpf(PROG_LOAD): Operation not permitted"
+    const std::string& getError() const noexcept { return error; }
+
+    juce::uint64 getNumPackets() const noexcept { return numPackets.load(std::memory_order_relaxed); }
+    juce::uint64 getNumMalformed() const noexcept { return numMalformed.load(std::memory_order_relaxed); }
+    juce::uint64 getNumWaits() const noexcept { return numWaits.load(std::memory_order_relaxed); }
+
+    // Frames the kernel dropped because the receive ring was full or no UMEM frame was free
+    juce::uint64 getNumDropped() const;
+
+    // Finds the UDP payload and source in an Ethernet frame carrying an unfragmented IPv4
+    // datagram to port. Checksums are not verified: generic mode sees frames before they are
+    // computed.
+    static bool parseFrame(const uint8_t* frame, size_t size, int port, const char*& payload, size_t& payloadSize,
+                           uint32_t& sourceAddress, uint16_t& sourcePort) noexcept;
+
+    static constexpr unsigned numFrames = 2048;
+    static constexpr unsigned frameSize = 4096;
+
+private:
+    struct Socket;
+
+    std::unique_ptr<Socket> socket;
+    std::string error;
+
+    std::atomic<juce::uint64> numPackets{0};
+    std::atomic<juce::uint64> numMalformed{0}; // redirected frames that were not UDP for the port
+    std::atomic<juce::uint64> numWaits{0};     // poll() calls while the receive ring was empty
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(XdpUdpReceiver)
+};
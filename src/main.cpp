@@ -1,8 +1,14 @@
 #include <juce_osc/juce_osc.h>
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <signal.h>
+#include <string>
+#include <vector>
+#include "HostBenchmarks.h"
+#include "OSCHost.h"
 
 // Global flag for graceful shutdown
 static volatile bool running = true;
@@ -13,95 +19,204 @@ void signal_handler(int signum) {
     running = false;
 }
 
-// OSC Receiver class that handles incoming messages
-class OSCHost : public juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+static void printUsage()
 {
-public:
-    OSCHost() : sender()
-    {
-    }
+    std::cout << "Usage: osc_host [--no-tcp] [--tcp-port <port>] [--tcp-framing auto|length|slip]" << std::endl;
+    std::cout << "                [--unix <path>] [--unix-stream <path>] [--shm <name>]" << std::endl;
+    std::cout << "                [--join <group>]... [--multicast-iface <address|name>]" << std::endl;
+    std::cout << "                [--udp-backend auto|uring|poll]" << std::endl;
+    std::cout << "                [--xdp <interface> [--xdp-queue <n>] [--xdp-native]]" << std::endl;
+    std::cout << "                [--priority <name>:<prefix>[,<prefix>...]:<weight>[:<capacity>[:latest]]]..." << std::endl;
+    std::cout << "                [--coalesce <prefix>[,<prefix>...]]" << std::endl;
+    std::cout << "                [--rate-limit <packets/s>[:<burst>[:<expiry seconds>]]] [--max-packet <bytes>]" << std::endl;
+    std::cout << "       osc_host --bench-udp|--bench-priority|--bench-coalesce|--bench-rate-limit|--bench-validate" << std::endl;
+    std::cout << "                [--duration <seconds>]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    const int port = 7770;
+    int tcpPort = port;
+    bool useTcp = true;
+    bool benchUdp = false;
+    bool benchPriority = false;
+    bool benchCoalesce = false;
+    bool benchRateLimit = false;
+    bool benchValidate = false;
+    size_t maxPacketSize = TcpServer::maxPacketSize;
+    double benchSeconds = 1.0;
+    auto udpBackend = OSCHost::UdpBackend::automatic;
+    auto framing = TcpServer::Framing::detect;
+    std::string localDatagramPath, localStreamPath, ringName, multicastInterface, xdpInterface;
+    int xdpQueue = 0;
+    auto xdpMode = XdpUdpReceiver::Mode::generic;
+    std::vector<std::string> multicastGroups;
+    std::vector<PriorityDispatcher::PriorityClass> priorityClasses;
+    SourceRateLimiter::Settings rateLimit;
 
-    bool start(int port)
+    for (int i = 1; i < argc; ++i)
     {
-        if (!receiver.connect(port))
+        if (std::strcmp(argv[i], "--no-tcp") == 0)
         {
-            std::cerr << "Failed to connect to port " << port << std::endl;
-            return false;
+            useTcp = false;
         }
+        else if (std::strcmp(argv[i], "--tcp-port") == 0 && i + 1 < argc)
+        {
+            tcpPort = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--unix") == 0 && i + 1 < argc)
+        {
+            localDatagramPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--unix-stream") == 0 && i + 1 < argc)
+        {
+            localStreamPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc)
+        {
+            ringName = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--join") == 0 && i + 1 < argc)
+        {
+            multicastGroups.push_back(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--multicast-iface") == 0 && i + 1 < argc)
+        {
+            multicastInterface = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--udp-backend") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
 
-        receiver.addListener(this);
-        std::cout << "Server started successfully!" << std::endl;
-        return true;
-    }
-
-    void stop()
-    {
-        receiver.removeListener(this);
-        receiver.disconnect();
-    }
-
-    void oscMessageReceived(const juce::OSCMessage& message) override
-    {
-        juce::String address = message.getAddressPattern().toString();
-        
-        if (address == "/ping")
+            if (std::strcmp(name, "uring") == 0)
+                udpBackend = OSCHost::UdpBackend::ioUring;
+            else if (std::strcmp(name, "poll") == 0)
+                udpBackend = OSCHost::UdpBackend::poll;
+            else if (std::strcmp(name, "auto") != 0)
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--xdp") == 0 && i + 1 < argc)
         {
-            std::cout << "Received ping" << std::endl;
-            
-            // Note: juce_osc's OSCReceiver doesn't provide sender information like liblo did.
-            // For a production application, clients should include their return address in the message.
-            // For this demo, we send pong responses to a default loopback address.
-            sendPong("127.0.0.1", 7771);
+            xdpInterface = argv[++i];
         }
-        else
+        else if (std::strcmp(argv[i], "--xdp-queue") == 0 && i + 1 < argc)
         {
-            // Generic handler for unmatched messages
-            std::cout << "Received unhandled message:" << std::endl;
-            std::cout << "  Path: " << address << std::endl;
-            std::cout << "  Arguments: " << message.size() << std::endl;
+            xdpQueue = std::atoi(argv[++i]);
         }
-    }
+        else if (std::strcmp(argv[i], "--xdp-native") == 0)
+        {
+            xdpMode = XdpUdpReceiver::Mode::native;
+        }
+        else if (std::strcmp(argv[i], "--priority") == 0 && i + 1 < argc)
+        {
+            PriorityDispatcher::PriorityClass priorityClass;
 
-    void oscBundleReceived(const juce::OSCBundle& bundle) override
-    {
-        std::cout << "Received OSC bundle with " << bundle.size() << " elements" << std::endl;
-    }
+            if (!PriorityDispatcher::PriorityClass::parse(argv[++i], priorityClass))
+            {
+                printUsage();
+                return 1;
+            }
 
-private:
-    void sendPong(const juce::String& host, int port)
-    {
-        if (!sender.connect(host, port))
-        {
-            std::cerr << "Error: Could not create reply address" << std::endl;
-            return;
+            priorityClasses.push_back(std::move(priorityClass));
         }
+        else if (std::strcmp(argv[i], "--coalesce") == 0 && i + 1 < argc)
+        {
+            // Shorthand for a latest-only class of continuous values
+            PriorityDispatcher::PriorityClass priorityClass;
+
+            if (!PriorityDispatcher::PriorityClass::parse(std::string("continuous:") + argv[++i] + ":1:4096:latest", priorityClass))
+            {
+                printUsage();
+                return 1;
+            }
 
-        juce::OSCMessage pongMessage("/pong");
-        pongMessage.addString("pong");
-        
-        if (!sender.send(pongMessage))
+            priorityClasses.push_back(std::move(priorityClass));
+        }
+        else if (std::strcmp(argv[i], "--rate-limit") == 0 && i + 1 < argc)
         {
-            std::cerr << "Error: Failed to send pong response" << std::endl;
+            if (!SourceRateLimiter::Settings::parse(argv[++i], rateLimit))
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--max-packet") == 0 && i + 1 < argc)
+        {
+            maxPacketSize = (size_t) std::atoll(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--bench-udp") == 0)
+        {
+            benchUdp = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-priority") == 0)
+        {
+            benchPriority = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-coalesce") == 0)
+        {
+            benchCoalesce = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-rate-limit") == 0)
+        {
+            benchRateLimit = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-validate") == 0)
+        {
+            benchValidate = true;
+        }
+        else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+        {
+            benchSeconds = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--tcp-framing") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+
+            if (std::strcmp(name, "length") == 0)
+                framing = TcpServer::Framing::lengthPrefix;
+            else if (std::strcmp(name, "slip") == 0)
+                framing = TcpServer::Framing::slip;
+            else if (std::strcmp(name, "auto") != 0)
+            {
+                printUsage();
+                return 1;
+            }
         }
         else
         {
-            std::cout << "Sent pong response to " << host << ":" << port << std::endl;
+            printUsage();
+            return 1;
         }
-        
-        sender.disconnect();
     }
 
-    juce::OSCReceiver receiver;
-    juce::OSCSender sender;
-};
+    if (benchUdp || benchPriority || benchCoalesce || benchRateLimit || benchValidate)
+    {
+        bool passed = true;
 
-int main()
-{
-    const int port = 7770;
+        if (benchUdp)
+            HostBenchmarks::runUdpBackends(benchSeconds > 0.0 ? benchSeconds : 1.0);
+
+        if (benchPriority)
+            HostBenchmarks::runPriorityClasses(benchSeconds > 0.0 ? benchSeconds : 1.0);
+
+        if (benchCoalesce)
+            HostBenchmarks::runCoalescing(benchSeconds > 0.0 ? benchSeconds : 1.0);
+
+        if (benchRateLimit)
+            HostBenchmarks::runRateLimiting();
+
+        if (benchValidate)
+            passed = HostBenchmarks::runValidation() && passed;
+
+        return passed ? 0 : 1;
+    }
     
     // Initialize JUCE message manager (required for JUCE initialization)
-    // Note: We use RealtimeCallback for OSC, so callbacks are invoked directly
-    // on the network thread without needing a running message loop.
+    // Note: OSCHost dispatches directly on its receive thread, so no
+    // message loop needs to run.
     juce::MessageManager::getInstance();
     
     std::cout << "OSC Demo Host - Simple OSC Server" << std::endl;
@@ -111,25 +226,65 @@ int main()
     std::cout << "  /ping - Responds with /pong" << std::endl;
     std::cout << std::endl;
     std::cout << "Test with: oscsend localhost " << port << " /ping" << std::endl;
+
+    if (useTcp)
+        std::cout << "      or: oscsend osc.tcp://localhost:" << tcpPort << " /ping" << std::endl;
+
     std::cout << "Press Ctrl+C to quit" << std::endl;
     std::cout << std::endl;
     
     // Create and start OSC host
     OSCHost host;
+    host.setUdpBackend(udpBackend);
+    host.setMaxPacketSize(maxPacketSize);
+
+    if (!priorityClasses.empty())
+        host.startPriorityClasses(std::move(priorityClasses));
+
+    if (rateLimit.packetsPerSecond > 0.0)
+        host.setSourceRateLimit(rateLimit);
     
-    if (!host.start(port))
+    if (!host.start(port, !multicastGroups.empty()))
     {
         std::cerr << "Failed to create OSC server on port " << port << std::endl;
         return 1;
     }
+
+    for (const auto& group : multicastGroups)
+        host.joinMulticast(group, multicastInterface);
+
+    // The UDP socket keeps receiving whatever AF_XDP does not take
+    if (!xdpInterface.empty())
+        host.startXdp(xdpInterface, xdpQueue, xdpMode);
+
+    // UDP keeps working if TCP cannot be started
+    if (useTcp && !host.startTcp(tcpPort, framing))
+        std::cerr << "Failed to accept OSC over TCP on port " << tcpPort << std::endl;
+
+    if (!localDatagramPath.empty())
+        host.startLocalDatagram(localDatagramPath);
+
+    // Uses the same framing as TCP
+    if (!localStreamPath.empty())
+        host.startLocalStream(localStreamPath, framing);
+
+    if (!ringName.empty())
+        host.startSharedRing(ringName);
     
     // Setup signal handlers for graceful shutdown
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
-    while (running)
+    for (int seconds = 1; running; ++seconds)
     {
         juce::Thread::sleep(1000);
+
+        if (seconds % 10 == 0)
+        {
+            host.reportInvalidPackets();
+            host.reportRateLimitStats();
+            host.reportPriorityStats();
+        }
     }
 
     // Cleanup
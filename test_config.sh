@@ -64,56 +64,57 @@ fi
 # Test 5: Valid command-line configuration
 echo ""
 echo "6. Testing valid command-line configuration..."
-timeout 2 "$APP_PATH" --host 192.168.1.100 --port 8000 > /tmp/test_output.log 2>&1 &
-APP_PID=$!
-sleep 1.5
-
-if ps -p $APP_PID > /dev/null 2>&1; then
-    OUTPUT=$(cat /tmp/test_output.log)
-    if echo "$OUTPUT" | grep -q "Using command-line configuration: 192.168.1.100:8000"; then
-        echo "   ✓ Command-line configuration applied correctly"
-    else
-        echo "   ✗ Command-line configuration test failed"
-        kill $APP_PID 2>/dev/null || true
-        exit 1
-    fi
-    kill $APP_PID 2>/dev/null || true
-    wait $APP_PID 2>/dev/null || true
+OUTPUT=$("$APP_PATH" --headless --duration 0.5 --host 192.168.1.100 --port 8000 2>&1)
+if echo "$OUTPUT" | grep -q "Using command-line configuration: 192.168.1.100:8000"; then
+    echo "   ✓ Command-line configuration applied correctly"
 else
-    echo "   ✗ Application failed to start"
+    echo "   ✗ Command-line configuration test failed"
     exit 1
 fi
 
 # Test 6: Default configuration creates settings file
 echo ""
 echo "7. Testing default configuration persistence..."
-timeout 2 "$APP_PATH" > /tmp/test_default.log 2>&1 &
-APP_PID=$!
-sleep 1.5
+OUTPUT=$("$APP_PATH" --headless --duration 0.5 2>&1)
+if echo "$OUTPUT" | grep -q "Loaded configuration: 127.0.0.1:7770"; then
+    echo "   ✓ Default configuration loaded correctly"
+else
+    echo "   ✗ Default configuration test failed"
+    exit 1
+fi
 
-if ps -p $APP_PID > /dev/null 2>&1; then
-    OUTPUT=$(cat /tmp/test_default.log)
-    if echo "$OUTPUT" | grep -q "Loaded configuration: 127.0.0.1:7770"; then
-        echo "   ✓ Default configuration loaded correctly"
-    else
-        echo "   ✗ Default configuration test failed"
-        kill $APP_PID 2>/dev/null || true
-        exit 1
-    fi
-    kill $APP_PID 2>/dev/null || true
-    wait $APP_PID 2>/dev/null || true
-    
-    # Check if config file was created
-    if [ -f "$CONFIG_FILE" ]; then
-        echo "   ✓ Configuration file created"
-        echo "   Config location: $CONFIG_FILE"
-    else
-        echo "   ⚠ Configuration file not found (may not be persisted yet)"
-    fi
+# Check if config file was created
+if [ -f "$CONFIG_FILE" ]; then
+    echo "   ✓ Configuration file created"
+    echo "   Config location: $CONFIG_FILE"
 else
-    echo "   ✗ Application failed to start"
+    echo "   ⚠ Configuration file not found (may not be persisted yet)"
+fi
+
+# Test 7: Headless engine processes incoming messages
+echo ""
+echo "8. Testing headless message processing..."
+"$APP_PATH" --headless --duration 1.5 > /tmp/test_headless.log 2>&1 &
+APP_PID=$!
+sleep 0.5
+if command -v oscsend > /dev/null 2>&1; then
+    oscsend localhost 7771 /knob f 0.25
+fi
+wait $APP_PID
+OUTPUT=$(cat /tmp/test_headless.log)
+if echo "$OUTPUT" | grep -q "Running headless" && echo "$OUTPUT" | grep -q "Headless:"; then
+    echo "   ✓ Headless mode ran and reported throughput"
+else
+    echo "   ✗ Headless mode test failed"
     exit 1
 fi
+if command -v oscsend > /dev/null 2>&1; then
+    if echo "$OUTPUT" | grep -q "1 msg/s in\|1 changes/s applied"; then
+        echo "   ✓ Incoming message processed"
+    else
+        echo "   ⚠ Incoming message not reported"
+    fi
+fi
 
 echo ""
 echo "=== All Tests Passed! ==="
@@ -124,3 +125,4 @@ echo "  - Input validation prevents invalid configurations"
 echo "  - Help message displays usage information"
 echo "  - Default configuration loads properly"
 echo "  - Configuration persistence is functional"
+echo "  - Headless mode runs the OSC engine without a window"
@@ -20,93 +20,38 @@ fi
 # Test 1: Start with command-line args, verify initial config
 echo ""
 echo "2. Testing application start with command-line arguments..."
-timeout 2 "$APP_PATH" --host 192.168.1.100 --port 8000 > /tmp/test_cmdline.log 2>&1 &
-APP_PID=$!
-sleep 1.5
-
-if ps -p $APP_PID > /dev/null 2>&1; then
-    OUTPUT=$(cat /tmp/test_cmdline.log)
-    if echo "$OUTPUT" | grep -q "Using command-line configuration: 192.168.1.100:8000"; then
-        echo "   ✓ Application started with command-line configuration"
-    else
-        echo "   ✗ Command-line configuration not loaded"
-        kill $APP_PID 2>/dev/null || true
-        exit 1
-    fi
-    kill $APP_PID 2>/dev/null || true
-    wait $APP_PID 2>/dev/null || true
+OUTPUT=$("$APP_PATH" --headless --duration 0.5 --host 192.168.1.100 --port 8000 2>&1)
+if echo "$OUTPUT" | grep -q "Using command-line configuration: 192.168.1.100:8000"; then
+    echo "   ✓ Application started with command-line configuration"
 else
-    echo "   ✗ Application failed to start"
+    echo "   ✗ Command-line configuration not loaded"
     exit 1
 fi
 
-# Test 2: Start with CLI args, then verify we can save through UI
+# Test 2: Start with CLI args, then verify saved config is loaded independently
 echo ""
 echo "3. Testing that configuration can be modified after CLI startup..."
-# This test verifies that the configuration can be saved through the UI
-# The actual UI interaction would require automation, but we can verify
-# the code path is available by checking the config file after simulated use
-
-# Start app with CLI args
-timeout 3 "$APP_PATH" --host 192.168.1.100 --port 8000 > /tmp/test_modify.log 2>&1 &
-APP_PID=$!
-sleep 1.5
-
-if ps -p $APP_PID > /dev/null 2>&1; then
-    # Kill the app
-    kill $APP_PID 2>/dev/null || true
-    wait $APP_PID 2>/dev/null || true
-    
-    # Now start without CLI args to test saved config persistence
-    timeout 2 "$APP_PATH" > /tmp/test_persist.log 2>&1 &
-    APP_PID=$!
-    sleep 1.5
-    
-    if ps -p $APP_PID > /dev/null 2>&1; then
-        OUTPUT=$(cat /tmp/test_persist.log)
-        # Should load default or previously saved config (not the CLI args from before)
-        if echo "$OUTPUT" | grep -q "Loaded configuration:"; then
-            echo "   ✓ Configuration can be loaded independently of CLI args"
-        else
-            echo "   ✗ Configuration loading failed"
-            kill $APP_PID 2>/dev/null || true
-            exit 1
-        fi
-        kill $APP_PID 2>/dev/null || true
-        wait $APP_PID 2>/dev/null || true
-    else
-        echo "   ✗ Application failed to start without CLI args"
-        exit 1
-    fi
+# The actual UI interaction would require automation, but we can verify that
+# a run without CLI args loads the saved configuration, not the previous CLI args
+OUTPUT=$("$APP_PATH" --headless --duration 0.5 2>&1)
+if echo "$OUTPUT" | grep -q "Loaded configuration:"; then
+    echo "   ✓ Configuration can be loaded independently of CLI args"
 else
-    echo "   ✗ Application failed to start with CLI args"
+    echo "   ✗ Configuration loading failed"
     exit 1
 fi
 
 # Test 3: Verify no error message about "Cannot save: Using command-line configuration"
 echo ""
 echo "4. Verifying no UI blocking when CLI args are used..."
-# Start with CLI args and check that old error message doesn't appear
-timeout 2 "$APP_PATH" --host localhost --port 7770 > /tmp/test_no_block.log 2>&1 &
-APP_PID=$!
-sleep 1.5
-
-if ps -p $APP_PID > /dev/null 2>&1; then
-    OUTPUT=$(cat /tmp/test_no_block.log)
-    # The old code would prevent saving with message "Cannot save: Using command-line configuration"
-    # We want to make sure this message doesn't appear in normal operation
-    if echo "$OUTPUT" | grep -q "Cannot save: Using command-line configuration"; then
-        echo "   ✗ Application still blocking configuration changes from CLI mode"
-        kill $APP_PID 2>/dev/null || true
-        exit 1
-    else
-        echo "   ✓ No blocking message detected (UI can accept changes)"
-    fi
-    kill $APP_PID 2>/dev/null || true
-    wait $APP_PID 2>/dev/null || true
-else
-    echo "   ✗ Application failed to start"
+OUTPUT=$("$APP_PATH" --headless --duration 0.5 --host localhost --port 7770 2>&1)
+# The old code would prevent saving with message "Cannot save: Using command-line configuration"
+# We want to make sure this message doesn't appear in normal operation
+if echo "$OUTPUT" | grep -q "Cannot save: Using command-line configuration"; then
+    echo "   ✗ Application still blocking configuration changes from CLI mode"
     exit 1
+else
+    echo "   ✓ No blocking message detected (UI can accept changes)"
 fi
 
 echo ""